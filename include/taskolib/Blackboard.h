@@ -0,0 +1,240 @@
+/**
+ * \file   Blackboard.h
+ * \author Lars Fröhlich
+ * \date   Created on October 18, 2026
+ * \brief  Declaration of the Blackboard class.
+ *
+ * \copyright Copyright 2026 Deutsches Elektronen-Synchrotron (DESY), Hamburg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#ifndef TASKOLIB_BLACKBOARD_H_
+#define TASKOLIB_BLACKBOARD_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <gul14/optional.h>
+
+#include "taskolib/VariableName.h"
+#include "taskolib/VariableTable.h"
+
+namespace task {
+
+/**
+ * A store of variables that is shared between concurrently running sequences (a
+ * "blackboard").
+ *
+ * Several Context objects can attach to the same blackboard via Context::blackboard.
+ * Steps then see it as the Lua table `blackboard`:
+ * \code
+ * blackboard.set('state', 'ready')
+ * local v = blackboard.get('state')                -- nil if the variable is not set
+ * local ver = blackboard.version('state')          -- 0 if it has never been written
+ * local ok = blackboard.compare_exchange('counter', 1, 2)
+ * ver = blackboard.wait('state', ver, 10)          -- wait up to 10 s for a change
+ * \endcode
+ *
+ * Each variable carries a version counter that is incremented by every successful write
+ * (including erase()). All operations are atomic per variable, and a value is never
+ * observed in a partially written state.
+ *
+ * <h3>Concurrency</h3>
+ *
+ * Slots for the variables are addressed directly by the symbol of the interned variable
+ * name (see VariableName::get_symbol()), so no lookup structure has to be protected.
+ * Each slot holds an atomic pointer to an immutable record with the value and the
+ * version, which is replaced as a whole by writers with a compare-and-swap.
+ *
+ * Readers are lock-free: They publish the record pointer they are about to read in a
+ * per-thread hazard pointer, check that the slot still holds it, and copy the record.
+ * A writer does not delete a replaced record right away, but puts it on a list of
+ * retired records. The list is scanned from time to time, and records that are no
+ * longer protected by any hazard pointer are deleted. Only writers lock a mutex, which
+ * guards the list of retired records of this blackboard. Only wait_for_change() uses a
+ * condition variable, and writers touch it only while there are waiting threads.
+ */
+class Blackboard
+{
+public:
+    /// The state of a variable at a certain point in time.
+    struct Entry
+    {
+        /// The value of the variable, or an empty optional if it is not set
+        gul14::optional<VariableValue> value;
+
+        /// Number of writes to the variable so far (0 if it has never been written)
+        std::uint64_t version{ 0 };
+    };
+
+    /// Construct an empty blackboard.
+    Blackboard();
+
+    /// Destruct the blackboard.
+    ~Blackboard();
+
+    Blackboard(const Blackboard&) = delete;
+    Blackboard& operator=(const Blackboard&) = delete;
+
+    /**
+     * Set a variable to the given value if its current value equals the expected one.
+     *
+     * An empty optional as the expected value stands for "not set". The function returns
+     * true if the value was replaced (which increments the version), false otherwise.
+     */
+    bool compare_exchange(const VariableName& name,
+                          const gul14::optional<VariableValue>& expected,
+                          VariableValue desired);
+
+    /**
+     * Remove a variable from the blackboard.
+     *
+     * \returns true if the variable was set before. In that case, its version is
+     *          incremented.
+     */
+    bool erase(const VariableName& name);
+
+    /// Return the current value of a variable, or an empty optional if it is not set.
+    gul14::optional<VariableValue> get(const VariableName& name) const;
+
+    /**
+     * Return the generation of the blackboard, i.e. the total number of writes to all of
+     * its variables so far.
+     */
+    std::uint64_t get_generation() const noexcept
+    {
+        return generation_.load(std::memory_order_acquire);
+    }
+
+    /// Return the current version of a variable (0 if it has never been written).
+    std::uint64_t get_version(const VariableName& name) const;
+
+    /// Return the current value and version of a variable as a consistent pair.
+    Entry load(const VariableName& name) const;
+
+    /**
+     * Set a variable to the given value.
+     * \returns the new version of the variable.
+     */
+    std::uint64_t set(const VariableName& name, VariableValue value);
+
+    /**
+     * Wait until the version of a variable differs from the given one or until the
+     * timeout expires, whichever comes first.
+     *
+     * If a cancel flag is given, the wait also ends as soon as the flag is true. Whoever
+     * sets the flag must call wake_waiters() afterwards.
+     *
+     * \returns the current value and version of the variable. On timeout, the version
+     *          is still the given one.
+     */
+    Entry wait_for_change(const VariableName& name, std::uint64_t version,
+                          std::chrono::nanoseconds timeout,
+                          const std::atomic<bool>* cancel = nullptr) const;
+
+    /**
+     * Wait until the generation of the blackboard differs from the given one (i.e. until
+     * any variable has been written) or until the timeout expires.
+     *
+     * The optional cancel flag works as for wait_for_change().
+     *
+     * \returns the current generation.
+     */
+    std::uint64_t wait_for_any_change(std::uint64_t generation,
+                                      std::chrono::nanoseconds timeout,
+                                      const std::atomic<bool>* cancel = nullptr) const;
+
+    /**
+     * Wake up all threads that wait for a change of the blackboard, so that they check
+     * their cancel flags. Threads whose flag is not set continue to wait.
+     */
+    void wake_waiters() const;
+
+private:
+    static constexpr std::size_t chunk_size = 1024;
+    static constexpr std::size_t max_num_chunks = 4096;
+
+    /// An immutable snapshot of a variable. Records are replaced, never modified.
+    using Record = Entry;
+
+    /// A block of slots for consecutive symbols; null stands for "never written".
+    struct Chunk
+    {
+        std::array<std::atomic<const Record*>, chunk_size> slots{};
+    };
+
+    /// Chunks of slots, allocated on the first write to one of their symbols
+    std::unique_ptr<std::atomic<Chunk*>[]> chunks_;
+
+    /// Total number of writes to all variables
+    std::atomic<std::uint64_t> generation_{ 0 };
+
+    /// Number of threads in wait_for_change() or wait_for_any_change()
+    mutable std::atomic<int> num_waiters_{ 0 };
+
+    mutable std::mutex wait_mutex_;
+    mutable std::condition_variable wait_cv_;
+
+    /// Records that have been replaced but may still be read by other threads
+    std::vector<const Record*> retired_;
+    std::mutex retired_mutex_;
+
+    /// Return the slot for the given name or null if it has not been allocated yet.
+    const std::atomic<const Record*>* find_slot(const VariableName& name) const;
+
+    /// Return the slot for the given name, allocating its chunk if necessary.
+    std::atomic<const Record*>* get_or_create_slot(const VariableName& name);
+
+    /// Wake up all threads in wait_for_change() after a write.
+    void notify_waiters();
+
+    /**
+     * Hand over a record that has been replaced in its slot. It is deleted as soon as no
+     * reader can hold a pointer to it anymore.
+     */
+    void retire(const Record* record);
+
+    /**
+     * Replace the record in a slot atomically. The update function is called as
+     * `bool update_fct(const Entry& current, gul14::optional<VariableValue>& new_value)`:
+     * It stores the new value (or an empty optional for "not set") in its second argument
+     * and returns true, or it returns false to leave the slot alone. It may be called
+     * several times if other threads write concurrently. Returns the new version or 0 if
+     * nothing was written.
+     */
+    template <typename UpdateFct>
+    std::uint64_t update(const VariableName& name, UpdateFct update_fct);
+
+    /**
+     * Block until the predicate returns true (checked after each write), until the
+     * cancel flag is set, or until timeout.
+     */
+    template <typename Predicate>
+    void wait_until_changed(std::chrono::nanoseconds timeout,
+                            const std::atomic<bool>* cancel, Predicate predicate) const;
+};
+
+} // namespace task
+
+#endif
@@ -0,0 +1,137 @@
+/**
+ * \file   Bytes.h
+ * \author Lars Fröhlich
+ * \date   Created on October 18, 2026
+ * \brief  Declaration of the Bytes class.
+ *
+ * \copyright Copyright 2026 Deutsches Elektronen-Synchrotron (DESY), Hamburg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#ifndef TASKOLIB_BYTES_H_
+#define TASKOLIB_BYTES_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <gul14/string_view.h>
+
+namespace task {
+
+/**
+ * An immutable buffer of binary data with shared ownership.
+ *
+ * Copying a Bytes object only copies a reference to the data, so binary payloads like
+ * acquisition buffers can be passed between the context and the Lua state of a step, and
+ * between copies of a context, without copying their contents. Slices (see slice())
+ * refer to a part of the same buffer and do not copy either.
+ *
+ * \code
+ * Bytes buffer{ read_acquisition_buffer() }; // takes ownership of a std::string
+ * Bytes header = buffer.slice(0, 16);        // no copy
+ * std::uint8_t first = header[0];
+ * \endcode
+ *
+ * The data cannot be modified after construction. Therefore, Bytes objects can be used
+ * from different threads concurrently.
+ */
+class Bytes
+{
+public:
+    using size_type = std::size_t;
+
+    /// Construct an empty buffer.
+    Bytes() = default;
+
+    /// Construct a buffer that takes ownership of the data in the given string.
+    explicit Bytes(std::string data)
+        : data_{ std::make_shared<const std::string>(std::move(data)) }
+        , size_{ data_->size() }
+    {}
+
+    /// Construct a buffer from a copy of the given memory area.
+    Bytes(const void* data, size_type size)
+        : Bytes(std::string(static_cast<const char*>(data), size))
+    {}
+
+    /// Return a pointer to the first byte (or null for a buffer without storage).
+    const char* data() const noexcept { return data_ ? data_->data() + offset_ : nullptr; }
+
+    /// Determine if the buffer is empty.
+    bool empty() const noexcept { return size_ == 0; }
+
+    /// Determine if this buffer refers to the same storage as another one.
+    bool shares_storage_with(const Bytes& other) const noexcept
+    {
+        return data_ != nullptr && data_ == other.data_;
+    }
+
+    /// Return the number of bytes.
+    size_type size() const noexcept { return size_; }
+
+    /**
+     * Return a buffer that refers to a part of this one without copying the data.
+     *
+     * The slice starts at byte pos and contains up to len bytes (less if the end of the
+     * buffer is reached first).
+     *
+     * \exception Error is thrown if pos is greater than size().
+     */
+    Bytes slice(size_type pos, size_type len = npos) const;
+
+    /// Return a copy of the data as a string.
+    std::string to_string() const { return std::string(view()); }
+
+    /// Return a view of the data.
+    gul14::string_view view() const noexcept { return { data(), size_ }; }
+
+    /// Return the byte at the given index (without bounds checking).
+    std::uint8_t operator[](size_type idx) const noexcept
+    {
+        return static_cast<std::uint8_t>(data()[idx]);
+    }
+
+    /// Determine if two buffers hold the same data.
+    friend bool operator==(const Bytes& a, const Bytes& b) noexcept
+    {
+        if (a.size_ != b.size_)
+            return false;
+        if (a.data() == b.data())
+            return true;
+        return a.view() == b.view();
+    }
+
+    /// Determine if two buffers differ in their data.
+    friend bool operator!=(const Bytes& a, const Bytes& b) noexcept
+    {
+        return !(a == b);
+    }
+
+    /// A value for the len parameter of slice() that means "until the end".
+    static constexpr size_type npos = static_cast<size_type>(-1);
+
+private:
+    std::shared_ptr<const std::string> data_;
+    size_type offset_{ 0 };
+    size_type size_{ 0 };
+};
+
+} // namespace task
+
+#endif
@@ -26,6 +26,11 @@
 #define TASKOLIB_COMMCHANNEL_H_
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <utility>
 
 #include "taskolib/LockedQueue.h"
 #include "taskolib/Message.h"
@@ -38,11 +43,64 @@ namespace task {
  * The message queue transports messages from a worker thread to the main thread.
  * The flags are used to send requests for various actions (e.g. termination) from
  * the main thread to the worker thread.
+ *
+ * A worker thread that has nothing to do (e.g. in the Lua sleep() function) can block
+ * in wait_for_termination_request(). request_immediate_termination() sets the flag and
+ * wakes it up immediately. A thread that blocks elsewhere (e.g. on a Blackboard) can
+ * install a termination listener that wakes it up instead.
  */
 struct CommChannel
 {
     LockedQueue<Message> queue_{ 32 };
     std::atomic<bool> immediate_termination_requested_{ false };
+
+    std::mutex termination_mutex_; ///< Protects waiting for termination requests
+    std::condition_variable termination_cv_; ///< Signalled on termination requests
+
+    /// Called on termination requests (protected by termination_mutex_)
+    std::function<void()> termination_listener_;
+
+    /**
+     * Request the immediate termination of the worker thread and wake up all threads
+     * waiting in wait_for_termination_request().
+     */
+    void request_immediate_termination()
+    {
+        {
+            std::lock_guard<std::mutex> lock(termination_mutex_);
+            immediate_termination_requested_ = true;
+
+            // Called under the lock, so the listener cannot be removed (and the objects
+            // it refers to destroyed) while it runs
+            if (termination_listener_)
+                termination_listener_();
+        }
+        termination_cv_.notify_all();
+    }
+
+    /**
+     * Install a function that is called by request_immediate_termination() after setting
+     * the flag, or remove it by passing an empty function. The listener must not call
+     * any member function of the CommChannel.
+     */
+    void set_termination_listener(std::function<void()> listener)
+    {
+        std::lock_guard<std::mutex> lock(termination_mutex_);
+        termination_listener_ = std::move(listener);
+    }
+
+    /**
+     * Block until immediate termination is requested or the timeout expires.
+     *
+     * \returns true if termination has been requested, false if the timeout expired.
+     */
+    template <typename Rep, typename Period>
+    bool wait_for_termination_request(std::chrono::duration<Rep, Period> timeout)
+    {
+        std::unique_lock<std::mutex> lock(termination_mutex_);
+        return termination_cv_.wait_for(lock, timeout,
+            [this]() { return immediate_termination_requested_.load(); });
+    }
 };
 
 } // namespace task
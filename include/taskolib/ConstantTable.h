@@ -0,0 +1,189 @@
+/**
+ * \file   ConstantTable.h
+ * \author Lars Fröhlich
+ * \date   Created on October 18, 2026
+ * \brief  Declaration of the ConstantTable class.
+ *
+ * \copyright Copyright 2026 Deutsches Elektronen-Synchrotron (DESY), Hamburg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#ifndef TASKOLIB_CONSTANTTABLE_H_
+#define TASKOLIB_CONSTANTTABLE_H_
+
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <gul14/string_view.h>
+
+#include "taskolib/Timeout.h"
+#include "taskolib/VariableTable.h"
+
+namespace task {
+
+struct CommChannel;
+class ConstantTable;
+
+/**
+ * A ConstantValue is a variant over all types that can be stored in a ConstantTable.
+ *
+ * These are the same types as for a VariableValue, plus nested constant tables.
+ */
+using ConstantValue = std::variant<
+    VarInteger,
+    VarFloat,
+    VarString,
+    VarBool,
+    VarFloatArray,
+    VarIntArray,
+    VarBytes,
+    ConstantTable>;
+
+/**
+ * An immutable table of named constants that is shared by all steps and sequences that
+ * are executed with the same Context (see Context::constants).
+ *
+ * A ConstantTable is built once, either from C++ or from a Lua script, and cannot be
+ * modified afterwards. Copies of a table share the same data, so copying a Context into
+ * the worker thread of an Executor or running many executors with the same constants
+ * does not duplicate any of it. Because the data is never modified, it can be read from
+ * any number of threads concurrently.
+ *
+ * \code
+ * Context context;
+ * context.constants = ConstantTable{
+ *     { "calibration", ConstantTable::from_lua("return { gain = { 1.0, 1.02, 0.97 } }") },
+ *     { "max_current", VarFloat{ 50.0 } }
+ * };
+ * \endcode
+ *
+ * In the Lua state of every step, the table is available as the read-only global
+ * `constants`. Entries are fetched from the shared table on each access, arrays are
+ * handed out as copy-on-write FloatArray/IntArray objects, and nested tables behave like
+ * the top-level one:
+ * \code
+ * local g = constants.calibration.gain[2]
+ * for name, value in pairs(constants) do print(name) end
+ * constants.max_current = 60 -- error: constant tables are read-only
+ * \endcode
+ *
+ * Entries are stored in a contiguous array sorted by their keys, so lookups are binary
+ * searches.
+ */
+class ConstantTable
+{
+public:
+    using Entry = std::pair<std::string, ConstantValue>;
+    using const_iterator = std::vector<Entry>::const_iterator;
+
+    /// Construct an empty table.
+    ConstantTable() = default;
+
+    /**
+     * Construct a table from a list of key-value pairs.
+     * \exception Error is thrown if a key is empty or appears more than once.
+     */
+    explicit ConstantTable(std::vector<Entry> entries);
+
+    /**
+     * Construct a table from a list of key-value pairs.
+     * \exception Error is thrown if a key is empty or appears more than once.
+     */
+    ConstantTable(std::initializer_list<Entry> entries)
+        : ConstantTable(std::vector<Entry>(entries))
+    {}
+
+    /**
+     * Return the value with the given key.
+     * \exception Error is thrown if there is no such entry.
+     */
+    const ConstantValue& at(gul14::string_view key) const;
+
+    /// Return an iterator to the first entry (in the order of the keys).
+    const_iterator begin() const noexcept { return entries().begin(); }
+
+    /// Return an iterator past the last entry.
+    const_iterator end() const noexcept { return entries().end(); }
+
+    /// Determine if the table is empty.
+    bool empty() const noexcept { return size() == 0; }
+
+    /// Return a pointer to the value with the given key, or null if there is none.
+    const ConstantValue* find(gul14::string_view key) const noexcept;
+
+    /**
+     * Build a table from the return value of a Lua script.
+     *
+     * The script is executed in a fresh Lua state with the same safe subset of the
+     * standard libraries that steps use. It has to return a table with string keys.
+     * Values are converted as follows:
+     * - Numbers, strings, and booleans become VarInteger, VarFloat, VarString, and
+     *   VarBool values.
+     * - Non-empty sequences of numbers (tables with the keys 1...n) become VarIntArray
+     *   if all elements are integers, VarFloatArray otherwise.
+     * - FloatArray, IntArray, and Bytes objects are taken over as they are.
+     * - Other tables become nested constant tables.
+     *
+     * Like a step, the script is stopped when the given timeout expires or when an
+     * immediate termination is requested through the optional CommChannel.
+     *
+     * \exception Error is thrown if the script fails, if it times out or is terminated,
+     *            if it does not return a table, or if the table contains keys or values
+     *            that cannot be converted.
+     */
+    static ConstantTable from_lua(gul14::string_view script,
+        Timeout timeout = Timeout::infinity(), CommChannel* comm_channel = nullptr);
+
+    /// Determine if this table shares its data with another one.
+    bool shares_storage_with(const ConstantTable& other) const noexcept
+    {
+        return entries_ != nullptr && entries_ == other.entries_;
+    }
+
+    /// Return the number of entries.
+    std::size_t size() const noexcept { return entries_ ? entries_->size() : 0; }
+
+    /**
+     * Return a new table with an additional entry (or with a replaced value if the key
+     * exists already). The original table is not modified.
+     */
+    ConstantTable with(std::string key, ConstantValue value) const;
+
+    /// Determine if two tables hold the same entries.
+    friend bool operator==(const ConstantTable& a, const ConstantTable& b);
+
+    /// Determine if two tables differ in their entries.
+    friend bool operator!=(const ConstantTable& a, const ConstantTable& b)
+    {
+        return !(a == b);
+    }
+
+private:
+    std::shared_ptr<const std::vector<Entry>> entries_;
+
+    /// Return the vector of entries (an empty one if the table has no storage).
+    const std::vector<Entry>& entries() const noexcept;
+};
+
+} // namespace task
+
+#endif
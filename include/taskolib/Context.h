@@ -26,16 +26,19 @@
 #define TASKOLIB_CONTEXT_H_
 
 #include <functional>
+#include <memory>
 #include <string>
-#include <unordered_map>
-#include <variant>
 
 #include "sol/sol.hpp"
+#include "taskolib/Blackboard.h"
 #include "taskolib/CommChannel.h"
+#include "taskolib/ConstantTable.h"
 #include "taskolib/default_message_callback.h"
 #include "taskolib/Message.h"
+#include "taskolib/Profiler.h"
 #include "taskolib/StepIndex.h"
 #include "taskolib/VariableName.h"
+#include "taskolib/VariableTable.h"
 
 namespace task {
 
@@ -50,34 +53,20 @@ using LuaString = std::string; ///< The string type used by the Lua interpreter
 using LuaBool = bool; ///< The boolean type used by the Lua interpreter
 
 /**
- * The types available to forward variables from one Step to the next.
- */
-using VarInteger = long long; ///< Storage type for integral numbers
-using VarFloat = double; ///< Storage type for floatingpoint number
-using VarString = std::string; ///< Storage type for strings
-using VarBool = bool; ///< Storage type for booleans
-
-/**
- * A VariableValue is a variant over all Variable types.
- *
- * Variable names are associated with these values via a map in the Context class.
- *
- * Be careful when assigning a string to a VariableValue:
- * Do not use a char* to pass the string, it might be converted to bool instead
- * of the expected std::string. The conversion depends on the used compiler (version).
- */
-using VariableValue = std::variant<
-    VarInteger,
-    VarFloat,
-    VarString,
-    VarBool>;
-
-/**
- * Associative table that holds Lua variable names and their value.
+ * Strategies for importing context variables into the Lua state of a step.
  *
- * The keys are of type \a VariableName and the values \a VariableValue.
+ * \see Context::variable_import_mode
  */
-using VariableTable = std::unordered_map<VariableName, VariableValue>;
+enum class VariableImportMode
+{
+    /// All used variables of the step are copied into the Lua state before the script runs.
+    eager,
+    /**
+     * Used variables are copied into the Lua state when the script first accesses them,
+     * and only accessed variables are checked for export.
+     */
+    lazy
+};
 
 /**
  * A message callback function receives a Message object as a parameter. It is called on
@@ -97,6 +86,10 @@ using MessageCallback = std::function<void(const Message&)>;
  *   overwritten with the one from the sequence.
  * - A callback that is invoked whenever a message is being processed by the execution
  *   engine (see below for details).
+ * - An optional Profiler that samples the Lua call stack while steps are executed.
+ * - A table of read-only constants that is shared by all steps.
+ * - An optional Blackboard for exchanging variables with other running sequences.
+ * - The mode in which variables are imported into steps (eager or lazy).
  *
  * <h3>Message callback function</h3>
  *
@@ -141,6 +134,45 @@ struct Context
      * during the execution of a sequence.
      */
     MessageCallback message_callback_function = default_message_callback;
+
+    /**
+     * An optional sampling profiler for the Lua scripts of the executed steps.
+     *
+     * Profiling is disabled if this is null (the default). The profiler is shared between
+     * all copies of the context, so samples taken in the worker thread of an Executor
+     * can be read through the original pointer.
+     */
+    std::shared_ptr<Profiler> profiler;
+
+    /**
+     * Read-only constants that are available to all steps as the Lua global `constants`.
+     *
+     * The global is only defined if the table is not empty, so scripts that do not use
+     * constants are free to define their own global of that name.
+     *
+     * The table is built once (e.g. with ConstantTable::from_lua()) and shared, not
+     * copied, between all copies of the context, so large calibration or lookup tables
+     * do not have to be recreated in the step setup script.
+     */
+    ConstantTable constants;
+
+    /**
+     * An optional blackboard that is shared with other contexts (e.g. those of other
+     * executors). If it is set, steps can access it as the Lua table `blackboard`.
+     */
+    std::shared_ptr<Blackboard> blackboard;
+
+    /**
+     * The way in which context variables are imported into the Lua state of a step.
+     *
+     * In lazy mode, a metatable on the global table of the step fetches each used
+     * variable from the context on its first access, and only variables that were read
+     * or written by the script are exported again afterwards. This makes steps that
+     * declare many variables but touch only a few of them cheaper. The visible behavior
+     * of a script is the same in both modes, except that the used variables do not show
+     * up when iterating over the global table with pairs() before being accessed.
+     */
+    VariableImportMode variable_import_mode = VariableImportMode::eager;
 };
 
 } // namespace task
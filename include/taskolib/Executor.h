@@ -145,10 +145,11 @@ public:
     /**
      * Retrieve the variables stored in the context.
      *
-     * After a sequence has run the context variables can be retrieved
-     * for inspection. Note that the variables are only updated after the
-     * Sequence has stopped.
-     * Use this only after update() returns false (is_busy() == false).
+     * The variables are kept up to date while a sequence is running: Whenever a step
+     * modifies some of its exported variables, it sends the changes to the main thread,
+     * where they are applied by update(). Only the modified variables are transmitted.
+     * After the sequence has stopped (update() returns false), the variables are
+     * identical to the final context of the execution thread.
      *
      * \returns the context variable mapping.
      */
@@ -167,7 +168,8 @@ private:
     /**
      * A future for the result of the execution thread.
      * Once the thread has joined, it contains the context variables from the executed
-     * sequence.
+     * sequence. Because VariableTable shares its entries between copies, retrieving them
+     * does not copy any variables.
      */
     std::future<VariableTable> future_;
 
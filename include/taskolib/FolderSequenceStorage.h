@@ -0,0 +1,488 @@
+/**
+ * \file   FolderSequenceStorage.h
+ * \author Marcus Walla, Lars Fröhlich
+ * \date   Created on July 22, 2022
+ * \brief  Declaration of the FolderSequenceStorage class.
+ *
+ * \copyright Copyright 2022-2023 Deutsches Elektronen-Synchrotron (DESY), Hamburg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#ifndef TASKOLIB_FOLDERSEQUENCESTORAGE_H_
+#define TASKOLIB_FOLDERSEQUENCESTORAGE_H_
+
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <gul14/string_view.h>
+
+#include "taskolib/Sequence.h"
+#include "taskolib/SequenceName.h"
+#include "taskolib/SequenceStorage.h"
+#include "taskolib/UniqueId.h"
+
+namespace task {
+
+/**
+ * A SequenceStorage that stores sequences in folders below a given file system directory
+ * (the base folder).
+ *
+ * Each sequence is stored in its own folder, whose name is made up of the
+ * machine-friendly name and the unique ID of the sequence. This is the storage backend
+ * that a SequenceManager constructed from a path uses; its settings can be changed via
+ * SequenceManager::get_storage() or by constructing the manager from a shared pointer:
+ * \code
+ * auto storage = std::make_shared<FolderSequenceStorage>("sequences");
+ * storage->set_cache_capacity(100);
+ *
+ * SequenceManager manager{ storage };
+ * for (const auto& s : manager.list_sequences())
+ *     std::cout << s.name << ": " << manager.load_sequence(s.unique_id).size() << "\n";
+ * \endcode
+ *
+ * When the base folder is examined, folders of legacy sequences without a unique ID in
+ * their name are renamed with a new random ID (see list_sequences()).
+ *
+ * The storage keeps a catalog of the sequences in the base folder, indexed by their
+ * unique IDs. The catalog is built on first use and rebuilt only when the modification
+ * time of the base folder changes, so looking up a sequence normally costs a single
+ * file status query. Optionally, the catalog can be persisted in a file to speed up the
+ * first access of a new FolderSequenceStorage (see set_catalog_file_enabled()).
+ *
+ * Optionally, the storage also keeps a bounded cache of recently loaded sequences (see
+ * set_cache_capacity()). A cached sequence is reused as long as its folder has not been
+ * replaced or modified, so reloading an unmodified sequence costs a single file status
+ * query instead of reading and parsing all of its steps.
+ *
+ * <h3>Thread safety</h3>
+ *
+ * The const member functions may be called from several threads concurrently: The
+ * catalog and the cache are protected by mutexes, and the sequence folders are only
+ * replaced atomically. The settings (the non-const member functions) must not be changed
+ * while other threads use the same object.
+ *
+ * Sequences can be stored in two formats (see StorageFormat): As a folder with one Lua
+ * file per step, or as a folder holding a single archive file with an index of all
+ * steps. Both formats are always readable, so a collection of sequences can be migrated
+ * incrementally by loading and re-storing individual sequences.
+ */
+class FolderSequenceStorage : public SequenceStorage
+{
+public:
+    /// The file format used by store_sequence().
+    enum class StorageFormat
+    {
+        folder, ///< One file for the sequence parameters and one Lua file per step
+        archive ///< A single file `sequence.pack` that is loaded via one memory mapping
+    };
+
+    /**
+     * Create a FolderSequenceStorage for sequences that are stored in a given directory.
+     *
+     * \param path    the base folder that contains individual folders for each sequence.
+     * \param format  the format in which sequences are stored by store_sequence()
+     *
+     * \exception Error is thrown if the path name is empty.
+     */
+    explicit FolderSequenceStorage(std::filesystem::path path,
+        StorageFormat format = StorageFormat::folder);
+
+    /**
+     * Create a FolderSequenceStorage for the same base folder and with the same settings
+     * as another one. The catalog and the cache of loaded sequences are not copied.
+     */
+    FolderSequenceStorage(const FolderSequenceStorage& other);
+
+    /// Take over the base folder and the settings of another FolderSequenceStorage.
+    FolderSequenceStorage& operator=(const FolderSequenceStorage& other);
+
+    /// Discard all sequences from the cache of loaded sequences.
+    void clear_cache() const;
+
+    /**
+     * Create a copy of an existing sequence in a new folder.
+     *
+     * Because name and unique ID are only encoded in the folder name, all files of the
+     * original folder are copied unchanged and keep their modification times. On
+     * copy-on-write filesystems, the files are cloned without copying their data. The
+     * copy keeps the storage format of the original.
+     *
+     * \param original_uid  unique ID of the original sequence
+     * \param new_name      machine-friendly name of the copy
+     * \param new_uid       unique ID of the copy
+     *
+     * \exception Error is thrown if the original sequence cannot be found, if the new
+     *            unique ID is already in use, or if the new sequence folder cannot be
+     *            created.
+     */
+    void copy_sequence(UniqueId original_uid, const SequenceName& new_name,
+                       UniqueId new_uid) const override;
+
+    /// Return the maximum number of sequences in the cache of loaded sequences.
+    std::size_t get_cache_capacity() const noexcept { return cache_capacity_; }
+
+    /**
+     * Return the base path of the serialized sequences.
+     *
+     * \returns the base path of the serialized sequences.
+     */
+    std::filesystem::path get_path() const { return path_; }
+
+    /// Determine if the catalog of sequences is persisted in a file in the base folder.
+    bool is_catalog_file_enabled() const noexcept { return catalog_file_enabled_; }
+
+    /// Return the maximum number of threads used for loading the steps of a sequence.
+    unsigned int get_num_load_threads() const noexcept { return num_load_threads_; }
+
+    /// Return the format in which sequences are stored by store_sequence().
+    StorageFormat get_storage_format() const noexcept { return storage_format_; }
+
+    /**
+     * Return an unsorted list of all valid sequences that are found inside the base path
+     * and rename sequence folders that do not contain a valid unique ID.
+     *
+     * This function examines all folders inside the base path. If any of these folder
+     * names does not contain a valid unique ID, one is randomly generated and the folder
+     * is renamed accordingly.
+     *
+     * \returns a vector containing one SequenceOnDisk object for each sequence that was
+     *          found. The paths in the returned objects are relative to the base path.
+     *
+     * \exception Error is thrown if one of the folders needs to be renamed but the
+     *            renaming fails.
+     */
+    std::vector<SequenceOnDisk> list_sequences() const override;
+
+    /**
+     * Load a sequence from the base folder.
+     *
+     * \param unique_id  unique ID of the sequence to be loaded
+     *
+     * \returns the loaded sequence.
+     *
+     * If the cache of loaded sequences is enabled, the sequence is copied from a cached
+     * snapshot when the sequence has not been modified on disk since it was cached (see
+     * load_sequence_snapshot()).
+     *
+     * \exception Error is thrown if the sequence cannot be loaded.
+     */
+    Sequence load_sequence(UniqueId uid) const override;
+
+    /**
+     * Load only the metadata of a sequence from the base folder.
+     *
+     * This reads the sequence parameters (label, maintainers, timeout) and counts the
+     * steps, but does not read or parse any step. It is meant for browsing many
+     * sequences; the steps can be loaded later with load_sequence() when the sequence is
+     * actually opened or executed.
+     *
+     * \param uid  unique ID of the sequence
+     *
+     * \exception Error is thrown if the sequence cannot be found or read.
+     */
+    SequenceHeader load_sequence_header(UniqueId uid) const override;
+
+    /**
+     * Load the metadata of all sequences in the base folder.
+     *
+     * \returns an unsorted list with the header of every sequence found by
+     *          list_sequences().
+     *
+     * \exception Error is thrown if one of the sequences cannot be read.
+     * \see load_sequence_header(UniqueId)
+     */
+    std::vector<SequenceHeader> load_sequence_headers() const;
+
+    /**
+     * Load a sequence from the base folder and return it as a shared, immutable snapshot.
+     *
+     * If the cache of loaded sequences is enabled (see set_cache_capacity()), the
+     * snapshot is taken from the cache as long as the sequence folder has the same inode
+     * number and modification time as when it was loaded. Otherwise, the sequence is
+     * loaded from disk and put into the cache, evicting the least recently used sequence
+     * if the cache is full. Sequences that have been modified within the last few seconds
+     * are not cached because a further modification might not change the timestamp.
+     *
+     * store_sequence() replaces the whole folder, and most editors replace a file instead
+     * of overwriting it, which modifies the folder as well. A step file that is
+     * overwritten in place by another program is not noticed, though; call clear_cache()
+     * after such a modification.
+     *
+     * The snapshot is never modified by the FolderSequenceStorage, so it can be shared
+     * freely (also between threads). A snapshot remains valid after its sequence has been
+     * evicted from the cache or modified on disk, but it is not updated.
+     *
+     * \param uid  unique ID of the sequence to be loaded
+     *
+     * \exception Error is thrown if the sequence cannot be loaded.
+     */
+    std::shared_ptr<const Sequence> load_sequence_snapshot(UniqueId uid) const override;
+
+    /**
+     * Remove a sequence from the base folder.
+     *
+     * The sequence to be removed is identified by its unique ID.
+     *
+     * \param unique_id  the unique ID of the sequence
+     *
+     * \exception Error is thrown if the sequence cannot be found or if the removal of
+     *            the folder fails.
+     */
+    void remove_sequence(UniqueId unique_id) const override;
+
+    /**
+     * Change the machine-friendly name of a sequence on disk.
+     *
+     * The sequence to be renamed is identified by its unique ID.
+     *
+     * \param unique_id  the unique ID of the sequence
+     * \param new_name   the new machine-friendly name of the sequence
+     *
+     * \exception Error is thrown if the sequence cannot be found or if the renaming of
+     *            the folder fails.
+     */
+    void rename_sequence(UniqueId unique_id, const SequenceName& new_name)
+        const override;
+
+    /**
+     * Set the maximum number of sequences in the cache of loaded sequences.
+     *
+     * The cache is used by load_sequence(UniqueId) and load_sequence_snapshot(). When it
+     * is full, the least recently used sequence is evicted. Storing, renaming, or removing
+     * a sequence through this storage removes it from the cache.
+     *
+     * \param num_sequences  the maximum number of cached sequences. The default of 0
+     *                       disables the cache.
+     */
+    void set_cache_capacity(std::size_t num_sequences);
+
+    /**
+     * Enable or disable the persistent catalog file.
+     *
+     * If enabled, the catalog of sequences is stored in the hidden file
+     * `.sequence_catalog` in the base folder together with the modification time of the
+     * folder. A new FolderSequenceStorage can then read the catalog from this file
+     * instead of examining all sequence folders, as long as the base folder has not been
+     * modified in the meantime. The file is disabled by default.
+     */
+    void set_catalog_file_enabled(bool enable) noexcept { catalog_file_enabled_ = enable; }
+
+    /**
+     * Set the maximum number of threads used for loading the steps of a sequence.
+     *
+     * With more than one thread, load_sequence() reads and parses the step files of a
+     * sequence concurrently, which speeds up loading from storage with a high latency.
+     * The steps are still assembled in the order of their filenames. Sequence archives
+     * are always loaded by a single thread.
+     *
+     * \param num_threads  the maximum number of threads (including the calling one). The
+     *                     default of 1 loads all steps sequentially, 0 selects the number
+     *                     of hardware threads.
+     */
+    void set_num_load_threads(unsigned int num_threads) noexcept;
+
+    /// Set the format in which sequences are stored by store_sequence().
+    void set_storage_format(StorageFormat format) noexcept { storage_format_ = format; }
+
+    /**
+     * Store the given sequence in a subfolder under the base directory of this object.
+     *
+     * This function generates a subfolder name from the sequence name and unique ID and
+     * stores the sequence inside it. Inside the folder, each step is stored in a separate
+     * file. The filenames start with `step` followed by a consecutive number followed by
+     * the type of the step and the extension `'.lua'`. The step number is zero-filled to
+     * allow alphanumerical sorting (e.g. `step_01_action.lua`).
+     *
+     * The save is crash-safe: The new folder is assembled in a hidden temporary folder
+     * next to the old one, flushed to disk, and then swapped with the old folder in a
+     * single rename operation. A crash or a full disk during the save therefore leaves
+     * the previously stored sequence intact. Where the filesystem cannot exchange two
+     * folders atomically, the old folder is briefly moved to a hidden backup folder; if
+     * the save is interrupted at that point, the backup is restored by the next scan of
+     * the base folder. Only the files that have actually been written (or copied) are
+     * synchronized to disk, followed by their folder.
+     *
+     * If the sequence has been stored before, only the files that differ from the
+     * serialized sequence are written. Unchanged files, including those of steps that
+     * have moved to a different index, are hard-linked from the old folder. Saving a
+     * sequence after a small edit therefore writes only a few files. Files that do not
+     * belong to the sequence format are carried over into the new folder.
+     *
+     * To find the unchanged files without reading them, the content hashes of all files
+     * are kept in the hidden file `.sequence_hashes` in the sequence folder, together with
+     * the inode number, size, and modification time of each file. A file whose recorded
+     * properties no longer match (e.g. because it has been edited by hand) is read and
+     * compared byte by byte instead.
+     *
+     * If the storage format is StorageFormat::archive, the folder instead contains only a
+     * single archive file `sequence.pack` with the sequence parameters and all steps.
+     * The files of the other format are removed, so storing a sequence also converts it.
+     *
+     * \param sequence  the sequence to be stored
+     */
+    void store_sequence(const Sequence& sequence) const override;
+
+private:
+    /// An index of the sequences in the base folder.
+    struct Catalog
+    {
+        /// Modification time of the base folder at the time of the scan
+        std::filesystem::file_time_type folder_time{};
+
+        /// All sequences in the base folder
+        std::vector<SequenceOnDisk> sequences;
+
+        /// Positions of the sequences in the vector, indexed by unique ID
+        std::unordered_map<UniqueId, std::size_t> index;
+
+        /// Flag to indicate that the catalog can be reused if the folder time matches
+        bool is_valid{ false };
+    };
+
+    /**
+     * Properties that identify the state of a sequence folder on disk. The inode number
+     * changes whenever store_sequence() replaces the folder, the modification time
+     * whenever a file in it is created, removed, or renamed.
+     */
+    struct FolderStamp
+    {
+        std::uint64_t inode{ 0 }; ///< Inode number of the folder
+        std::int64_t mtime_ns{ 0 }; ///< Modification time in nanoseconds since the epoch
+
+        friend bool operator==(const FolderStamp& a, const FolderStamp& b) noexcept
+        {
+            return a.inode == b.inode && a.mtime_ns == b.mtime_ns;
+        }
+    };
+
+    /// A loaded sequence in the cache.
+    struct CacheEntry
+    {
+        UniqueId unique_id; ///< Unique ID of the sequence
+        std::filesystem::path path; ///< Path to the sequence folder relative to the base path
+        FolderStamp stamp; ///< State of the folder when the sequence was loaded
+        std::shared_ptr<const Sequence> sequence; ///< The loaded sequence
+    };
+
+    /// Base path to the sequences.
+    std::filesystem::path path_;
+
+    /// Cached catalog of the base folder (see get_catalog()), null before the first use.
+    mutable std::shared_ptr<const Catalog> catalog_;
+
+    /// Mutex protecting catalog_, held while the base folder is examined.
+    mutable std::mutex catalog_mutex_;
+
+    /// Flag to indicate that the catalog is persisted in a file.
+    bool catalog_file_enabled_{ false };
+
+    /// Format used for storing sequences.
+    StorageFormat storage_format_;
+
+    /// Maximum number of threads for loading steps.
+    unsigned int num_load_threads_{ 1 };
+
+    /// Maximum number of sequences in the cache (0 disables the cache).
+    std::size_t cache_capacity_{ 0 };
+
+    /// Cached sequences, starting with the most recently used one.
+    mutable std::list<CacheEntry> cache_;
+
+    /// Positions of the cached sequences in the list, indexed by unique ID
+    mutable std::unordered_map<UniqueId, std::list<CacheEntry>::iterator> cache_index_;
+
+    /**
+     * Counter that is incremented whenever sequences are evicted from the cache, so that
+     * a sequence that is modified while it is being loaded is not cached.
+     */
+    mutable std::uint64_t cache_generation_{ 0 };
+
+    /// Mutex protecting cache_, cache_index_, and cache_generation_.
+    mutable std::mutex cache_mutex_;
+
+    /**
+     * Create a random unique ID that does not collide with the ID of any sequence in the
+     * given sequence list.
+     *
+     * \exception Error is thrown if no unique ID can be found.
+     */
+    static UniqueId create_unique_id(const std::vector<SequenceOnDisk>& sequences);
+
+    /**
+     * Remove the sequence with the given unique ID from the cache (if present) and
+     * increment the cache generation.
+     */
+    void evict_from_cache(UniqueId uid) const;
+
+    /**
+     * Find the sequence with the given unique ID in the catalog of the base folder.
+     * \exception Error is thrown if the sequence cannot be found.
+     */
+    SequenceOnDisk find_sequence_on_disk(UniqueId uid) const;
+
+    /**
+     * Return the catalog of the base folder.
+     *
+     * The cached catalog is returned if the modification time of the base folder has not
+     * changed since it was built. Otherwise, it is read from the catalog file (if
+     * enabled and up to date) or rebuilt by scanning the base folder. A catalog is never
+     * modified after it has been returned, so it can be used without holding a lock.
+     */
+    std::shared_ptr<const Catalog> get_catalog() const;
+
+    /**
+     * Determine the inode number and the modification time of the given folder.
+     * \exception Error is thrown if the folder cannot be examined.
+     */
+    static FolderStamp get_folder_stamp(const std::filesystem::path& folder);
+
+    /// Load a sequence from the given folder.
+    Sequence load_sequence(const SequenceOnDisk& seq_on_disk) const;
+
+    /// Load the metadata of a sequence from the given folder.
+    SequenceHeader load_sequence_header(const SequenceOnDisk& seq_on_disk) const;
+
+    /**
+     * Try to read the catalog from the catalog file into the given object. Return true if
+     * the file exists and matches the given modification time of the base folder.
+     */
+    bool read_catalog_file(std::filesystem::file_time_type folder_time,
+        Catalog& catalog) const;
+
+    /**
+     * Examine all folders in the base folder and return the sequences found, renaming
+     * legacy sequence folders without a unique ID and restoring sequence folders from
+     * backups left behind by an interrupted store_sequence().
+     */
+    std::vector<SequenceOnDisk> scan_base_folder() const;
+
+    /// Store the given catalog in the catalog file.
+    void write_catalog_file(const Catalog& catalog) const;
+
+    /// Generate a machine-friendly sequence name from a human-readable label.
+    static SequenceName make_sequence_name_from_label(gul14::string_view label);
+};
+
+} // namespace task
+
+#endif
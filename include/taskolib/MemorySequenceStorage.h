@@ -0,0 +1,96 @@
+/**
+ * \file   MemorySequenceStorage.h
+ * \author Lars Fröhlich
+ * \date   Created on October 18, 2026
+ * \brief  Declaration of the MemorySequenceStorage class.
+ *
+ * \copyright Copyright 2026 Deutsches Elektronen-Synchrotron (DESY), Hamburg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+
+#ifndef TASKOLIB_MEMORYSEQUENCESTORAGE_H_
+#define TASKOLIB_MEMORYSEQUENCESTORAGE_H_
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "taskolib/Sequence.h"
+#include "taskolib/SequenceName.h"
+#include "taskolib/SequenceStorage.h"
+#include "taskolib/UniqueId.h"
+
+namespace task {
+
+/**
+ * A SequenceStorage that keeps the stored sequences in memory.
+ *
+ * Sequences are serialized when they are stored and deserialized when they are loaded,
+ * using the same format as a FolderSequenceStorage with StorageFormat::archive. A
+ * loaded sequence therefore looks exactly as if it had been loaded from disk, but no file
+ * is ever touched. This makes the class a fast replacement for a FolderSequenceStorage on
+ * a temporary directory in tests:
+ * \code
+ * SequenceManager manager{ std::make_shared<MemorySequenceStorage>() };
+ * \endcode
+ *
+ * Copies of a MemorySequenceStorage share the same stored sequences, just like two
+ * FolderSequenceStorage objects for the same base folder.
+ *
+ * \note
+ * A MemorySequenceStorage must not be used from several threads concurrently.
+ */
+class MemorySequenceStorage : public SequenceStorage
+{
+public:
+    /// Construct an empty storage.
+    MemorySequenceStorage();
+
+    std::vector<SequenceOnDisk> list_sequences() const override;
+    void copy_sequence(UniqueId original_uid, const SequenceName& new_name,
+                       UniqueId new_uid) const override;
+    Sequence load_sequence(UniqueId uid) const override;
+    void remove_sequence(UniqueId unique_id) const override;
+    void rename_sequence(UniqueId unique_id, const SequenceName& new_name)
+        const override;
+    void store_sequence(const Sequence& sequence) const override;
+
+private:
+    /// A serialized sequence.
+    struct StoredSequence
+    {
+        SequenceName name; ///< Machine-friendly name of the sequence
+        std::string archive; ///< Parameters and steps (see make_sequence_archive())
+    };
+
+    using SequenceMap = std::unordered_map<UniqueId, StoredSequence>;
+
+    /// Stored sequences, indexed by unique ID.
+    std::shared_ptr<SequenceMap> sequences_;
+
+    /**
+     * Return the stored sequence with the given unique ID.
+     * \exception Error is thrown if the sequence cannot be found.
+     */
+    SequenceMap::iterator find_sequence(UniqueId uid) const;
+};
+
+} // namespace task
+
+#endif
@@ -33,13 +33,20 @@
 #include <gul14/escape.h>
 
 #include "taskolib/StepIndex.h"
+#include "taskolib/StepStatistics.h"
 #include "taskolib/time_types.h"
+#include "taskolib/VariableTable.h"
 
 namespace task {
 
 /**
  * A message carrying some text, a timestamp, and a type, to be transported with a message
  * queue between threads.
+ *
+ * Messages of type step_stopped and step_stopped_with_error additionally carry the Lua VM
+ * counters of the step execution (see get_statistics()). Messages of type
+ * context_variables_changed carry the modifications that a step has made to the context
+ * variables (see get_variable_changes()).
  */
 class Message
 {
@@ -54,6 +61,7 @@ public:
         step_started, ///< a step inside a sequence has been started
         step_stopped, ///< a step inside a sequence has stopped regularly
         step_stopped_with_error, ///< a step inside a sequence has been stopped because of an error
+        context_variables_changed, ///< a step has modified some context variables
         undefined ///< marker for last type
     };
 
@@ -68,6 +76,7 @@ private:
         "step_started",
         "step_stopped",
         "step_stopped_with_error",
+        "context_variables_changed",
         "undefined"
     };
 
@@ -96,15 +105,42 @@ public:
      */
     const std::string& get_text() const { return text_; }
 
+    /**
+     * Return the Lua VM counters of a step execution.
+     *
+     * The statistics are only filled for messages of type step_stopped and
+     * step_stopped_with_error; for all other types, all counters are zero.
+     */
+    const StepStatistics& get_statistics() const noexcept { return statistics_; }
+
     /// Return the message type.
     Type get_type() const noexcept { return type_; }
 
     /// Return the timestamp.
     TimePoint get_timestamp() const { return timestamp_; };
 
+    /**
+     * Return the modifications of context variables that are carried by this message.
+     *
+     * The list is only filled for messages of type context_variables_changed. This
+     * function returns a reference to a member variable. Be aware of the associated
+     * lifetime implications!
+     */
+    const VariableChanges& get_variable_changes() const noexcept
+    {
+        return variable_changes_;
+    }
+
     /// Set the associated index.
     Message& set_index(OptionalStepIndex index) { index_ = index; return *this; }
 
+    /// Set the Lua VM counters of a step execution.
+    Message& set_statistics(const StepStatistics& statistics) noexcept
+    {
+        statistics_ = statistics;
+        return *this;
+    }
+
     /// Set the message text.
     Message& set_text(const std::string& text) { text_ = text; return *this; }
 
@@ -114,6 +150,13 @@ public:
     /// Set the message type.
     Message& set_type(Type type) noexcept { type_ = type; return *this; }
 
+    /// Set the modifications of context variables that are carried by this message.
+    Message& set_variable_changes(VariableChanges changes)
+    {
+        variable_changes_ = std::move(changes);
+        return *this;
+    }
+
     friend std::ostream& operator<<(std::ostream& stream, Type const& t) {
         stream << Message::type_description_[static_cast<int>(t)];
         return stream;
@@ -141,6 +184,8 @@ private:
     TimePoint timestamp_{};
     Type type_{ Type::output };
     OptionalStepIndex index_;
+    StepStatistics statistics_;
+    VariableChanges variable_changes_;
 };
 
 } // namespace task
@@ -0,0 +1,222 @@
+/**
+ * \file   NumericArray.h
+ * \author Lars Fröhlich
+ * \date   Created on October 18, 2026
+ * \brief  Declaration of the NumericArray class template and of numeric array kernels.
+ *
+ * \copyright Copyright 2026 Deutsches Elektronen-Synchrotron (DESY), Hamburg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#ifndef TASKOLIB_NUMERICARRAY_H_
+#define TASKOLIB_NUMERICARRAY_H_
+
+#include <atomic>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+
+#include <gul14/optional.h>
+
+namespace task {
+
+/**
+ * A one-dimensional array of numbers with shared, copy-on-write storage.
+ *
+ * Copying a NumericArray is cheap: All copies share the same block of memory until one of
+ * them is modified through set() or get_mutable(), at which point the modified array
+ * obtains its own copy of the data. Read access never copies the data. This allows large arrays (e.g. waveforms) to be
+ * passed between the context and the Lua state of a step without copying any elements.
+ *
+ * \code
+ * NumericArray<double> a{ 1.0, 2.0, 3.0 };
+ * NumericArray<double> b = a; // no copy of the elements
+ * b.set(0, 42.0);            // b now has its own copy, a is unchanged
+ * \endcode
+ *
+ * The usual instantiations are available as VarFloatArray and VarIntArray. A small
+ * library of kernels for common operations on whole arrays (sum(), mean(), minimum(),
+ * maximum(), scale_and_offset(), dot(), find_threshold()) works directly on the
+ * contiguous storage.
+ *
+ * \note
+ * Different NumericArray objects may be used from different threads even if they share
+ * their storage. A single object must not be modified concurrently.
+ */
+template <typename T>
+class NumericArray
+{
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using const_iterator = typename std::vector<T>::const_iterator;
+
+    /// Construct an empty array.
+    NumericArray() = default;
+
+    /// Construct an array with the given number of elements, all set to value.
+    explicit NumericArray(size_type size, T value = T{})
+        : data_{ std::make_shared<std::vector<T>>(size, value) }
+    {}
+
+    /// Construct an array from a vector.
+    explicit NumericArray(std::vector<T> values)
+        : data_{ std::make_shared<std::vector<T>>(std::move(values)) }
+    {}
+
+    /// Construct an array from a list of values.
+    NumericArray(std::initializer_list<T> values)
+        : data_{ std::make_shared<std::vector<T>>(values) }
+    {}
+
+    /// Return an iterator to the first element.
+    const_iterator begin() const noexcept { return get().begin(); }
+
+    /// Return an iterator past the last element.
+    const_iterator end() const noexcept { return get().end(); }
+
+    /// Return a pointer to the contiguous elements (or null for an empty array).
+    const T* data() const noexcept { return data_ ? data_->data() : nullptr; }
+
+    /// Determine if the array is empty.
+    bool empty() const noexcept { return size() == 0; }
+
+    /// Return a const reference to the underlying vector.
+    const std::vector<T>& get() const noexcept
+    {
+        return data_ ? *data_ : empty_vector_;
+    }
+
+    /**
+     * Return a mutable reference to the underlying vector.
+     *
+     * If the storage is shared with other arrays, it is copied first.
+     */
+    std::vector<T>& get_mutable()
+    {
+        if (not data_)
+        {
+            data_ = std::make_shared<std::vector<T>>();
+        }
+        else if (data_.use_count() != 1)
+        {
+            data_ = std::make_shared<std::vector<T>>(*data_);
+        }
+        else
+        {
+            // We hold the only reference (see VariableTable::mutable_entries()). The
+            // fence orders our writes after the reads of the last other owner.
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+        return *data_;
+    }
+
+    /**
+     * Assign a new value to the element with the given index (without bounds checking).
+     *
+     * If the storage is shared with other arrays, it is copied first.
+     */
+    void set(size_type idx, T value) { get_mutable()[idx] = value; }
+
+    /// Determine if this array shares its storage with another one.
+    bool shares_storage_with(const NumericArray& other) const noexcept
+    {
+        return data_ != nullptr && data_ == other.data_;
+    }
+
+    /// Return the number of elements.
+    size_type size() const noexcept { return data_ ? data_->size() : 0; }
+
+    /// Return the element with the given index (without bounds checking).
+    const T& operator[](size_type idx) const noexcept { return (*data_)[idx]; }
+
+    /// Determine if two arrays hold the same elements.
+    friend bool operator==(const NumericArray& a, const NumericArray& b) noexcept
+    {
+        return a.data_ == b.data_ || a.get() == b.get();
+    }
+
+    /// Determine if two arrays differ in their elements.
+    friend bool operator!=(const NumericArray& a, const NumericArray& b) noexcept
+    {
+        return !(a == b);
+    }
+
+private:
+    static inline const std::vector<T> empty_vector_{};
+
+    std::shared_ptr<std::vector<T>> data_;
+};
+
+/**
+ * Return the sum of all elements of an array (0 for an empty array).
+ *
+ * Floating-point sums are computed with several independent accumulators, so the result
+ * may differ from a strictly sequential summation in the last digits. Integer sums wrap
+ * around on overflow, like integer arithmetic in Lua.
+ */
+template <typename T>
+T sum(const NumericArray<T>& array) noexcept;
+
+/**
+ * Return the arithmetic mean of all elements of an array.
+ * \exception Error is thrown if the array is empty.
+ */
+template <typename T>
+double mean(const NumericArray<T>& array);
+
+/**
+ * Return the smallest element of an array.
+ * \exception Error is thrown if the array is empty.
+ */
+template <typename T>
+T minimum(const NumericArray<T>& array);
+
+/**
+ * Return the largest element of an array.
+ * \exception Error is thrown if the array is empty.
+ */
+template <typename T>
+T maximum(const NumericArray<T>& array);
+
+/// Return a new floating-point array with the elements `factor * x + offset`.
+template <typename T>
+NumericArray<double> scale_and_offset(const NumericArray<T>& array, double factor,
+                                      double offset = 0.0);
+
+/**
+ * Return the dot product of two arrays.
+ *
+ * As with sum(), integer results wrap around on overflow.
+ *
+ * \exception Error is thrown if the arrays have different sizes.
+ */
+template <typename T>
+T dot(const NumericArray<T>& a, const NumericArray<T>& b);
+
+/**
+ * Return the index of the first element that is greater than or equal to the given
+ * threshold, or an empty optional if there is no such element.
+ */
+template <typename T>
+gul14::optional<std::size_t> find_threshold(const NumericArray<T>& array, T threshold)
+    noexcept;
+
+} // namespace task
+
+#endif
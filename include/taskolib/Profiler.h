@@ -0,0 +1,152 @@
+/**
+ * \file   Profiler.h
+ * \author Lars Fröhlich
+ * \date   Created on October 18, 2026
+ * \brief  Declaration of the Profiler class.
+ *
+ * \copyright Copyright 2026 Deutsches Elektronen-Synchrotron (DESY), Hamburg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#ifndef TASKOLIB_PROFILER_H_
+#define TASKOLIB_PROFILER_H_
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "taskolib/StepIndex.h"
+
+struct lua_State;
+
+namespace task {
+
+/**
+ * A sampling profiler for Lua scripts.
+ *
+ * If a profiler is attached to a Context, the Lua call stack of each executed step is
+ * sampled periodically from within the debug hook that also checks for timeouts and
+ * termination requests. The sampling interval can be given either as a number of Lua VM
+ * instructions or as a time interval. Each sample is attributed to the index of the
+ * executed step and to the current script line of every function on the call stack.
+ *
+ * The collected samples can be retrieved in the "folded stack" format that is understood
+ * by flamegraph tools (e.g. flamegraph.pl or speedscope):
+ * \code
+ * auto profiler = std::make_shared<Profiler>(1000); // sample every 1000 instructions
+ *
+ * Context context;
+ * context.profiler = profiler;
+ *
+ * sequence.execute(context, nullptr);
+ *
+ * std::ofstream("profile.folded") << profiler->get_folded_stacks();
+ * \endcode
+ * A typical line of output looks like `step 3;main:12;compute:5 42`, meaning that 42
+ * samples were taken while line 5 of function compute() was executed, which had been
+ * called from line 12 of the main chunk of the script of the step with index 3.
+ *
+ * Only time spent in the Lua VM is sampled. Time spent inside C++ functions such as
+ * sleep() does not generate instruction counts and is therefore only visible in
+ * time-based sampling mode, where it is attributed to the next sample taken afterwards.
+ *
+ * All member functions are thread-safe, so a profiler can be shared by several Executors
+ * and be read while sequences are running.
+ */
+class Profiler
+{
+public:
+    /**
+     * Construct a profiler that samples the call stack every \a instruction_interval Lua
+     * VM instructions.
+     *
+     * \exception Error is thrown if instruction_interval is zero.
+     */
+    explicit Profiler(std::uint32_t instruction_interval = 1000);
+
+    /**
+     * Construct a profiler that samples the call stack once per \a time_interval of
+     * script execution.
+     *
+     * \exception Error is thrown if time_interval is not positive.
+     */
+    explicit Profiler(std::chrono::microseconds time_interval);
+
+    /// Discard all samples taken so far.
+    void clear();
+
+    /**
+     * Return all samples taken so far in the folded stack format.
+     *
+     * Each line contains a semicolon-separated list of stack frames (from the outermost to
+     * the innermost one), a space, and the number of samples that were taken with this
+     * call stack. The lines are sorted alphabetically.
+     */
+    std::string get_folded_stacks() const;
+
+    /**
+     * Return the sampling interval in Lua VM instructions or zero if the profiler samples
+     * in regular time intervals.
+     */
+    std::uint32_t get_instruction_interval() const noexcept
+    {
+        return instruction_interval_;
+    }
+
+    /// Return the total number of samples taken so far.
+    std::uint64_t get_sample_count() const;
+
+    /**
+     * Return the sampling time interval or zero if the profiler samples after a fixed
+     * number of instructions.
+     */
+    std::chrono::microseconds get_time_interval() const noexcept
+    {
+        return time_interval_;
+    }
+
+    /**
+     * Take a sample of the call stack of the given Lua state.
+     *
+     * This function is normally called from the debug hook of a running script.
+     *
+     * \param lua_state  The Lua state whose call stack should be examined
+     * \param step_idx   Index of the step that is being executed (if available)
+     * \param weight     Number of samples that should be recorded for this call stack
+     */
+    void sample(lua_State* lua_state, OptionalStepIndex step_idx,
+                std::uint64_t weight = 1);
+
+private:
+    std::uint32_t instruction_interval_{ 0 };
+    std::chrono::microseconds time_interval_{ 0 };
+
+    /// Mutex protecting stacks_ and sample_count_
+    mutable std::mutex mutex_;
+
+    /// Number of samples for each folded call stack
+    std::map<std::string, std::uint64_t> stacks_;
+
+    /// Total number of samples
+    std::uint64_t sample_count_{ 0 };
+};
+
+} // namespace task
+
+#endif
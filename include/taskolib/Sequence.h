@@ -29,6 +29,7 @@
 #include <chrono>
 #include <filesystem>
 #include <functional>
+#include <iterator>
 #include <limits>
 #include <string>
 #include <vector>
@@ -446,6 +447,35 @@ public:
      */
     ConstIterator insert(ConstIterator iter, Step&& step);
 
+    /**
+     * Insert a range of steps into the sequence just before the specified iterator.
+     *
+     * The indentation and the other invariants of the sequence are updated only once
+     * after all steps have been inserted, which makes this function much faster than
+     * inserting many steps one by one.
+     *
+     * This can trigger a reallocation that invalidates all iterators.
+     *
+     * \param iter   an iterator indicating the position before which the new steps should
+     *               be inserted
+     * \param first  forward iterator to the first Step to be inserted
+     * \param last   forward iterator past the last Step to be inserted
+     * \returns an iterator to the first inserted Step (or iter if the range is empty)
+     *
+     * \exception Error is thrown if the sequence has no capacity for the additional
+     *            entries or if it is currently running.
+     */
+    template <typename ForwardIterator>
+    ConstIterator insert(ConstIterator iter, ForwardIterator first, ForwardIterator last)
+    {
+        throw_if_running();
+        throw_if_full(static_cast<std::size_t>(std::distance(first, last)));
+
+        auto return_iter = steps_.insert(iter, first, last);
+        enforce_invariants();
+        return return_iter;
+    }
+
     /**
      * Retrieve if the sequence is executed.
      *
@@ -884,8 +914,8 @@ private:
      */
     void indent();
 
-    /// Throw an Error if no further steps can be inserted into the sequence.
-    void throw_if_full() const;
+    /// Throw an Error if the given number of steps cannot be inserted into the sequence.
+    void throw_if_full(std::size_t num_new_steps = 1) const;
 
     /// When the sequence is executed it rejects with an Error exception.
     void throw_if_running() const;
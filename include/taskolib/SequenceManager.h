@@ -4,7 +4,7 @@
  * \date   Created on July 22, 2022
  * \brief  Manage and control sequences.
  *
- * \copyright Copyright 2022-2023 Deutsches Elektronen-Synchrotron (DESY), Hamburg
+ * \copyright Copyright 2022-2026 Deutsches Elektronen-Synchrotron (DESY), Hamburg
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU Lesser General Public License as published
@@ -26,20 +26,25 @@
 #define TASKOLIB_SEQUENCEMANAGER_H_
 
 #include <filesystem>
-#include <string>
+#include <memory>
 #include <vector>
 
 #include <gul14/string_view.h>
 
+#include "taskolib/FolderSequenceStorage.h"
 #include "taskolib/Sequence.h"
+#include "taskolib/SequenceName.h"
+#include "taskolib/SequenceStorage.h"
 #include "taskolib/UniqueId.h"
 
 namespace task {
 
 /**
- * A class for listing, loading, storing, and renaming sequences in a given file system
- * directory.
+ * A class for listing, creating, copying, loading, storing, and renaming sequences.
  *
+ * The sequences are kept in a storage backend (see SequenceStorage). By default, this is
+ * a FolderSequenceStorage that stores each sequence in a folder below a given base
+ * directory:
  * \code
  * // Create a SequenceManager that manages sequences stored in the base folder "sequences"
  * SequenceManager manager{ "sequences" };
@@ -49,51 +54,66 @@ namespace task {
  *
  * for (const auto& s : sequences) {
  *     // Load the sequence from disk
- *     auto seq = manager.load_sequence(s.path);
- *     std::cout << "Sequence " << seq.get_name() << " has " << seq.get_steps().size()
- *               << " steps\n";
+ *     auto seq = manager.load_sequence(s.unique_id);
+ *     std::cout << "Sequence " << seq.get_name() << " has " << seq.size() << " steps\n";
  * }
  * \endcode
+ *
+ * The manager itself never touches the filesystem. It allocates unique IDs and assembles
+ * new sequences, and leaves everything else to the backend. A manager on a
+ * MemorySequenceStorage therefore behaves like one on a base folder, but without any
+ * disk access. Backend-specific behavior stays in the backend: For instance, the
+ * catalog, the cache of loaded sequences, the storage format, and the renaming of legacy
+ * sequence folders without a unique ID are features of FolderSequenceStorage, whose
+ * settings are changed on the storage object itself (see get_storage()).
+ *
+ * Copies of a SequenceManager share the same storage object. The manager is as
+ * thread-safe as its backend.
  */
 class SequenceManager
 {
 public:
-    /// A struct to represent a sequence on disk.
-    struct SequenceOnDisk
-    {
-        std::filesystem::path path; ///< Path to the sequence, relative to SequenceManager base path
-        SequenceName name; ///< Machine-friendly name of the sequence
-        UniqueId unique_id; ///< Unique ID of the sequence
-    };
+    using SequenceOnDisk = SequenceStorage::SequenceOnDisk;
+    using SequenceHeader = SequenceStorage::SequenceHeader;
+    using StorageFormat = FolderSequenceStorage::StorageFormat;
 
     /**
-     * Create a SequenceManager to manage sequences that are stored in a given directory.
+     * Create a SequenceManager to manage sequences that are stored in a given directory
+     * (using a FolderSequenceStorage).
      *
-     * \param path  the base folder that contains individual folders for each sequence.
+     * \param path    the base folder that contains individual folders for each sequence.
+     * \param format  the format in which sequences are stored by store_sequence()
      *
      * \exception Error is thrown if the path name is empty.
      */
-    explicit SequenceManager(std::filesystem::path path);
+    explicit SequenceManager(std::filesystem::path path,
+        StorageFormat format = StorageFormat::folder);
 
     /**
-     * Create a copy of an existing sequence (from disk).
+     * Create a SequenceManager to manage the sequences in the given storage backend.
      *
-     * This function loads an existing sequence (identified by its unique ID) from disk,
-     * assigns a new name (new_name) and a new random unique ID to it, and stores the new
-     * sequence in the base folder.
+     * \exception Error is thrown if the storage is null.
+     */
+    explicit SequenceManager(std::shared_ptr<SequenceStorage> storage);
+
+    /**
+     * Create a copy of an existing sequence.
+     *
+     * This function stores a copy of an existing sequence (identified by its unique ID)
+     * with a new name (new_name) and a new random unique ID.
      *
      * \param original_uid  Unique ID of the original sequence
      * \param new_name      Machine-friendly name of the copy
      *
-     * \returns the copied sequence as if it had been loaded from disk.
+     * \returns the copied sequence as if it had been loaded from the storage.
      *
-     * \exception Error is thrown if the original sequence cannot be found or if the new
-     *            sequence folder cannot be created.
+     * \exception Error is thrown if the original sequence cannot be found or if the copy
+     *            cannot be stored.
      */
     Sequence copy_sequence(UniqueId original_uid, const SequenceName& new_name) const;
 
     /**
-     * Create an empty sequence on disk.
+     * Create an empty sequence in the storage.
      *
      * The new sequence contains no steps and has a randomly assigned unique ID.
      *
@@ -102,7 +122,7 @@ public:
      *
      * \returns a new sequence.
      *
-     * \exception Error is thrown if the sequence folder cannot be created.
+     * \exception Error is thrown if the sequence cannot be stored.
      */
     Sequence create_sequence(gul14::string_view label = "",
         SequenceName name = SequenceName{}) const;
@@ -110,30 +130,31 @@ public:
     /**
      * Return the base path of the serialized sequences.
      *
-     * \returns the base path of the serialized sequences.
+     * \returns the base path of the serialized sequences, or an empty path if the storage
+     *          is not a FolderSequenceStorage.
      */
-    std::filesystem::path get_path() const { return path_; }
+    std::filesystem::path get_path() const;
+
+    /// Return the storage backend that holds the sequences.
+    const std::shared_ptr<SequenceStorage>& get_storage() const noexcept
+    {
+        return storage_;
+    }
 
     /**
-     * Return an unsorted list of all valid sequences that are found inside the base path
-     * and rename sequence folders that do not contain a valid unique ID.
+     * Return an unsorted list of all sequences in the storage.
      *
-     * This function examines all folders inside the base path. If any of these folder
-     * names does not contain a valid unique ID, one is randomly generated and the folder
-     * is renamed accordingly.
+     * A FolderSequenceStorage also renames sequence folders that do not contain a valid
+     * unique ID (see FolderSequenceStorage::list_sequences()).
      *
-     * \returns a vector containing one SequenceOnDisk object for each sequence that was
-     *          found. The paths in the returned objects are relative to the base path.
-     *
-     * \exception Error is thrown if one of the folders needs to be renamed but the
-     *            renaming fails.
+     * \exception Error is thrown if the storage cannot be examined.
      */
     std::vector<SequenceOnDisk> list_sequences() const;
 
     /**
-     * Load a sequence from the base folder.
+     * Load a sequence from the storage.
      *
-     * \param unique_id  unique ID of the sequence to be loaded
+     * \param uid  unique ID of the sequence to be loaded
      *
      * \returns the loaded sequence.
      *
@@ -144,8 +165,9 @@ public:
     /**
      * \copydoc load_sequence(UniqueId)
      *
-     * This overload allows to pass in a list of sequences to avoid having to examine the
-     * base path again:
+     * This overload only loads sequences that are contained in the given list, e.g. to
+     * make sure that a sequence that was selected from the list has not been replaced in
+     * the meantime:
      *
      * \param sequences  a list of sequences as obtained from list_sequences()
      */
@@ -153,33 +175,68 @@ public:
     load_sequence(UniqueId uid, const std::vector<SequenceOnDisk>& sequences) const;
 
     /**
-     * Remove a sequence from the base folder.
+     * Load only the metadata of a sequence from the storage.
+     *
+     * This is meant for browsing many sequences; the steps can be loaded later with
+     * load_sequence() when the sequence is actually opened or executed. A
+     * FolderSequenceStorage does not read or parse any step for this.
+     *
+     * \param uid  unique ID of the sequence
+     *
+     * \exception Error is thrown if the sequence cannot be found or read.
+     */
+    SequenceHeader load_sequence_header(UniqueId uid) const;
+
+    /**
+     * Load the metadata of all sequences in the storage.
+     *
+     * \returns an unsorted list with the header of every sequence found by
+     *          list_sequences().
+     *
+     * \exception Error is thrown if one of the sequences cannot be read.
+     * \see load_sequence_header(UniqueId)
+     */
+    std::vector<SequenceHeader> load_sequence_headers() const;
+
+    /**
+     * Load a sequence from the storage and return it as a shared, immutable snapshot.
+     *
+     * A FolderSequenceStorage with an enabled cache returns the same snapshot as long as
+     * the sequence has not been modified (see
+     * FolderSequenceStorage::load_sequence_snapshot()).
+     *
+     * \param uid  unique ID of the sequence to be loaded
+     *
+     * \exception Error is thrown if the sequence cannot be loaded.
+     */
+    std::shared_ptr<const Sequence> load_sequence_snapshot(UniqueId uid) const;
+
+    /**
+     * Remove a sequence from the storage.
      *
      * The sequence to be removed is identified by its unique ID.
      *
      * \param unique_id  the unique ID of the sequence
      *
-     * \exception Error is thrown if the sequence cannot be found or if the removal of
-     *            the folder fails.
+     * \exception Error is thrown if the sequence cannot be found or removed.
      */
     void remove_sequence(UniqueId unique_id) const;
 
     /**
-     * Change the machine-friendly name of a sequence on disk.
+     * Change the machine-friendly name of a stored sequence.
      *
      * The sequence to be renamed is identified by its unique ID.
      *
      * \param unique_id  the unique ID of the sequence
      * \param new_name   the new machine-friendly name of the sequence
      *
-     * \exception Error is thrown if the sequence cannot be found or if the renaming of
-     *            the folder fails.
+     * \exception Error is thrown if the sequence cannot be found or renamed.
      */
     void rename_sequence(UniqueId unique_id, const SequenceName& new_name) const;
 
     /**
-     * Change the machine-friendly name of a sequence, both in a Sequence object and on
-     * disk.
+     * Change the machine-friendly name of a sequence, both in a Sequence object and in
+     * the storage.
      *
      * The sequence to be renamed is identified by the unique ID of the given Sequence
      * object. The Sequence object is updated to reflect the new name.
@@ -187,29 +244,26 @@ public:
      * \param sequence  the sequence to be renamed
      * \param new_name  the new machine-friendly name of the sequence
      *
-     * \exception Error is thrown if the sequence cannot be found or if the renaming of
-     *            the folder fails.
+     * \exception Error is thrown if the sequence cannot be found or renamed.
      */
     void rename_sequence(Sequence& sequence, const SequenceName& new_name) const;
 
     /**
-     * Store the given sequence in a subfolder under the base directory of this object.
+     * Store the given sequence, replacing a previously stored sequence with the same
+     * unique ID and name.
      *
-     * This function generates a subfolder name from the sequence name and unique ID. If
-     * such a subfolder exists already, it is removed. Afterwards, a subfolder is newly
-     * created and the sequence is stored inside it. Inside the folder, each step is
-     * stored in a separate file. The filenames start with `step` followed by a
-     * consecutive number followed by the type of the step and the extension `'.lua'`.
-     * The step number is zero-filled to allow alphanumerical sorting
-     * (e.g. `step_01_action.lua`).
+     * See FolderSequenceStorage::store_sequence() for the way in which sequences are
+     * stored on disk.
      *
      * \param sequence  the sequence to be stored
+     *
+     * \exception Error is thrown if the sequence cannot be stored.
      */
     void store_sequence(const Sequence& sequence) const;
 
 private:
-    /// Base path to the sequences.
-    std::filesystem::path path_;
+    /// The storage backend (never null).
+    std::shared_ptr<SequenceStorage> storage_;
 
     /**
      * Create a random unique ID that does not collide with the ID of any sequence in the
@@ -218,16 +272,6 @@ private:
      * \exception Error is thrown if no unique ID can be found.
      */
     static UniqueId create_unique_id(const std::vector<SequenceOnDisk>& sequences);
-
-    /**
-     * Find the sequence with the given unique ID in the given list of sequences.
-     * \exception Error is thrown if the sequence cannot be found.
-     */
-    static SequenceOnDisk find_sequence_on_disk(UniqueId uid,
-        const std::vector<SequenceOnDisk>& sequences);
-
-    /// Generate a machine-friendly sequence name from a human-readable label.
-    static SequenceName make_sequence_name_from_label(gul14::string_view label);
 };
 
 } // namespace task
@@ -0,0 +1,197 @@
+/**
+ * \file   SequenceStorage.h
+ * \author Lars Fröhlich
+ * \date   Created on October 18, 2026
+ * \brief  Declaration of the SequenceStorage interface.
+ *
+ * \copyright Copyright 2026 Deutsches Elektronen-Synchrotron (DESY), Hamburg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+
+#ifndef TASKOLIB_SEQUENCESTORAGE_H_
+#define TASKOLIB_SEQUENCESTORAGE_H_
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "taskolib/Sequence.h"
+#include "taskolib/SequenceName.h"
+#include "taskolib/Timeout.h"
+#include "taskolib/UniqueId.h"
+
+namespace task {
+
+/**
+ * An abstract interface for a collection of stored sequences, identified by their unique
+ * IDs (a storage backend).
+ *
+ * A SequenceManager performs all of its operations through a storage backend. Two
+ * implementations are available: FolderSequenceStorage stores sequences in folders below
+ * a base directory, and MemorySequenceStorage keeps them in memory. Code that works with
+ * a SequenceManager or directly with this interface can therefore be tested quickly with
+ * the in-memory storage:
+ * \code
+ * SequenceManager manager{ std::make_shared<MemorySequenceStorage>() };
+ * Sequence seq = manager.create_sequence("Test");
+ * \endcode
+ *
+ * Besides the five basic operations (list, load, store, rename, and remove), the
+ * interface has a few operations with a generic implementation in terms of the basic
+ * ones, which a backend can override with a faster one (copy_sequence(),
+ * load_sequence_header(), load_sequence_snapshot()).
+ *
+ * A storage object acts as a handle to the stored sequences, so all operations are const
+ * member functions.
+ */
+class SequenceStorage
+{
+public:
+    /// A struct to represent a stored sequence.
+    struct SequenceOnDisk
+    {
+        /**
+         * Path to the sequence, relative to the base path of the storage. Storages that
+         * do not use a filesystem report the folder name that FolderSequenceStorage would use.
+         */
+        std::filesystem::path path;
+        SequenceName name; ///< Machine-friendly name of the sequence
+        UniqueId unique_id; ///< Unique ID of the sequence
+    };
+
+    /**
+     * The metadata of a stored sequence, without its steps.
+     *
+     * A backend may be able to load a header much faster than the whole sequence (see
+     * load_sequence_header()).
+     */
+    struct SequenceHeader
+    {
+        std::filesystem::path path; ///< Path to the sequence (see SequenceOnDisk::path)
+        SequenceName name; ///< Machine-friendly name of the sequence
+        UniqueId unique_id; ///< Unique ID of the sequence
+        std::string label; ///< Human-readable label of the sequence
+        std::string maintainers; ///< Maintainers of the sequence
+        Timeout timeout; ///< Timeout of the sequence
+        std::size_t num_steps{ 0 }; ///< Number of steps in the sequence
+    };
+
+    /// Virtual destructor.
+    virtual ~SequenceStorage() = default;
+
+    /**
+     * Return an unsorted list of all sequences in the storage.
+     *
+     * \exception Error is thrown if the storage cannot be examined.
+     */
+    virtual std::vector<SequenceOnDisk> list_sequences() const = 0;
+
+    /**
+     * Store a copy of a sequence under a new name and unique ID.
+     *
+     * The generic implementation loads the original sequence and stores it again. The
+     * caller is responsible for choosing a unique ID that is not in use yet.
+     *
+     * \param original_uid  unique ID of the sequence to be copied
+     * \param new_name      machine-friendly name of the copy
+     * \param new_uid       unique ID of the copy
+     *
+     * \exception Error is thrown if the original sequence cannot be found or if the copy
+     *            cannot be stored.
+     */
+    virtual void copy_sequence(UniqueId original_uid, const SequenceName& new_name,
+                               UniqueId new_uid) const;
+
+    /**
+     * Load a sequence from the storage.
+     *
+     * The returned sequence has the same parameters and steps as the stored one, but none
+     * of its execution state.
+     *
+     * \param uid  unique ID of the sequence to be loaded
+     *
+     * \exception Error is thrown if the sequence cannot be found or loaded.
+     */
+    virtual Sequence load_sequence(UniqueId uid) const = 0;
+
+    /**
+     * Load the metadata of a sequence from the storage.
+     *
+     * The generic implementation loads the whole sequence and discards its steps.
+     *
+     * \param uid  unique ID of the sequence
+     *
+     * \exception Error is thrown if the sequence cannot be found or loaded.
+     */
+    virtual SequenceHeader load_sequence_header(UniqueId uid) const;
+
+    /**
+     * Load a sequence from the storage and return it as a shared, immutable snapshot.
+     *
+     * A backend may return the same snapshot for several calls as long as the sequence
+     * has not been modified. The generic implementation loads the sequence every time.
+     *
+     * \param uid  unique ID of the sequence to be loaded
+     *
+     * \exception Error is thrown if the sequence cannot be found or loaded.
+     */
+    virtual std::shared_ptr<const Sequence> load_sequence_snapshot(UniqueId uid) const;
+
+    /**
+     * Remove a sequence from the storage.
+     *
+     * \param unique_id  unique ID of the sequence to be removed
+     *
+     * \exception Error is thrown if the sequence cannot be found or removed.
+     */
+    virtual void remove_sequence(UniqueId unique_id) const = 0;
+
+    /**
+     * Change the machine-friendly name of a stored sequence.
+     *
+     * \param unique_id  unique ID of the sequence to be renamed
+     * \param new_name   new machine-friendly name of the sequence
+     *
+     * \exception Error is thrown if the sequence cannot be found or renamed.
+     */
+    virtual void rename_sequence(UniqueId unique_id, const SequenceName& new_name)
+        const = 0;
+
+    /**
+     * Store a sequence, replacing a previously stored sequence with the same unique ID
+     * and name.
+     *
+     * \param sequence  the sequence to be stored
+     *
+     * \exception Error is thrown if the sequence cannot be stored.
+     */
+    virtual void store_sequence(const Sequence& sequence) const = 0;
+
+protected:
+    SequenceStorage() = default;
+    SequenceStorage(const SequenceStorage&) = default;
+    SequenceStorage(SequenceStorage&&) = default;
+    SequenceStorage& operator=(const SequenceStorage&) = default;
+    SequenceStorage& operator=(SequenceStorage&&) = default;
+};
+
+} // namespace task
+
+#endif
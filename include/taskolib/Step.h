@@ -31,6 +31,7 @@
 
 #include "taskolib/CommChannel.h"
 #include "taskolib/Context.h"
+#include "taskolib/StepStatistics.h"
 #include "taskolib/time_types.h"
 #include "taskolib/Timeout.h"
 #include "taskolib/TimeoutTrigger.h"
@@ -74,13 +75,14 @@ public:
      *
      * This function performs the following steps:
      * 1. A fresh script runtime environment is prepared and safe library components are
-     *    loaded into it.
+     *    loaded into it. The shared constants from the context are made available.
      * 2. The step_setup_function from the context is run if it is defined (non-null).
      * 3. The step setup script is run.
-     * 4. Selected variables are imported from the context into the runtime environment.
+     * 4. Selected variables are imported from the context into the runtime environment
+     *    (or prepared for import on first access, see Context::variable_import_mode).
      * 5. The script from the step is loaded into the runtime environment and executed.
      * 6. Selected variables are exported from the runtime environment back into the
-     *    context.
+     *    context, if their value has changed.
      *
      * Certain step types (IF, ELSEIF, WHILE) require the script to return a boolean
      * value. Not returning a value or returning a different type is considered an error.
@@ -93,10 +95,16 @@ public:
      *                      Otherwise, termination requests are honored and the queue
      *                      receives the following messages:
      *                      - A message of type step_started when the step is started
+     *                      - A message of type context_variables_changed after the
+     *                        variables have been exported, if any of them has been
+     *                        modified
      *                      - A message of type step_stopped when the step has finished
      *                        successfully
      *                      - A message of type step_stopped_with_error when the step has
      *                        been stopped due to an error condition
+     *                      The latter two messages carry the Lua VM counters of this
+     *                      execution, which are also added to the cumulative statistics
+     *                      of the step (see get_statistics()).
      * \param opt_step_index  Optional index of the step in its parent Sequence (to be
      *                        used in exceptions and messages)
      * \param sequence_timeout Pointer to a sequence timeout to determine a timeout during
@@ -170,6 +178,13 @@ public:
      */
     const std::string& get_script() const { return script_; }
 
+    /**
+     * Return the Lua VM counters accumulated over all executions of this step.
+     *
+     * \see StepStatistics
+     */
+    const StepStatistics& get_statistics() const noexcept { return statistics_; }
+
     /**
      * Return the timestamp of the last execution of this step's script.
      * A default-constructed `TimePoint{}` is returned to indicate that the object was
@@ -236,6 +251,20 @@ public:
      */
     Step& set_script(const std::string& script);
 
+    /**
+     * Set the script that should be executed when this step is run (by moving).
+     * Syntax or semantics of the script are not checked.
+     */
+    Step& set_script(std::string&& script);
+
+    /**
+     * Set the accumulated Lua VM counters of this step.
+     *
+     * This is normally done by an Executor, or to reset the counters with
+     * `set_statistics(StepStatistics{})`.
+     */
+    Step& set_statistics(const StepStatistics& statistics);
+
     /**
      * Set the timestamp of the last execution of this step's script.
      * This function should be called when an external execution engine starts the
@@ -270,6 +299,7 @@ private:
     TimePoint time_of_last_modification_{ Clock::now() };
     TimePoint time_of_last_execution_;
     Timeout timeout_;
+    StepStatistics statistics_;
     Type type_{ type_action };
     short indentation_level_{ 0 };
     bool is_running_{ false };
@@ -278,21 +308,37 @@ private:
     /**
      * Copy the variables listed in used_context_variable_names_ from the given Context
      * into a Lua state.
+     *
+     * \returns the number of imported variables.
      */
-    void copy_used_variables_from_context_to_lua(const Context& context, sol::state& lua);
+    std::uint64_t copy_used_variables_from_context_to_lua(const Context& context,
+                                                          sol::state& lua);
 
     /**
-     * Copy the variables listed in used_context_variable_names_ from a Lua state into the
-     * given Context.
+     * Copy the given variables (normally all of used_context_variable_names_, or only the
+     * accessed ones after a lazy import) from a Lua state into the given Context.
+     *
+     * Variables that still hold the same value (and type) as in the context are not
+     * written back.
+     *
+     * \returns a list of the variables whose value has actually changed (or that have been
+     *          removed from the context).
      */
-    void copy_used_variables_from_lua_to_context(const sol::state& lua, Context& context);
+    VariableChanges copy_used_variables_from_lua_to_context(const VariableNames& varnames,
+                                                            const sol::state& lua,
+                                                            Context& context);
 
     /**
      * Execute the Lua script, throwing an exception if anything goes wrong.
+     *
+     * The Lua VM counters of the execution are stored in the statistics parameter, even
+     * if an exception is thrown.
+     *
      * \see execute(Context&, CommChannel*, OptionalStepIndex, TimeoutTrigger*)
      */
     bool execute_impl(Context& context, CommChannel* comm_channel
-        , OptionalStepIndex index, TimeoutTrigger* sequence_timeout);
+        , OptionalStepIndex index, TimeoutTrigger* sequence_timeout
+        , StepStatistics& statistics);
 };
 
 /// Alias for a step type collection that executes a script.
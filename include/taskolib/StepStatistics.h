@@ -0,0 +1,112 @@
+/**
+ * \file   StepStatistics.h
+ * \author Lars Fröhlich
+ * \date   Created on October 18, 2026
+ * \brief  Declaration of the StepStatistics struct.
+ *
+ * \copyright Copyright 2026 Deutsches Elektronen-Synchrotron (DESY), Hamburg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#ifndef TASKOLIB_STEPSTATISTICS_H_
+#define TASKOLIB_STEPSTATISTICS_H_
+
+#include <algorithm>
+#include <cstdint>
+
+namespace task {
+
+/**
+ * Counters describing the work done by the Lua virtual machine while executing a step.
+ *
+ * The VM counters cover the step setup script and the step script itself. They are
+ * collected in the debug hook that checks for timeouts, so the instruction count has the
+ * resolution of the hook interval (normally 100 instructions) and the stack depth is
+ * sampled at the same rate.
+ *
+ * A Message of type step_stopped or step_stopped_with_error carries the statistics of a
+ * single execution, while a Step accumulates them over all of its executions.
+ */
+struct StepStatistics
+{
+    /// Number of Lua VM instructions executed (approximate, see above)
+    std::uint64_t num_instructions{ 0 };
+
+    /// Number of invocations of the instruction count hook
+    std::uint64_t num_hook_calls{ 0 };
+
+    /// Number of completed garbage collection cycles
+    std::uint64_t num_gc_cycles{ 0 };
+
+    /// Number of bytes allocated by the Lua state (frees are not subtracted)
+    std::uint64_t bytes_allocated{ 0 };
+
+    /// Maximum depth of the Lua call stack that was observed
+    std::uint64_t peak_stack_depth{ 0 };
+
+    /**
+     * Number of context variables that were copied into the Lua state. With a lazy
+     * import, only the variables that the script has actually read are counted.
+     */
+    std::uint64_t num_imported_variables{ 0 };
+
+    /**
+     * Number of context variables that were written back (modified or removed) after
+     * the script had finished. Unmodified variables are not exported and not counted.
+     */
+    std::uint64_t num_exported_variables{ 0 };
+
+    /**
+     * Add the counters from another StepStatistics object to this one.
+     *
+     * All counters are summed up, except for the peak stack depth, for which the maximum
+     * is taken.
+     */
+    StepStatistics& operator+=(const StepStatistics& other) noexcept
+    {
+        num_instructions += other.num_instructions;
+        num_hook_calls += other.num_hook_calls;
+        num_gc_cycles += other.num_gc_cycles;
+        bytes_allocated += other.bytes_allocated;
+        peak_stack_depth = std::max(peak_stack_depth, other.peak_stack_depth);
+        num_imported_variables += other.num_imported_variables;
+        num_exported_variables += other.num_exported_variables;
+        return *this;
+    }
+
+    /// Determine if two StepStatistics objects hold the same counter values.
+    friend bool operator==(const StepStatistics& a, const StepStatistics& b) noexcept
+    {
+        return a.num_instructions == b.num_instructions
+            && a.num_hook_calls == b.num_hook_calls
+            && a.num_gc_cycles == b.num_gc_cycles
+            && a.bytes_allocated == b.bytes_allocated
+            && a.peak_stack_depth == b.peak_stack_depth
+            && a.num_imported_variables == b.num_imported_variables
+            && a.num_exported_variables == b.num_exported_variables;
+    }
+
+    /// Determine if two StepStatistics objects hold different counter values.
+    friend bool operator!=(const StepStatistics& a, const StepStatistics& b) noexcept
+    {
+        return !(a == b);
+    }
+};
+
+} // namespace task
+
+#endif
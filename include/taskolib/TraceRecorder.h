@@ -0,0 +1,148 @@
+/**
+ * \file   TraceRecorder.h
+ * \author Lars Fröhlich
+ * \date   Created on October 18, 2026
+ * \brief  Declaration of the TraceRecorder class.
+ *
+ * \copyright Copyright 2026 Deutsches Elektronen-Synchrotron (DESY), Hamburg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#ifndef TASKOLIB_TRACERECORDER_H_
+#define TASKOLIB_TRACERECORDER_H_
+
+#include <string>
+#include <vector>
+
+#include <gul14/string_view.h>
+
+#include "taskolib/Message.h"
+#include "taskolib/Sequence.h"
+#include "taskolib/StepIndex.h"
+#include "taskolib/time_types.h"
+
+namespace task {
+
+/**
+ * A recorder that turns the messages of a running sequence into a timeline in the Trace
+ * Event Format, which can be displayed by viewers such as Perfetto or chrome://tracing.
+ *
+ * The recorder is constructed from the sequence that is going to be executed so that it
+ * knows the structure of the sequence. All messages of the execution have to be passed to
+ * record(), typically from the message callback of the Context:
+ * \code
+ * TraceRecorder recorder{ sequence };
+ *
+ * Context context;
+ * context.message_callback_function =
+ *     [&recorder](const Message& msg) { recorder.record(msg); };
+ *
+ * Executor executor;
+ * executor.run_asynchronously(sequence, context);
+ * while (executor.update(sequence))
+ *     gul14::sleep(0.1);
+ *
+ * std::ofstream("trace.json") << recorder.get_json();
+ * \endcode
+ *
+ * The following duration events are generated, nested into each other as in the
+ * sequence:
+ * - One event for the sequence run (or single-step execution)
+ * - One event for each WHILE loop and one for each of its iterations (the iteration
+ *   covers the steps in the loop body, but not the evaluation of the loop condition)
+ * - One event for each TRY block and, if an error was caught, one for the CATCH block
+ * - One event for each executed step
+ *
+ * Output from print() and error messages are recorded as instant events. All timestamps
+ * are taken from the messages.
+ *
+ * \note This class is not thread-safe. Messages are normally processed on the main thread
+ *       only, so no synchronization is required.
+ */
+class TraceRecorder
+{
+public:
+    /**
+     * Construct a recorder for the given sequence.
+     *
+     * Only the structure of the sequence (step types, labels, and nesting) is examined
+     * during construction; the recorder does not keep a reference to the sequence.
+     */
+    explicit TraceRecorder(const Sequence& sequence);
+
+    /// Discard all events recorded so far.
+    void clear();
+
+    /**
+     * Return the recorded events as a JSON document in the Trace Event Format.
+     *
+     * The document is a JSON object with a "traceEvents" array. Duration events that are
+     * still open (e.g. because the sequence is still running) are not closed
+     * automatically.
+     */
+    std::string get_json() const;
+
+    /// Return the number of trace events recorded so far.
+    std::size_t get_num_events() const noexcept { return events_.size(); }
+
+    /// Process a message from the execution of the sequence.
+    void record(const Message& msg);
+
+private:
+    enum class BlockType { while_loop, while_iteration, try_block, catch_block };
+
+    /// A block of steps that is represented as a nested duration event.
+    struct Block
+    {
+        BlockType type;
+        StepIndex head_index; ///< Index of the WHILE, TRY, or CATCH step
+        std::string label; ///< Label of the head step
+        unsigned int num_iterations{ 0 }; ///< Iteration counter (for while_iteration)
+    };
+
+    /// Event names (labels or, if empty, "Step <index>") and types of all steps
+    std::vector<std::pair<std::string, Step::Type>> steps_;
+
+    /// All blocks in the sequence
+    std::vector<Block> blocks_;
+
+    /// For each step, the indices of all enclosing blocks from the outermost one inward
+    std::vector<std::vector<std::size_t>> enclosing_blocks_;
+
+    /// Indices of the blocks that currently have an open duration event
+    std::vector<std::size_t> open_blocks_;
+
+    /// Name of the sequence event if one is open, empty otherwise
+    std::string open_sequence_name_;
+
+    /// Index of the step with an open duration event, if any
+    OptionalStepIndex open_step_;
+
+    /// Recorded events, each one a complete JSON object
+    std::vector<std::string> events_;
+
+    /// Emit events to close and open blocks until exactly the given blocks are open.
+    void transition_to(const std::vector<std::size_t>& blocks, TimePoint t);
+
+    /// Add a trace event.
+    void add_event(char phase, gul14::string_view name, gul14::string_view category,
+                   TimePoint t, gul14::string_view args = {});
+};
+
+} // namespace task
+
+#endif
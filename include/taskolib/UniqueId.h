@@ -2,9 +2,10 @@
  * \file   UniqueId.h
  * \author Lars Fröhlich
  * \date   Created on July 26, 2023
- * \brief  Declaration of the UniqueId class.
+ * \brief  Declaration of the UniqueId class and of an associated specialization of
+ *         std::hash.
  *
- * \copyright Copyright 2023 Deutsches Elektronen-Synchrotron (DESY), Hamburg
+ * \copyright Copyright 2023-2026 Deutsches Elektronen-Synchrotron (DESY), Hamburg
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU Lesser General Public License as published
@@ -25,6 +26,7 @@
 #ifndef TASKOLIB_UNIQUEID_H_
 #define TASKOLIB_UNIQUEID_H_
 
+#include <functional>
 #include <random>
 #include <string>
 
@@ -72,6 +74,8 @@ public:
     friend std::string to_string(UniqueId uid);
 
 private:
+    friend struct std::hash<UniqueId>;
+
     static thread_local std::mt19937_64 random_number_generator_;
 
     ValueType id_;
@@ -90,4 +94,19 @@ inline ::task::UniqueId operator""_uid(unsigned long long id)
 
 } // namespace task
 
+
+namespace std {
+
+/// Custom specialization of std::hash for UniqueId
+template<>
+struct hash<task::UniqueId>
+{
+    std::size_t operator()(task::UniqueId uid) const noexcept
+    {
+        return std::hash<task::UniqueId::ValueType>{}(uid.id_);
+    }
+};
+
+} // namespace std
+
 #endif
@@ -5,7 +5,7 @@
  * \brief  Declaration of the VariableName class and of an associated specialization of
  *         std::hash.
  *
- * \copyright Copyright 2022 Deutsches Elektronen-Synchrotron (DESY), Hamburg
+ * \copyright Copyright 2022-2026 Deutsches Elektronen-Synchrotron (DESY), Hamburg
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU Lesser General Public License as published
@@ -26,6 +26,7 @@
 #ifndef TASKOLIB_VARIABLENAME_H_
 #define TASKOLIB_VARIABLENAME_H_
 
+#include <cstdint>
 #include <functional>
 #include <string>
 #include <gul14/string_view.h>
@@ -39,6 +40,23 @@ namespace task {
  * Basically, a variable name may only contain alphanumeric characters plus the underscore
  * ("_"). It must start with a letter. Variable names are case sensitive and may not be
  * more than 64 characters long.
+ *
+ * Variable names are interned: All distinct names are stored once in a process-wide
+ * table, and a VariableName object only refers to its table entry. A name is validated
+ * only when it is added to the table. Each entry has a unique 32-bit symbol and a
+ * precomputed hash, so copying, hashing, and equality comparisons are cheap integer
+ * operations. The relational operators still order names lexicographically, so sets of
+ * variable names keep a stable, human-readable order.
+ *
+ * Looking up a name that the calling thread has used before takes no lock, because each
+ * thread keeps a cache of the entries it has seen. Only the first use of a name in a
+ * thread locks the process-wide table.
+ *
+ * Entries are never removed from the table, so its memory grows with the number of
+ * distinct names used during the lifetime of the process. Each entry costs roughly the
+ * length of the name plus 80 bytes, and each thread cache adds about 40 bytes per name it
+ * has seen. This is negligible for the names found in sequences, but programs should
+ * not create an unbounded number of distinct names, e.g. from counters or user input.
  */
 class VariableName
 {
@@ -64,31 +82,43 @@ public:
     explicit VariableName(const std::string& name);
     explicit VariableName(std::string&& name);
 
+    /// Return the precomputed hash value of the variable name.
+    std::size_t get_hash() const noexcept { return entry_->hash; }
+
+    /**
+     * Return the unique symbol of the variable name.
+     *
+     * Two VariableName objects have the same symbol if and only if they hold the same
+     * name. Symbols are assigned in the order in which names are first used in the
+     * process, so they must not be stored or transmitted.
+     */
+    std::uint32_t get_symbol() const noexcept { return entry_->symbol; }
+
     /// Return the length of the variable name string.
-    SizeType length() const noexcept { return name_.size(); }
+    SizeType length() const noexcept { return entry_->name.size(); }
 
     /// Determine if two variable names are identical.
     friend bool operator==(const VariableName& a, const VariableName& b) noexcept
     {
-        return a.string() == b.string();
+        return a.entry_ == b.entry_;
     }
 
     /// Determine if two variable names differ.
     friend bool operator!=(const VariableName& a, const VariableName& b) noexcept
     {
-        return a.string() != b.string();
+        return a.entry_ != b.entry_;
     }
 
     /// Determine if the left variable name is lexicographically less than the right one.
     friend bool operator<(const VariableName& a, const VariableName& b) noexcept
     {
-        return a.string() < b.string();
+        return a.entry_ != b.entry_ && a.string() < b.string();
     }
 
     /// Determine if the left variable name is lexicographically greater than the right one.
     friend bool operator>(const VariableName& a, const VariableName& b) noexcept
     {
-        return a.string() > b.string();
+        return a.entry_ != b.entry_ && a.string() > b.string();
     }
 
     /**
@@ -97,7 +127,7 @@ public:
      */
     friend bool operator<=(const VariableName& a, const VariableName& b) noexcept
     {
-        return a.string() <= b.string();
+        return a.entry_ == b.entry_ || a.string() < b.string();
     }
 
     /**
@@ -106,7 +136,7 @@ public:
      */
     friend bool operator>=(const VariableName& a, const VariableName& b) noexcept
     {
-        return a.string() >= b.string();
+        return a.entry_ == b.entry_ || a.string() > b.string();
     }
 
     /**
@@ -136,16 +166,32 @@ public:
     }
 
     /// Convert the VariableName to a std::string.
-    explicit operator const std::string&() const { return name_; }
+    explicit operator const std::string&() const { return entry_->name; }
 
     /// Return the length of the variable name string.
-    SizeType size() const noexcept { return name_.size(); }
+    SizeType size() const noexcept { return entry_->name.size(); }
 
-    /// Return a const reference to the internal string member.
-    const std::string& string() const noexcept { return name_; }
+    /// Return a const reference to the interned name string.
+    const std::string& string() const noexcept { return entry_->name; }
 
 private:
-    std::string name_;
+    /// An entry in the intern table.
+    struct Entry
+    {
+        std::string name;
+        std::size_t hash;
+        std::uint32_t symbol;
+    };
+
+    const Entry* entry_;
+
+    /**
+     * Look up a name in the intern table, adding it if necessary.
+     *
+     * \exception Error is thrown if the name is not yet in the table and is not a valid
+     *            variable name.
+     */
+    static const Entry* intern(gul14::string_view name);
 };
 
 } // namespace task
@@ -159,7 +205,7 @@ struct hash<task::VariableName>
 {
     std::size_t operator()(const task::VariableName& name) const noexcept
     {
-        return std::hash<std::string>{}(name.string());
+        return name.get_hash();
     }
 };
 
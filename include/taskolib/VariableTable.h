@@ -0,0 +1,325 @@
+/**
+ * \file   VariableTable.h
+ * \author Lars Fröhlich
+ * \date   Created on October 18, 2026
+ * \brief  Declaration of the VariableTable class and of the VariableValue and
+ *         VariableChanges types.
+ *
+ * \copyright Copyright 2021-2026 Deutsches Elektronen-Synchrotron (DESY), Hamburg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#ifndef TASKOLIB_VARIABLETABLE_H_
+#define TASKOLIB_VARIABLETABLE_H_
+
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <gul14/optional.h>
+
+#include "taskolib/Bytes.h"
+#include "taskolib/NumericArray.h"
+#include "taskolib/VariableName.h"
+
+namespace task {
+
+/**
+ * The types available to forward variables from one Step to the next.
+ */
+using VarInteger = long long; ///< Storage type for integral numbers
+using VarFloat = double; ///< Storage type for floatingpoint number
+using VarString = std::string; ///< Storage type for strings
+using VarBool = bool; ///< Storage type for booleans
+using VarFloatArray = NumericArray<VarFloat>; ///< Storage type for arrays of floats
+using VarIntArray = NumericArray<VarInteger>; ///< Storage type for arrays of integers
+using VarBytes = Bytes; ///< Storage type for immutable binary data
+
+/**
+ * A VariableValue is a variant over all Variable types.
+ *
+ * Variable names are associated with these values via a map in the Context class.
+ *
+ * Arrays (VarFloatArray, VarIntArray) and binary data (VarBytes) share their storage
+ * between copies, so passing them between steps does not copy their elements.
+ *
+ * Be careful when assigning a string to a VariableValue:
+ * Do not use a char* to pass the string, it might be converted to bool instead
+ * of the expected std::string. The conversion depends on the used compiler (version).
+ */
+using VariableValue = std::variant<
+    VarInteger,
+    VarFloat,
+    VarString,
+    VarBool,
+    VarFloatArray,
+    VarIntArray,
+    VarBytes>;
+
+/**
+ * Associative table that holds Lua variable names and their value.
+ *
+ * The keys are of type \a VariableName and the values \a VariableValue. The interface
+ * follows the one of std::unordered_map (for the subset of functions that are needed by
+ * Taskolib), but the entries are stored in a single contiguous array that is sorted by
+ * the symbols of the variable names (see VariableName::get_symbol()). Lookups are
+ * therefore a binary search over integers.
+ *
+ * <h3>Implicit sharing</h3>
+ *
+ * Copies of a VariableTable share their entries until one of them is modified (copy on
+ * write). Copying or moving a table, e.g. when a Context is handed to an Executor, is
+ * therefore only a pointer operation. Read access through a const table (at(), count(),
+ * and the const overloads of find(), begin(), and end()) never copies the entries. The
+ * shared entries are cloned by the modifying member functions (operator[], emplace(),
+ * insert_or_assign(), erase(), and reserve()) and by the non-const overloads of find(),
+ * begin(), and end(), which return iterators that allow modifying the values. Use
+ * std::as_const() or cbegin()/cend() for read-only access to a non-const table. Array
+ * values (VarFloatArray, VarIntArray) and binary data (VarBytes) share their storage
+ * even when the entries are cloned, so only strings are duplicated.
+ *
+ * The entries are owned by a shared pointer, and a modifying call only writes to them if
+ * this table holds the only reference. Different tables that share their entries may
+ * therefore be used from different threads. A single table must not be modified
+ * concurrently.
+ *
+ * As with std::unordered_map, the iteration order is unspecified and the key of an
+ * element is const (value_type is std::pair<const VariableName, VariableValue>). Unlike
+ * with std::unordered_map, inserting or erasing an element invalidates all iterators,
+ * pointers, and references into the table, and so does the first modifying access to a
+ * table with shared entries.
+ */
+class VariableTable
+{
+    /// A stored name-value pair. The name is not const, so the entries can be shifted.
+    using Entry = std::pair<VariableName, VariableValue>;
+    using Entries = std::vector<Entry>;
+
+    /**
+     * Bidirectional iterator over the elements of a VariableTable.
+     *
+     * The stored entries have a non-const key, but the iterator presents each of them
+     * as a value_type (std::pair<const VariableName, VariableValue>), so the key of an
+     * element cannot be modified. A mutable iterator (is_const == false) allows modifying
+     * the value and converts implicitly into a const_iterator.
+     */
+    template <bool is_const>
+    class Iterator
+    {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = std::pair<const VariableName, VariableValue>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<is_const, const value_type*, value_type*>;
+        using reference = std::conditional_t<is_const, const value_type&, value_type&>;
+
+        Iterator() = default;
+
+        /// Convert a mutable iterator into a const_iterator.
+        template <bool other_is_const,
+                  typename = std::enable_if_t<is_const && not other_is_const>>
+        Iterator(const Iterator<other_is_const>& other) noexcept : it_{ other.it_ }
+        {}
+
+        reference operator*() const noexcept
+        {
+            // std::pair<VariableName, VariableValue> and value_type differ only in the
+            // constness of the key, so they have the same layout.
+            return reinterpret_cast<reference>(*it_);
+        }
+
+        pointer operator->() const noexcept { return &**this; }
+
+        Iterator& operator++() noexcept { ++it_; return *this; }
+        Iterator operator++(int) noexcept { return Iterator{ it_++ }; }
+        Iterator& operator--() noexcept { --it_; return *this; }
+        Iterator operator--(int) noexcept { return Iterator{ it_-- }; }
+
+        friend bool operator==(const Iterator& a, const Iterator& b) noexcept
+        {
+            return a.it_ == b.it_;
+        }
+
+        friend bool operator!=(const Iterator& a, const Iterator& b) noexcept
+        {
+            return a.it_ != b.it_;
+        }
+
+    private:
+        friend class VariableTable;
+        friend class Iterator<not is_const>;
+
+        using EntryIterator =
+            std::conditional_t<is_const, Entries::const_iterator, Entries::iterator>;
+
+        static_assert(sizeof(Entry) == sizeof(value_type)
+                      && alignof(Entry) == alignof(value_type));
+
+        EntryIterator it_{};
+
+        explicit Iterator(EntryIterator it) noexcept : it_{ it } {}
+    };
+
+public:
+    using key_type = VariableName;
+    using mapped_type = VariableValue;
+    using value_type = std::pair<const VariableName, VariableValue>;
+    using size_type = std::size_t;
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    /// Construct an empty table.
+    VariableTable() = default;
+
+    /// Construct a table from a list of name-value pairs (later duplicates are ignored).
+    VariableTable(std::initializer_list<value_type> init);
+
+    /**
+     * Return a const reference to the value of the variable with the given name.
+     * \exception std::out_of_range is thrown if there is no such variable.
+     */
+    const VariableValue& at(const VariableName& name) const;
+
+    /// Return an iterator to the first element (cloning shared entries).
+    iterator begin();
+    const_iterator begin() const noexcept { return const_iterator{ entries().begin() }; }
+    const_iterator cbegin() const noexcept { return begin(); }
+
+    /// Return an iterator past the last element (cloning shared entries).
+    iterator end();
+    const_iterator end() const noexcept { return const_iterator{ entries().end() }; }
+    const_iterator cend() const noexcept { return end(); }
+
+    /// Remove all variables from the table.
+    void clear() noexcept { entries_.reset(); }
+
+    /// Return the number of variables with the given name (0 or 1).
+    size_type count(const VariableName& name) const
+    {
+        return find(name) != cend();
+    }
+
+    /**
+     * Insert a variable if there is none with the same name yet.
+     *
+     * \returns a pair of an iterator to the variable with the given name and a boolean
+     *          that is true if the variable was inserted.
+     */
+    std::pair<iterator, bool> emplace(const VariableName& name, VariableValue value);
+
+    /// Determine if the table is empty.
+    bool empty() const noexcept { return size() == 0; }
+
+    /**
+     * Remove the variable with the given name, if it exists.
+     * \returns the number of removed elements (0 or 1).
+     */
+    size_type erase(const VariableName& name);
+
+    /**
+     * Remove the element at the given position.
+     * \returns an iterator to the element that followed the removed one.
+     */
+    iterator erase(const_iterator pos);
+
+    /**
+     * Return an iterator to the variable with the given name or end() if there is none.
+     * The non-const overload clones shared entries.
+     */
+    iterator find(const VariableName& name);
+    const_iterator find(const VariableName& name) const;
+
+    /**
+     * Assign a value to the variable with the given name, inserting it if necessary.
+     *
+     * \returns a pair of an iterator to the variable and a boolean that is true if the
+     *          variable was inserted.
+     */
+    std::pair<iterator, bool> insert_or_assign(const VariableName& name,
+                                               VariableValue value);
+
+    /// Reserve memory for the given number of variables.
+    void reserve(size_type num_variables) { mutable_entries().reserve(num_variables); }
+
+    /// Determine if this table currently shares its entries with another one.
+    bool shares_storage_with(const VariableTable& other) const noexcept
+    {
+        return entries_ != nullptr && entries_ == other.entries_;
+    }
+
+    /// Return the number of variables in the table.
+    size_type size() const noexcept { return entries_ ? entries_->size() : 0; }
+
+    /**
+     * Return a reference to the value of the variable with the given name.
+     *
+     * If there is no such variable yet, it is inserted with a default-constructed value
+     * (VarInteger{ 0 }).
+     */
+    VariableValue& operator[](const VariableName& name);
+
+    /// Determine if two tables contain the same variables with the same values.
+    friend bool operator==(const VariableTable& a, const VariableTable& b)
+    {
+        return a.entries_ == b.entries_ || a.entries() == b.entries();
+    }
+
+    /// Determine if two tables differ in their variables or values.
+    friend bool operator!=(const VariableTable& a, const VariableTable& b)
+    {
+        return !(a == b);
+    }
+
+private:
+    /// Name-value pairs, sorted by the symbols of the names (null for an empty table).
+    std::shared_ptr<Entries> entries_;
+
+    /// Return the entries for read access.
+    const Entries& entries() const noexcept;
+
+    /// Return the entries for write access, cloning them first if they are shared.
+    Entries& mutable_entries();
+};
+
+/**
+ * A list of modifications to a VariableTable.
+ *
+ * Each entry associates a variable name with its new value. An empty optional means that
+ * the variable has been removed from the table.
+ *
+ * \see apply_variable_changes()
+ */
+using VariableChanges =
+    std::vector<std::pair<VariableName, gul14::optional<VariableValue>>>;
+
+/**
+ * Apply a list of changes to a variable table.
+ *
+ * The changes are applied in order, so a later entry for the same variable overrides an
+ * earlier one.
+ */
+void apply_variable_changes(VariableTable& variables, const VariableChanges& changes);
+
+} // namespace task
+
+#endif
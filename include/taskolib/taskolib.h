@@ -25,16 +25,26 @@
 #ifndef TASKOLIB_TASKOLIB_H_
 #define TASKOLIB_TASKOLIB_H_
 
+#include "taskolib/Blackboard.h"
+#include "taskolib/Bytes.h"
+#include "taskolib/ConstantTable.h"
 #include "taskolib/Context.h"
 #include "taskolib/exceptions.h"
 #include "taskolib/execute_lua_script.h"
 #include "taskolib/Executor.h"
+#include "taskolib/FolderSequenceStorage.h"
+#include "taskolib/MemorySequenceStorage.h"
+#include "taskolib/NumericArray.h"
+#include "taskolib/Profiler.h"
 #include "taskolib/Sequence.h"
 #include "taskolib/SequenceManager.h"
+#include "taskolib/SequenceStorage.h"
 #include "taskolib/Step.h"
 #include "taskolib/time_types.h"
 #include "taskolib/Timeout.h"
+#include "taskolib/TraceRecorder.h"
 #include "taskolib/VariableName.h"
+#include "taskolib/VariableTable.h"
 
 /// Namespace task contains all Taskolib functions and classes.
 namespace task { }
@@ -0,0 +1,445 @@
+/**
+ * \file   Blackboard.cc
+ * \author Lars Fröhlich
+ * \date   Created on October 18, 2026
+ * \brief  Implementation of the Blackboard class.
+ *
+ * \copyright Copyright 2026 Deutsches Elektronen-Synchrotron (DESY), Hamburg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include <gul14/cat.h>
+
+#include "taskolib/Blackboard.h"
+#include "taskolib/exceptions.h"
+
+using gul14::cat;
+
+namespace task {
+
+namespace {
+
+const Blackboard::Entry empty_entry{};
+
+// A hazard pointer: While a thread reads a record, it publishes the record's address in
+// its own HazardRecord, and no writer deletes a record that is published there. The
+// records form a process-wide, grow-only list that is shared by all blackboards. Each
+// thread takes over a free record on first use and hands it back on exit.
+struct HazardRecord
+{
+    std::atomic<const void*> ptr{ nullptr };
+    std::atomic<bool> active{ false };
+    HazardRecord* next{ nullptr };
+};
+
+std::atomic<HazardRecord*> hazard_list{ nullptr };
+std::atomic<std::size_t> num_hazard_records{ 0 };
+
+HazardRecord* acquire_hazard_record()
+{
+    for (auto* rec = hazard_list.load(std::memory_order_acquire); rec; rec = rec->next)
+    {
+        bool expected = false;
+        if (not rec->active.load(std::memory_order_relaxed)
+            && rec->active.compare_exchange_strong(expected, true,
+                   std::memory_order_acq_rel))
+        {
+            return rec;
+        }
+    }
+
+    // All records are in use: Add a new one. Records are never freed.
+    auto* rec = new HazardRecord;
+    rec->active.store(true, std::memory_order_relaxed);
+    rec->next = hazard_list.load(std::memory_order_relaxed);
+    while (not hazard_list.compare_exchange_weak(rec->next, rec,
+                   std::memory_order_release, std::memory_order_relaxed))
+    {}
+    num_hazard_records.fetch_add(1, std::memory_order_relaxed);
+    return rec;
+}
+
+void release_hazard_record(HazardRecord* rec) noexcept
+{
+    rec->ptr.store(nullptr, std::memory_order_release);
+    rec->active.store(false, std::memory_order_release);
+}
+
+// Set when the hazard record of the current thread has been handed back at thread exit.
+thread_local bool thread_hazard_released = false;
+
+// Protects one record pointer for the lifetime of the object.
+class HazardGuard
+{
+public:
+    HazardGuard()
+    {
+        struct ThreadHazard
+        {
+            HazardRecord* rec = acquire_hazard_record();
+            ~ThreadHazard()
+            {
+                release_hazard_record(rec);
+                thread_hazard_released = true;
+            }
+        };
+
+        if (thread_hazard_released) // during thread exit: use a temporary record
+        {
+            rec_ = acquire_hazard_record();
+            owns_rec_ = true;
+        }
+        else
+        {
+            thread_local ThreadHazard thread_hazard;
+            rec_ = thread_hazard.rec;
+        }
+    }
+
+    ~HazardGuard()
+    {
+        if (owns_rec_)
+            release_hazard_record(rec_);
+        else
+            rec_->ptr.store(nullptr, std::memory_order_release);
+    }
+
+    HazardGuard(const HazardGuard&) = delete;
+    HazardGuard& operator=(const HazardGuard&) = delete;
+
+    // Load the pointer from the slot and protect it, so that it stays valid until the
+    // guard is destroyed or protect() is called again.
+    template <typename T>
+    const T* protect(const std::atomic<const T*>& slot)
+    {
+        const T* ptr = slot.load(std::memory_order_relaxed);
+        while (true)
+        {
+            rec_->ptr.store(ptr, std::memory_order_seq_cst);
+            const T* current = slot.load(std::memory_order_seq_cst);
+            if (current == ptr)
+                return ptr;
+            ptr = current;
+        }
+    }
+
+private:
+    HazardRecord* rec_{ nullptr };
+    bool owns_rec_{ false };
+};
+
+// Return the addresses that are currently protected by any thread, sorted.
+std::vector<const void*> get_hazard_pointers()
+{
+    std::vector<const void*> result;
+    result.reserve(num_hazard_records.load(std::memory_order_relaxed));
+
+    for (auto* rec = hazard_list.load(std::memory_order_acquire); rec; rec = rec->next)
+    {
+        const void* ptr = rec->ptr.load(std::memory_order_seq_cst);
+        if (ptr != nullptr)
+            result.push_back(ptr);
+    }
+
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+} // anonymous namespace
+
+
+Blackboard::Blackboard()
+    : chunks_{ new std::atomic<Chunk*>[max_num_chunks] }
+{
+    for (std::size_t i = 0; i != max_num_chunks; ++i)
+        chunks_[i].store(nullptr, std::memory_order_relaxed);
+}
+
+Blackboard::~Blackboard()
+{
+    // No other thread may access the blackboard anymore, so all records can be deleted.
+    for (const Record* record : retired_)
+        delete record;
+
+    for (std::size_t i = 0; i != max_num_chunks; ++i)
+    {
+        Chunk* chunk = chunks_[i].load(std::memory_order_relaxed);
+        if (chunk == nullptr)
+            continue;
+
+        for (const auto& slot : chunk->slots)
+            delete slot.load(std::memory_order_relaxed);
+
+        delete chunk;
+    }
+}
+
+bool Blackboard::compare_exchange(const VariableName& name,
+                                  const gul14::optional<VariableValue>& expected,
+                                  VariableValue desired)
+{
+    const auto version = update(name,
+        [&expected, &desired](const Entry& current, gul14::optional<VariableValue>& value)
+        {
+            if (current.value != expected)
+                return false;
+            value = desired;
+            return true;
+        });
+
+    return version != 0;
+}
+
+bool Blackboard::erase(const VariableName& name)
+{
+    if (find_slot(name) == nullptr)
+        return false;
+
+    const auto version = update(name,
+        [](const Entry& current, gul14::optional<VariableValue>& value)
+        {
+            if (not current.value)
+                return false;
+            value = gul14::nullopt;
+            return true;
+        });
+
+    return version != 0;
+}
+
+const std::atomic<const Blackboard::Record*>*
+Blackboard::find_slot(const VariableName& name) const
+{
+    const std::size_t symbol = name.get_symbol();
+    const std::size_t chunk_idx = symbol / chunk_size;
+
+    if (chunk_idx >= max_num_chunks)
+        return nullptr;
+
+    const Chunk* chunk = chunks_[chunk_idx].load(std::memory_order_acquire);
+    if (chunk == nullptr)
+        return nullptr;
+
+    return &chunk->slots[symbol % chunk_size];
+}
+
+gul14::optional<VariableValue> Blackboard::get(const VariableName& name) const
+{
+    return load(name).value;
+}
+
+std::atomic<const Blackboard::Record*>*
+Blackboard::get_or_create_slot(const VariableName& name)
+{
+    const std::size_t symbol = name.get_symbol();
+    const std::size_t chunk_idx = symbol / chunk_size;
+
+    if (chunk_idx >= max_num_chunks)
+    {
+        throw Error(cat("Cannot store variable ", name.string(), " on the blackboard: "
+                        "Too many distinct variable names"));
+    }
+
+    Chunk* chunk = chunks_[chunk_idx].load(std::memory_order_acquire);
+    if (chunk == nullptr)
+    {
+        auto new_chunk = std::make_unique<Chunk>();
+        if (chunks_[chunk_idx].compare_exchange_strong(chunk, new_chunk.get(),
+                std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            chunk = new_chunk.release();
+        }
+        // Otherwise, another thread has installed a chunk, which is now in "chunk".
+    }
+
+    return &chunk->slots[symbol % chunk_size];
+}
+
+std::uint64_t Blackboard::get_version(const VariableName& name) const
+{
+    return load(name).version;
+}
+
+Blackboard::Entry Blackboard::load(const VariableName& name) const
+{
+    const auto* slot = find_slot(name);
+    if (slot == nullptr)
+        return empty_entry;
+
+    HazardGuard hazard;
+    const Record* record = hazard.protect(*slot);
+    if (record == nullptr)
+        return empty_entry;
+
+    return *record;
+}
+
+void Blackboard::notify_waiters()
+{
+    // Order the publication of the new record before the check for waiters
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (num_waiters_.load(std::memory_order_seq_cst) == 0)
+        return;
+
+    // Taking the mutex ensures that a waiter cannot miss the notification between
+    // checking the version and starting to wait.
+    {
+        std::lock_guard<std::mutex> lock(wait_mutex_);
+    }
+    wait_cv_.notify_all();
+}
+
+void Blackboard::retire(const Record* record)
+{
+    if (record == nullptr)
+        return;
+
+    std::vector<const Record*> deletable;
+
+    {
+        std::lock_guard<std::mutex> lock(retired_mutex_);
+        retired_.push_back(record);
+
+        // Scanning costs O(threads), so it is only done once enough records have piled
+        // up. This keeps the amortized cost per write constant.
+        const auto threshold = 2 * num_hazard_records.load(std::memory_order_relaxed) + 16;
+        if (retired_.size() < threshold)
+            return;
+
+        const auto hazards = get_hazard_pointers();
+        const auto is_protected = [&hazards](const Record* r)
+            {
+                return std::binary_search(hazards.begin(), hazards.end(),
+                                          static_cast<const void*>(r));
+            };
+
+        const auto it = std::partition(retired_.begin(), retired_.end(), is_protected);
+        deletable.assign(it, retired_.end());
+        retired_.erase(it, retired_.end());
+    }
+
+    for (const Record* r : deletable)
+        delete r;
+}
+
+std::uint64_t Blackboard::set(const VariableName& name, VariableValue value)
+{
+    return update(name,
+        [&value](const Entry&, gul14::optional<VariableValue>& new_value)
+        {
+            new_value = value;
+            return true;
+        });
+}
+
+template <typename UpdateFct>
+std::uint64_t Blackboard::update(const VariableName& name, UpdateFct update_fct)
+{
+    auto* slot = get_or_create_slot(name);
+    HazardGuard hazard;
+
+    while (true)
+    {
+        // The hazard pointer keeps the current record alive while we read it. It also
+        // rules out the ABA problem for the compare-and-swap below: The record cannot be
+        // deleted and its address reused by another record in the meantime.
+        const Record* current = hazard.protect(*slot);
+        const Entry& current_entry = current ? *current : empty_entry;
+
+        gul14::optional<VariableValue> new_value;
+        if (not update_fct(current_entry, new_value))
+            return 0;
+
+        auto new_record = std::make_unique<const Record>(
+            Record{ std::move(new_value), current_entry.version + 1 });
+        const auto new_version = new_record->version;
+
+        if (slot->compare_exchange_strong(current, new_record.get(),
+                                          std::memory_order_seq_cst))
+        {
+            new_record.release();
+            generation_.fetch_add(1, std::memory_order_acq_rel);
+            notify_waiters();
+            retire(current);
+            return new_version;
+        }
+        // Another thread has written a new record; try again.
+    }
+}
+
+std::uint64_t Blackboard::wait_for_any_change(std::uint64_t generation,
+    std::chrono::nanoseconds timeout, const std::atomic<bool>* cancel) const
+{
+    std::uint64_t current = generation;
+
+    wait_until_changed(timeout, cancel,
+        [&]()
+        {
+            current = get_generation();
+            return current != generation;
+        });
+
+    return current;
+}
+
+Blackboard::Entry Blackboard::wait_for_change(const VariableName& name,
+    std::uint64_t version, std::chrono::nanoseconds timeout,
+    const std::atomic<bool>* cancel) const
+{
+    Entry entry;
+
+    wait_until_changed(timeout, cancel,
+        [&]()
+        {
+            entry = load(name);
+            return entry.version != version;
+        });
+
+    return entry;
+}
+
+template <typename Predicate>
+void Blackboard::wait_until_changed(std::chrono::nanoseconds timeout,
+    const std::atomic<bool>* cancel, Predicate predicate) const
+{
+    // Avoid an overflow of the deadline for "infinite" timeouts
+    constexpr std::chrono::nanoseconds max_timeout = std::chrono::hours{ 24 * 365 };
+    const auto deadline = std::chrono::steady_clock::now() + std::min(timeout, max_timeout);
+
+    std::unique_lock<std::mutex> lock(wait_mutex_);
+    ++num_waiters_;
+    wait_cv_.wait_until(lock, deadline,
+        [&]() { return predicate() || (cancel != nullptr && cancel->load()); });
+    --num_waiters_;
+}
+
+void Blackboard::wake_waiters() const
+{
+    // Taking the mutex ensures that a waiter cannot miss the wakeup between checking its
+    // cancel flag and starting to wait.
+    {
+        std::lock_guard<std::mutex> lock(wait_mutex_);
+    }
+    wait_cv_.notify_all();
+}
+
+} // namespace task
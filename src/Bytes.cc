@@ -0,0 +1,47 @@
+/**
+ * \file   Bytes.cc
+ * \author Lars Fröhlich
+ * \date   Created on October 18, 2026
+ * \brief  Implementation of the Bytes class.
+ *
+ * \copyright Copyright 2026 Deutsches Elektronen-Synchrotron (DESY), Hamburg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include <algorithm>
+
+#include <gul14/cat.h>
+
+#include "taskolib/Bytes.h"
+#include "taskolib/exceptions.h"
+
+using gul14::cat;
+
+namespace task {
+
+Bytes Bytes::slice(size_type pos, size_type len) const
+{
+    if (pos > size_)
+        throw Error(cat("Slice position ", pos, " out of range (size ", size_, ')'));
+
+    Bytes result{ *this };
+    result.offset_ = offset_ + pos;
+    result.size_ = std::min(len, size_ - pos);
+    return result;
+}
+
+} // namespace task
@@ -0,0 +1,252 @@
+/**
+ * \file   ConstantTable.cc
+ * \author Lars Fröhlich
+ * \date   Created on October 18, 2026
+ * \brief  Implementation of the ConstantTable class.
+ *
+ * \copyright Copyright 2026 Deutsches Elektronen-Synchrotron (DESY), Hamburg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include <algorithm>
+#include <vector>
+
+#include <gul14/cat.h>
+
+#include "lua_details.h"
+#include "taskolib/ConstantTable.h"
+#include "taskolib/exceptions.h"
+#include "taskolib/execute_lua_script.h"
+
+using gul14::cat;
+
+namespace task {
+
+namespace {
+
+ConstantValue to_constant_value(const sol::object& obj, const std::string& path);
+
+// Return the position of the entry with the given key or of the first entry with a
+// greater key.
+ConstantTable::const_iterator
+find_position(const std::vector<ConstantTable::Entry>& entries, gul14::string_view key)
+{
+    return std::lower_bound(entries.begin(), entries.end(), key,
+        [](const ConstantTable::Entry& entry, gul14::string_view key)
+        {
+            return gul14::string_view{ entry.first } < key;
+        });
+}
+
+// Determine if a Lua table is a non-empty sequence, i.e. if its keys are exactly the
+// integers 1...n.
+bool is_sequence(const sol::table& table)
+{
+    const std::size_t n = table.size();
+    if (n == 0)
+        return false;
+
+    std::size_t num_keys = 0;
+    for (const auto& key_value : table)
+    {
+        const sol::object& key = key_value.first;
+        if (key.get_type() != sol::type::number || not key.is<LuaInteger>())
+            return false;
+        ++num_keys;
+    }
+
+    return num_keys == n;
+}
+
+// Convert a Lua sequence of numbers into an integer or floating-point array.
+ConstantValue to_numeric_array(const sol::table& table, const std::string& path)
+{
+    const std::size_t n = table.size();
+    bool all_integers = true;
+
+    for (std::size_t i = 1; i <= n; ++i)
+    {
+        const sol::object element = table[i];
+        if (element.get_type() != sol::type::number)
+        {
+            throw Error(cat("Cannot convert ", path, '[', i, "] to a constant: Sequences "
+                            "may only contain numbers"));
+        }
+        if (not element.is<LuaInteger>())
+            all_integers = false;
+    }
+
+    if (all_integers)
+    {
+        std::vector<VarInteger> values(n);
+        for (std::size_t i = 0; i != n; ++i)
+            values[i] = table.get<LuaInteger>(i + 1);
+        return VarIntArray{ std::move(values) };
+    }
+
+    std::vector<VarFloat> values(n);
+    for (std::size_t i = 0; i != n; ++i)
+        values[i] = table.get<LuaFloat>(i + 1);
+    return VarFloatArray{ std::move(values) };
+}
+
+// Convert a Lua table with string keys into a constant table.
+ConstantTable to_constant_table(const sol::table& table, const std::string& path)
+{
+    std::vector<ConstantTable::Entry> entries;
+
+    for (const auto& [key, value] : table)
+    {
+        if (key.get_type() != sol::type::string)
+        {
+            throw Error(cat("Cannot convert ", path, " to a constant table: All keys must "
+                            "be strings"));
+        }
+
+        auto key_str = key.as<std::string>();
+        auto constant = to_constant_value(value, cat(path, '.', key_str));
+        entries.emplace_back(std::move(key_str), std::move(constant));
+    }
+
+    return ConstantTable{ std::move(entries) };
+}
+
+ConstantValue to_constant_value(const sol::object& obj, const std::string& path)
+{
+    switch (obj.get_type())
+    {
+        case sol::type::number:
+            // For this check to work, SOL_SAFE_NUMERICS needs to be set to 1
+            if (obj.is<LuaInteger>())
+                return VarInteger{ obj.as<LuaInteger>() };
+            return VarFloat{ obj.as<LuaFloat>() };
+        case sol::type::string:
+            return obj.as<VarString>();
+        case sol::type::boolean:
+            return VarBool{ obj.as<LuaBool>() };
+        case sol::type::table:
+        {
+            const sol::table table = obj;
+            if (is_sequence(table))
+                return to_numeric_array(table, path);
+            return to_constant_table(table, path);
+        }
+        case sol::type::userdata:
+            if (obj.is<VarFloatArray>())
+                return obj.as<VarFloatArray>();
+            if (obj.is<VarIntArray>())
+                return obj.as<VarIntArray>();
+            if (obj.is<VarBytes>())
+                return obj.as<VarBytes>();
+            if (obj.is<ConstantTable>())
+                return obj.as<ConstantTable>();
+            [[fallthrough]];
+        default:
+            throw Error(cat("Cannot convert ", path, " to a constant: Unsupported type ",
+                            sol::type_name(obj.lua_state(), obj.get_type())));
+    }
+}
+
+} // anonymous namespace
+
+
+ConstantTable::ConstantTable(std::vector<Entry> entries)
+{
+    std::sort(entries.begin(), entries.end(),
+        [](const Entry& a, const Entry& b) { return a.first < b.first; });
+
+    for (std::size_t i = 0; i != entries.size(); ++i)
+    {
+        if (entries[i].first.empty())
+            throw Error("Constant table keys must not be empty");
+
+        if (i > 0 && entries[i].first == entries[i - 1].first)
+            throw Error(cat("Duplicate key in constant table: \"", entries[i].first, '"'));
+    }
+
+    if (not entries.empty())
+        entries_ = std::make_shared<const std::vector<Entry>>(std::move(entries));
+}
+
+const ConstantValue& ConstantTable::at(gul14::string_view key) const
+{
+    const ConstantValue* value = find(key);
+    if (value == nullptr)
+        throw Error(cat("Constant \"", key, "\" not found"));
+    return *value;
+}
+
+const std::vector<ConstantTable::Entry>& ConstantTable::entries() const noexcept
+{
+    static const std::vector<Entry> empty_entries;
+    return entries_ ? *entries_ : empty_entries;
+}
+
+const ConstantValue* ConstantTable::find(gul14::string_view key) const noexcept
+{
+    const auto& entries = this->entries();
+    const auto it = find_position(entries, key);
+    if (it == entries.end() || it->first != key)
+        return nullptr;
+    return &it->second;
+}
+
+ConstantTable ConstantTable::from_lua(gul14::string_view script, Timeout timeout,
+                                      CommChannel* comm_channel)
+{
+    const Context context;
+    sol::state lua;
+    open_safe_library_subset(lua);
+    install_data_types(lua);
+    install_timeout_and_termination_request_hook(lua, Clock::now(), timeout, gul14::nullopt,
+                                                 context, comm_channel, nullptr);
+
+    auto result_or_error = execute_lua_script(lua,
+        sol::string_view{ script.data(), script.size() });
+
+    if (auto err_msg = std::get_if<std::string>(&result_or_error))
+        throw Error(cat("Cannot build constant table: ", *err_msg));
+
+    const sol::object& result = std::get<sol::object>(result_or_error);
+    if (result.get_type() != sol::type::table)
+        throw Error("Cannot build constant table: The script must return a table");
+
+    // The conversion copies all data out of the Lua state, which is closed afterwards.
+    return to_constant_table(result.as<sol::table>(), "constants");
+}
+
+ConstantTable ConstantTable::with(std::string key, ConstantValue value) const
+{
+    std::vector<Entry> entries = this->entries();
+
+    auto it = std::lower_bound(entries.begin(), entries.end(), key,
+        [](const Entry& entry, const std::string& key) { return entry.first < key; });
+
+    if (it != entries.end() && it->first == key)
+        it->second = std::move(value);
+    else
+        entries.emplace(it, std::move(key), std::move(value));
+
+    return ConstantTable{ std::move(entries) };
+}
+
+bool operator==(const ConstantTable& a, const ConstantTable& b)
+{
+    return a.entries_ == b.entries_ || a.entries() == b.entries();
+}
+
+} // namespace task
@@ -53,7 +53,7 @@ VariableTable execute_sequence(Sequence sequence, Context context,
     // appropriate messages.
     (void)sequence.execute(context, comm.get(), opt_step_index);
 
-    return context.variables;
+    return std::move(context.variables);
 }
 
 } // anonymous namespace
@@ -69,7 +69,7 @@ void Executor::cancel()
     if (not future_.valid())
         return;
 
-    comm_channel_->immediate_termination_requested_ = true;
+    comm_channel_->request_immediate_termination();
     while (comm_channel_->queue_.try_pop());
     context_.variables = future_.get(); // Wait for thread to join
     comm_channel_->immediate_termination_requested_ = false;
@@ -78,7 +78,7 @@ void Executor::cancel()
 void Executor::cancel(Sequence& sequence) {
     if (not future_.valid())
         return;
-    comm_channel_->immediate_termination_requested_ = true;
+    comm_channel_->request_immediate_termination();
     while(update(sequence));
     if (future_.valid())
         context_.variables = future_.get();
@@ -105,7 +105,8 @@ void Executor::launch_async_execution(Sequence& sequence, Context context,
     if (future_.valid())
         throw Error("Busy executing another sequence");
 
-    // Store a copy of the context for its local print and logging functions
+    // Store a copy of the context for its local print and logging functions. The variable
+    // table is shared with the worker thread until one of the two sides modifies it.
     context_ = context;
 
     // Disable any message callbacks in the worker thread
@@ -176,10 +177,15 @@ bool Executor::update(Sequence& sequence)
                 });
             break;
         case Message::Type::step_stopped:
-            modify_step([](Step& s) { s.set_running(false); });
-            break;
         case Message::Type::step_stopped_with_error:
-            modify_step([](Step& s) { s.set_running(false); });
+            modify_step([&stats = msg.get_statistics()](Step& s)
+                {
+                    s.set_running(false);
+                    s.set_statistics(StepStatistics{ s.get_statistics() } += stats);
+                });
+            break;
+        case Message::Type::context_variables_changed:
+            apply_variable_changes(context_.variables, msg.get_variable_changes());
             break;
         default:
             throw Error(cat("Unknown message type ", static_cast<int>(msg.get_type())));
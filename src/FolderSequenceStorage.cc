@@ -0,0 +1,1092 @@
+/**
+ * \file   FolderSequenceStorage.cc
+ * \author Marcus Walla, Lars Fröhlich
+ * \date   Created on July 22, 2022
+ * \brief  Implementation of the FolderSequenceStorage class.
+ *
+ * \copyright Copyright 2022-2023 Deutsches Elektronen-Synchrotron (DESY), Hamburg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <iterator>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+#include <gul14/substring_checks.h>
+
+#include "deserialize_sequence.h"
+#include "file_io.h"
+#include "internals.h"
+#include "serialize_sequence.h"
+#include "taskolib/FolderSequenceStorage.h"
+
+using gul14::cat;
+
+namespace task {
+
+namespace {
+
+/**
+ * Minimum age of a modification time for the catalog or a cached sequence to be reused.
+ * This accounts for the limited resolution of filesystem timestamps.
+ */
+constexpr auto timestamp_resolution = std::chrono::seconds{ 2 };
+
+bool contains_id(const std::vector<FolderSequenceStorage::SequenceOnDisk>& sequences,
+    const UniqueId& uid)
+{
+    return std::any_of(sequences.begin(), sequences.end(),
+        [&uid](const auto& seq) { return seq.unique_id == uid; });
+}
+
+/// Create the filename. Push the extra leading zero to the step numberings (ie. leading
+/// zeros) to order them alphabetically.
+std::string extract_filename_step(const int number, int max_digits, const Step& step)
+{
+    std::ostringstream ss;
+    ss << "step_" << std::setw(max_digits) << std::setfill('0') << number << '_'
+       << to_string(step.get_type()) << ".lua";
+    return ss.str();
+}
+
+/**
+ * Load the given step files, using up to num_threads threads (including the calling
+ * one). The steps are returned in the order of the files. If any of the files cannot be
+ * loaded, the exception for the first of them is rethrown.
+ */
+std::vector<Step> load_steps(const std::vector<std::filesystem::path>& files,
+                             unsigned int num_threads)
+{
+    std::vector<Step> steps(files.size());
+    std::vector<std::exception_ptr> errors(files.size());
+    std::atomic<std::size_t> next_idx{ 0 };
+
+    auto worker = [&]()
+        {
+            for (auto idx = next_idx++; idx < files.size(); idx = next_idx++)
+            {
+                try
+                {
+                    steps[idx] = load_step(files[idx]);
+                }
+                catch (...)
+                {
+                    errors[idx] = std::current_exception();
+                }
+            }
+        };
+
+    std::vector<std::thread> threads;
+    const auto num_extra_threads = std::min<std::size_t>(num_threads, files.size()) - 1;
+    threads.reserve(num_extra_threads);
+
+    try
+    {
+        for (std::size_t i = 0; i < num_extra_threads; ++i)
+            threads.emplace_back(worker);
+    }
+    catch (...)
+    {
+        // Could not start all threads: Let the ones that are running do the work
+    }
+
+    worker();
+
+    for (auto& thread : threads)
+        thread.join();
+
+    for (const auto& error : errors)
+    {
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    return steps;
+}
+
+/// Determine if a filename belongs to a sequence file managed by FolderSequenceStorage.
+bool is_sequence_filename(gul14::string_view filename)
+{
+    return gul14::starts_with(filename, "step_") or filename == sequence_lua_filename
+        or filename == sequence_archive_filename or filename == file_hashes_filename;
+}
+
+/// The content hash of a file in a sequence folder together with the stamp of the file.
+struct FileHash
+{
+    std::uint64_t hash{ 0 };
+    FileStamp stamp;
+};
+
+/// Return the 64-bit FNV-1a hash of the given content.
+std::uint64_t hash_content(gul14::string_view content) noexcept
+{
+    std::uint64_t hash = 0xcbf29ce484222325ull;
+    for (const unsigned char c : content)
+    {
+        hash ^= c;
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+/**
+ * Read the file hashes stored in the given sequence folder. Only the hashes of files
+ * whose stamps have not changed since the hashes were stored are returned; if the file
+ * is missing or malformed, the map is empty.
+ */
+std::unordered_map<std::string, FileHash>
+read_file_hashes(const std::filesystem::path& folder)
+{
+    std::unordered_map<std::string, FileHash> hashes;
+
+    std::string content;
+    try
+    {
+        content = read_file(folder / file_hashes_filename);
+    }
+    catch (const Error&)
+    {
+        return hashes;
+    }
+
+    std::istringstream in{ content };
+    std::string line;
+
+    if (not std::getline(in, line) or line != "-- taskolib file hashes: 1")
+        return hashes;
+
+    while (std::getline(in, line))
+    {
+        if (line == "-- end")
+            return hashes;
+
+        std::istringstream line_in{ line };
+        std::string filename;
+        FileHash entry;
+        line_in >> std::hex >> entry.hash >> std::dec >> entry.stamp.inode
+                >> entry.stamp.size >> entry.stamp.mtime_ns >> filename;
+        if (line_in.fail() or not is_sequence_filename(filename))
+            break;
+
+        if (get_file_stamp(folder / filename) == entry.stamp)
+            hashes.emplace(std::move(filename), entry);
+    }
+
+    hashes.clear(); // truncated file
+    return hashes;
+}
+
+/**
+ * Store the hashes and stamps of the given files in the given sequence folder.
+ * \returns the path of the written file.
+ */
+std::filesystem::path write_file_hashes(const std::filesystem::path& folder,
+    const std::vector<std::pair<std::string, FileHash>>& hashes)
+{
+    std::ostringstream out;
+    out << "-- taskolib file hashes: 1\n";
+    for (const auto& [filename, entry] : hashes)
+    {
+        out << std::hex << entry.hash << std::dec << ' ' << entry.stamp.inode << ' '
+            << entry.stamp.size << ' ' << entry.stamp.mtime_ns << ' ' << filename << '\n';
+    }
+    out << "-- end\n";
+
+    const auto file = folder / file_hashes_filename;
+    write_file(file, out.str());
+    return file;
+}
+
+/**
+ * Create a hard link to a file, or copy it if the filesystem does not support links.
+ * \returns true if the file has been copied (and must therefore be synchronized).
+ */
+bool link_or_copy_file(const std::filesystem::path& from, const std::filesystem::path& to)
+{
+    std::error_code error;
+    std::filesystem::create_hard_link(from, to, error);
+    if (not error)
+        return false;
+
+    std::filesystem::copy_file(from, to, error);
+    if (error)
+    {
+        throw Error(cat("I/O error: cannot copy ", from.string(), " to ", to.string(),
+            ": ", error.message()));
+    }
+    return true;
+}
+
+/**
+ * Fill a new sequence folder with files for the given contents, taking over files from
+ * the old folder where possible.
+ *
+ * A file from the old folder with the same content (under the same or another name) is
+ * hard-linked into the new folder instead of being written again. Files in the old
+ * folder that do not belong to the sequence format are taken over as they are.
+ *
+ * The content hashes of the files are stored in the folder along with the stamps of the
+ * files (see FileStamp). An old file whose stamp still matches is identified by its hash
+ * alone; only files that have been modified by other means since the last save (or that
+ * have no hash yet) are read back.
+ *
+ * \returns the list of files that had to be written or copied.
+ */
+std::vector<std::filesystem::path>
+populate_folder(const std::filesystem::path& old_folder,
+    const std::filesystem::path& new_folder,
+    const std::vector<std::pair<std::string, std::string>>& files)
+{
+    std::vector<std::filesystem::path> written_files;
+
+    std::vector<std::string> old_files;
+    if (std::filesystem::is_directory(old_folder))
+    {
+        for (const auto& entry : std::filesystem::directory_iterator{ old_folder })
+        {
+            if (not entry.is_regular_file())
+                continue;
+
+            auto filename = entry.path().filename().string();
+            if (filename == file_hashes_filename)
+                continue;
+
+            if (is_sequence_filename(filename))
+            {
+                old_files.push_back(std::move(filename));
+            }
+            else
+            {
+                const auto new_file = new_folder / filename;
+                if (link_or_copy_file(entry.path(), new_file))
+                    written_files.push_back(new_file);
+            }
+        }
+    }
+
+    // Old files with an up-to-date hash, indexed by the hash (with the file size)
+    std::unordered_map<std::uint64_t, std::pair<std::string, std::uint64_t>>
+        old_files_by_hash;
+    // Old files without an up-to-date hash, only read if any file cannot be found by hash
+    std::vector<std::string> unknown_files;
+    {
+        const auto old_hashes = read_file_hashes(old_folder);
+        for (auto& old_file : old_files)
+        {
+            const auto it = old_hashes.find(old_file);
+            if (it != old_hashes.end())
+            {
+                old_files_by_hash.emplace(it->second.hash,
+                    std::make_pair(std::move(old_file), it->second.stamp.size));
+            }
+            else
+            {
+                unknown_files.push_back(std::move(old_file));
+            }
+        }
+    }
+
+    std::unordered_map<std::string, std::string> unknown_files_by_content;
+    bool have_read_unknown_files = false;
+
+    std::vector<std::pair<std::string, FileHash>> new_hashes;
+    new_hashes.reserve(files.size());
+
+    for (const auto& [filename, content] : files)
+    {
+        const auto new_file = new_folder / filename;
+        const auto hash = hash_content(content);
+
+        gul14::optional<std::string> source;
+
+        auto it = old_files_by_hash.find(hash);
+        if (it != old_files_by_hash.end() and it->second.second == content.size())
+        {
+            source = it->second.first;
+        }
+        else if (not unknown_files.empty())
+        {
+            if (not have_read_unknown_files)
+            {
+                for (const auto& old_file : unknown_files)
+                {
+                    unknown_files_by_content.emplace(read_file(old_folder / old_file),
+                        old_file);
+                }
+                have_read_unknown_files = true;
+            }
+
+            auto content_it = unknown_files_by_content.find(content);
+            if (content_it != unknown_files_by_content.end())
+                source = content_it->second;
+        }
+
+        if (source)
+        {
+            if (link_or_copy_file(old_folder / *source, new_file))
+                written_files.push_back(new_file);
+        }
+        else
+        {
+            write_file(new_file, content);
+            written_files.push_back(new_file);
+        }
+
+        const auto stamp = get_file_stamp(new_file);
+        if (stamp)
+            new_hashes.emplace_back(filename, FileHash{ hash, *stamp });
+    }
+
+    written_files.push_back(write_file_hashes(new_folder, new_hashes));
+
+    return written_files;
+}
+
+} // anonymous namespace
+
+FolderSequenceStorage::FolderSequenceStorage(std::filesystem::path path,
+    StorageFormat format)
+    : path_{ std::move(path) }
+    , storage_format_{ format }
+{
+    if (path_.empty())
+        throw Error("Base path name for sequences must not be empty");
+}
+
+FolderSequenceStorage::FolderSequenceStorage(const FolderSequenceStorage& other)
+    : SequenceStorage(other)
+    , path_{ other.path_ }
+    , catalog_file_enabled_{ other.catalog_file_enabled_ }
+    , storage_format_{ other.storage_format_ }
+    , num_load_threads_{ other.num_load_threads_ }
+    , cache_capacity_{ other.cache_capacity_ }
+{}
+
+FolderSequenceStorage&
+FolderSequenceStorage::operator=(const FolderSequenceStorage& other)
+{
+    if (this == &other)
+        return *this;
+
+    path_ = other.path_;
+    catalog_file_enabled_ = other.catalog_file_enabled_;
+    storage_format_ = other.storage_format_;
+    num_load_threads_ = other.num_load_threads_;
+    cache_capacity_ = other.cache_capacity_;
+
+    {
+        std::lock_guard<std::mutex> lock(catalog_mutex_);
+        catalog_.reset();
+    }
+
+    clear_cache();
+    return *this;
+}
+
+void FolderSequenceStorage::clear_cache() const
+{
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    cache_.clear();
+    cache_index_.clear();
+    ++cache_generation_;
+}
+
+void FolderSequenceStorage::copy_sequence(UniqueId original_uid,
+    const SequenceName& new_name, UniqueId new_uid) const
+{
+    const auto catalog = get_catalog();
+    if (catalog->index.count(new_uid))
+    {
+        throw Error(cat("Cannot copy sequence: Unique ID ", to_string(new_uid),
+            " is already in use"));
+    }
+
+    const auto original = find_sequence_on_disk(original_uid);
+    const auto original_path = path_ / original.path;
+
+    // Name and unique ID are only stored in the folder name, so all files can be cloned
+    // unchanged into a new folder.
+    const auto copy_folder_name = make_sequence_filename(new_name, new_uid);
+    const auto copy_path = path_ / copy_folder_name;
+    const auto tmp_path = path_ / cat('.', copy_folder_name, ".tmp");
+
+    try
+    {
+        std::filesystem::remove_all(tmp_path); // leftover from an interrupted copy
+        std::filesystem::create_directories(tmp_path);
+    }
+    catch (const std::exception& e)
+    {
+        throw Error(cat("I/O error: ", e.what()));
+    }
+
+    try
+    {
+        std::vector<std::filesystem::path> files;
+
+        std::error_code error;
+        for (std::filesystem::directory_iterator it{ original_path, error }, end;
+             not error and it != end; it.increment(error))
+        {
+            if (not it->is_regular_file())
+                continue;
+
+            files.push_back(tmp_path / it->path().filename());
+            clone_file(it->path(), files.back());
+        }
+
+        if (error)
+        {
+            throw Error(cat("Cannot read sequence folder ", original_path.string(),
+                ": ", error.message()));
+        }
+
+        sync_files(files);
+        sync_directory(tmp_path);
+        replace_directory(tmp_path, copy_path);
+        sync_directory(path_);
+    }
+    catch (const Error&)
+    {
+        std::error_code error;
+        std::filesystem::remove_all(tmp_path, error);
+        throw;
+    }
+}
+
+UniqueId
+FolderSequenceStorage::create_unique_id(const std::vector<SequenceOnDisk>& sequences)
+{
+    for (int i = 0; i != 10'000; ++i)
+    {
+        UniqueId uid;
+
+        if (!contains_id(sequences, uid))
+            return uid;
+    }
+
+    throw Error("Unable to find a unique ID");
+}
+
+void FolderSequenceStorage::evict_from_cache(UniqueId uid) const
+{
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    ++cache_generation_;
+
+    const auto it = cache_index_.find(uid);
+    if (it == cache_index_.end())
+        return;
+
+    cache_.erase(it->second);
+    cache_index_.erase(it);
+}
+
+FolderSequenceStorage::SequenceOnDisk
+FolderSequenceStorage::find_sequence_on_disk(UniqueId uid) const
+{
+    const auto catalog = get_catalog();
+
+    const auto it = catalog->index.find(uid);
+    if (it == catalog->index.end())
+        throw Error(cat("Sequence not found: Unknown unique ID ", to_string(uid)));
+
+    return catalog->sequences[it->second];
+}
+
+std::shared_ptr<const FolderSequenceStorage::Catalog>
+FolderSequenceStorage::get_catalog() const
+{
+    // Only one thread examines the base folder at a time; the others wait for its result.
+    std::lock_guard<std::mutex> lock(catalog_mutex_);
+
+    // The modification time is queried before examining the folder, so that any change
+    // during the scan invalidates the catalog.
+    std::error_code error;
+    const auto folder_time = std::filesystem::last_write_time(path_, error);
+    if (error)
+    {
+        throw Error(cat("Cannot access sequence folder ", path_.string(), ": ",
+            error.message()));
+    }
+
+    if (catalog_ and catalog_->is_valid and catalog_->folder_time == folder_time)
+        return catalog_;
+
+    auto catalog = std::make_shared<Catalog>();
+
+    if (catalog_file_enabled_ and read_catalog_file(folder_time, *catalog))
+    {
+        catalog_ = std::move(catalog);
+        return catalog_;
+    }
+
+    catalog->sequences = scan_base_folder();
+    catalog->folder_time = folder_time;
+
+    catalog->index.reserve(catalog->sequences.size());
+    for (std::size_t i = 0; i != catalog->sequences.size(); ++i)
+        catalog->index.emplace(catalog->sequences[i].unique_id, i);
+
+    // Filesystem timestamps have a limited resolution. If the folder has been modified
+    // very recently, another modification could follow without changing the timestamp,
+    // so the catalog is only trusted once the timestamp is old enough.
+    catalog->is_valid = std::filesystem::file_time_type::clock::now() - folder_time
+        > timestamp_resolution;
+
+    if (catalog->is_valid and catalog_file_enabled_)
+        write_catalog_file(*catalog);
+
+    catalog_ = std::move(catalog);
+    return catalog_;
+}
+
+FolderSequenceStorage::FolderStamp
+FolderSequenceStorage::get_folder_stamp(const std::filesystem::path& folder)
+{
+    const auto file_stamp = get_file_stamp(folder);
+    if (not file_stamp)
+        throw Error(cat("Cannot examine sequence folder ", folder.string()));
+
+    return FolderStamp{ file_stamp->inode, file_stamp->mtime_ns };
+}
+
+std::vector<FolderSequenceStorage::SequenceOnDisk>
+FolderSequenceStorage::list_sequences() const
+{
+    return get_catalog()->sequences;
+}
+
+Sequence FolderSequenceStorage::load_sequence(UniqueId uid) const
+{
+    if (cache_capacity_ == 0)
+        return load_sequence(find_sequence_on_disk(uid));
+
+    return *load_sequence_snapshot(uid);
+}
+
+Sequence FolderSequenceStorage::load_sequence(const SequenceOnDisk& seq_on_disk) const
+{
+    const auto folder = path_ / seq_on_disk.path;
+
+    if (not std::filesystem::exists(folder))
+        throw Error(cat("Sequence file path does not exist: ", folder.string()));
+    else if (not std::filesystem::is_directory(folder))
+        throw Error(cat("Sequence file path is not a directory: ", folder.string()));
+
+    Sequence seq{ "", seq_on_disk.name, seq_on_disk.unique_id };
+
+    const auto archive = folder / sequence_archive_filename;
+    if (std::filesystem::exists(archive))
+    {
+        load_sequence_archive(archive, seq);
+        return seq;
+    }
+
+    load_sequence_parameters(folder, seq);
+
+    std::vector<std::filesystem::path> steps;
+    for (auto const& entry : std::filesystem::directory_iterator{folder})
+    {
+        if (entry.is_regular_file()
+            and gul14::starts_with(entry.path().filename().string(), "step_"))
+        {
+            steps.push_back(entry.path());
+        }
+    }
+
+    if (not steps.empty())
+    {
+        // load steps ...
+        std::sort(std::begin(steps), std::end(steps),
+            [](const auto& lhs, const auto& rhs) -> bool
+            { return lhs.filename() < rhs.filename(); });
+
+        auto loaded_steps = load_steps(steps, num_load_threads_);
+        seq.insert(seq.end(), std::make_move_iterator(loaded_steps.begin()),
+            std::make_move_iterator(loaded_steps.end()));
+    }
+
+    return seq;
+}
+
+FolderSequenceStorage::SequenceHeader
+FolderSequenceStorage::load_sequence_header(UniqueId uid) const
+{
+    return load_sequence_header(find_sequence_on_disk(uid));
+}
+
+FolderSequenceStorage::SequenceHeader
+FolderSequenceStorage::load_sequence_header(const SequenceOnDisk& seq_on_disk) const
+{
+    const auto folder = path_ / seq_on_disk.path;
+
+    if (not std::filesystem::is_directory(folder))
+        throw Error(cat("Sequence file path is not a directory: ", folder.string()));
+
+    // The parameters are loaded into an empty sequence, so that only the steps are skipped
+    Sequence seq{ "", seq_on_disk.name, seq_on_disk.unique_id };
+    std::size_t num_steps = 0;
+
+    const auto archive = folder / sequence_archive_filename;
+    if (std::filesystem::exists(archive))
+    {
+        num_steps = load_sequence_archive_parameters(archive, seq);
+    }
+    else
+    {
+        load_sequence_parameters(folder, seq);
+
+        for (auto const& entry : std::filesystem::directory_iterator{folder})
+        {
+            if (entry.is_regular_file()
+                and gul14::starts_with(entry.path().filename().string(), "step_"))
+            {
+                ++num_steps;
+            }
+        }
+    }
+
+    return SequenceHeader{ seq_on_disk.path, seq_on_disk.name, seq_on_disk.unique_id,
+        seq.get_label(), seq.get_maintainers(), seq.get_timeout(), num_steps };
+}
+
+std::vector<FolderSequenceStorage::SequenceHeader>
+FolderSequenceStorage::load_sequence_headers() const
+{
+    const auto catalog = get_catalog();
+    const auto& sequences = catalog->sequences;
+
+    std::vector<SequenceHeader> headers;
+    headers.reserve(sequences.size());
+
+    for (const auto& seq_on_disk : sequences)
+        headers.push_back(load_sequence_header(seq_on_disk));
+
+    return headers;
+}
+
+std::shared_ptr<const Sequence>
+FolderSequenceStorage::load_sequence_snapshot(UniqueId uid) const
+{
+    const auto seq_on_disk = find_sequence_on_disk(uid);
+
+    if (cache_capacity_ == 0)
+        return std::make_shared<const Sequence>(load_sequence(seq_on_disk));
+
+    // The stamp is taken before loading, so that a modification during the load makes
+    // the cache entry appear outdated rather than hiding the modification.
+    const auto stamp = get_folder_stamp(path_ / seq_on_disk.path);
+    std::uint64_t generation = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+
+        const auto it = cache_index_.find(uid);
+        if (it != cache_index_.end())
+        {
+            const auto entry = it->second;
+
+            if (entry->path == seq_on_disk.path and entry->stamp == stamp)
+            {
+                cache_.splice(cache_.begin(), cache_, entry);
+                return entry->sequence;
+            }
+
+            cache_.erase(entry);
+            cache_index_.erase(it);
+        }
+
+        generation = cache_generation_;
+    }
+
+    // The lock is not held while loading, so other sequences can be served meanwhile
+    auto sequence = std::make_shared<const Sequence>(load_sequence(seq_on_disk));
+
+    // A recent modification could be followed by another one with the same timestamp.
+    const auto age = std::chrono::system_clock::now().time_since_epoch()
+        - std::chrono::nanoseconds{ stamp.mtime_ns };
+    if (age <= timestamp_resolution)
+        return sequence;
+
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+
+    // A sequence that has been stored, renamed, or removed through this manager during
+    // the load might not have changed the stamp yet, so it is not cached.
+    if (cache_generation_ != generation)
+        return sequence;
+
+    // Another thread may have cached the same sequence in the meantime
+    const auto it = cache_index_.find(uid);
+    if (it != cache_index_.end())
+    {
+        cache_.erase(it->second);
+        cache_index_.erase(it);
+    }
+
+    cache_.push_front(CacheEntry{ uid, seq_on_disk.path, stamp, sequence });
+    cache_index_[uid] = cache_.begin();
+
+    while (cache_.size() > cache_capacity_)
+    {
+        cache_index_.erase(cache_.back().unique_id);
+        cache_.pop_back();
+    }
+
+    return sequence;
+}
+
+bool FolderSequenceStorage::read_catalog_file(std::filesystem::file_time_type folder_time,
+    Catalog& catalog) const
+{
+    std::string content;
+    try
+    {
+        content = read_file(path_ / catalog_filename);
+    }
+    catch (const Error&)
+    {
+        return false;
+    }
+
+    gul14::string_view data{ content };
+
+    auto next_line = [&data]() -> gul14::string_view
+        {
+            const auto end = data.find('\n');
+            if (end == data.npos)
+            {
+                data = {};
+                return {};
+            }
+            auto line = data.substr(0, end);
+            data.remove_prefix(end + 1);
+            return line;
+        };
+
+    if (next_line() != "-- taskolib sequence catalog: 1")
+        return false;
+
+    const auto time_line = next_line();
+    if (time_line != cat("-- folder time: ", folder_time.time_since_epoch().count()))
+        return false;
+
+    std::vector<SequenceOnDisk> sequences;
+    for (auto line = next_line(); line != "-- end"; line = next_line())
+    {
+        if (line.empty())
+            return false; // truncated file
+
+        auto info = get_sequence_info_from_filename(line);
+        if (not info.name or not info.unique_id)
+            return false;
+
+        sequences.push_back(SequenceOnDisk{ std::string{ line }, std::move(*info.name),
+            *info.unique_id });
+    }
+
+    catalog.sequences = std::move(sequences);
+    catalog.folder_time = folder_time;
+    catalog.index.clear();
+    catalog.index.reserve(catalog.sequences.size());
+    for (std::size_t i = 0; i != catalog.sequences.size(); ++i)
+        catalog.index.emplace(catalog.sequences[i].unique_id, i);
+    catalog.is_valid = true;
+
+    return true;
+}
+
+SequenceName
+FolderSequenceStorage::make_sequence_name_from_label(gul14::string_view label)
+{
+    std::string name;
+
+    if (label.size() > SequenceName::max_length)
+        label = label.substr(0, SequenceName::max_length);
+
+    for (const auto c : label)
+    {
+        if (gul14::contains(SequenceName::valid_characters, c))
+            name.push_back(c);
+        else
+            name.push_back('_');
+    }
+
+    return SequenceName{ name };
+}
+
+void FolderSequenceStorage::remove_sequence(UniqueId unique_id) const
+{
+    evict_from_cache(unique_id);
+
+    const auto seq_on_disk = find_sequence_on_disk(unique_id);
+    const auto path = path_ / seq_on_disk.path;
+
+    std::error_code error;
+    std::filesystem::remove_all(path, error);
+    if (error)
+    {
+        throw Error(cat("Cannot remove sequence folder ", path.string(), ": ",
+            error.message()));
+    }
+}
+
+void FolderSequenceStorage::rename_sequence(UniqueId unique_id,
+    const SequenceName& new_name) const
+{
+    evict_from_cache(unique_id);
+
+    const auto old_seq_on_disk = find_sequence_on_disk(unique_id);
+
+    const auto old_path = path_ / old_seq_on_disk.path;
+    const auto new_path = path_ / make_sequence_filename(new_name, unique_id);
+
+    std::error_code error;
+    std::filesystem::rename(old_path, new_path, error);
+    if (error)
+    {
+        throw Error(gul14::cat("Cannot rename folder ", old_path.string(),
+            " to ", new_path.string(), ": ", error.message()));
+    }
+}
+
+std::vector<FolderSequenceStorage::SequenceOnDisk>
+FolderSequenceStorage::scan_base_folder() const
+{
+    std::vector<SequenceOnDisk> sequences;
+    std::vector<std::filesystem::path> suspicious_folders;
+    std::vector<std::filesystem::path> backup_folders;
+
+    for (const auto& entry : std::filesystem::directory_iterator{ path_ })
+    {
+        if (not entry.is_directory())
+            continue;
+
+        auto rel_path = entry.path().filename();
+        const auto filename = rel_path.string();
+
+        // Skip hidden folders like ".git" or temporary folders from store_sequence(),
+        // but remember backups of sequence folders made by replace_directory()
+        if (gul14::starts_with(filename, "."))
+        {
+            if (gul14::ends_with(filename, ".tmp.old"))
+                backup_folders.push_back(std::move(rel_path));
+            continue;
+        }
+
+        SequenceInfo seq_info = get_sequence_info_from_filename(filename);
+
+        if (seq_info.name.has_value() && seq_info.unique_id.has_value())
+        {
+            sequences.push_back(SequenceOnDisk{
+                std::move(rel_path),
+                std::move(*seq_info.name),
+                std::move(*seq_info.unique_id) });
+        }
+        else
+        {
+            suspicious_folders.push_back(std::move(rel_path));
+        }
+    }
+
+    // A backup without the sequence folder it was made from is left behind if a save
+    // failed (or the process died) while the old folder had been moved out of the way.
+    // The backup is then the last complete version of the sequence, so it is restored.
+    for (const auto& backup : backup_folders)
+    {
+        const auto backup_name = backup.string();
+        const auto folder_name = backup_name.substr(1,
+            backup_name.size() - 1 - std::strlen(".tmp.old"));
+
+        SequenceInfo seq_info = get_sequence_info_from_filename(folder_name);
+        if (not seq_info.name or not seq_info.unique_id
+            or std::filesystem::exists(path_ / folder_name)
+            or contains_id(sequences, *seq_info.unique_id))
+        {
+            continue;
+        }
+
+        std::error_code error;
+        std::filesystem::rename(path_ / backup, path_ / folder_name, error);
+        if (error)
+        {
+            throw Error(cat("Cannot restore sequence folder ", folder_name,
+                " from its backup: ", error.message()));
+        }
+
+        sequences.push_back(SequenceOnDisk{ folder_name, std::move(*seq_info.name),
+            *seq_info.unique_id });
+    }
+
+    // Loop over all folders that did not have name and unique ID in their name.
+    for (const auto& folder : suspicious_folders)
+    {
+        // It could be a non-sequence folder or a sequence folder from an older version.
+        // We only believe it is the latter if it contains a sequence.lua file.
+        if (not std::filesystem::exists(path_ / folder / "sequence.lua"))
+            continue;
+
+        // So it is a sequence folder after all. We automatically generate a unique ID
+        // and rename the folder.
+        UniqueId unique_id = create_unique_id(sequences);
+
+        const auto [label, dummy1, dummy2] =
+            get_sequence_info_from_filename(folder.string());
+
+        SequenceName name = make_sequence_name_from_label(label);
+
+        const auto new_folder_name = make_sequence_filename(name, unique_id);
+
+        std::error_code error;
+        std::filesystem::rename(path_ / folder, path_ / new_folder_name, error);
+        if (error)
+        {
+            throw Error(gul14::cat("Sequence folder ", folder.string(),
+                " does not contain a unique ID and cannot be renamed to ",
+                new_folder_name, ": ", error.message()));
+        }
+
+        auto seq = load_sequence(SequenceOnDisk{ new_folder_name, name, unique_id });
+        if (seq.get_label().empty()) // legacy sequences do not store the label in the lua file
+        {
+            seq.set_label(label);
+            store_sequence(seq);
+        }
+
+        sequences.push_back(SequenceOnDisk{ new_folder_name, name, unique_id });
+    }
+
+    return sequences;
+}
+
+void FolderSequenceStorage::set_cache_capacity(std::size_t num_sequences)
+{
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    cache_capacity_ = num_sequences;
+
+    while (cache_.size() > cache_capacity_)
+    {
+        cache_index_.erase(cache_.back().unique_id);
+        cache_.pop_back();
+    }
+}
+
+void FolderSequenceStorage::set_num_load_threads(unsigned int num_threads) noexcept
+{
+    if (num_threads == 0)
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+
+    num_load_threads_ = num_threads;
+}
+
+void FolderSequenceStorage::store_sequence(const Sequence& seq) const
+{
+    evict_from_cache(seq.get_unique_id());
+
+    const auto seq_folder_name = make_sequence_filename(seq);
+    const auto seq_path = path_ / seq_folder_name;
+    const auto tmp_path = path_ / cat('.', seq_folder_name, ".tmp");
+
+    // Collect the names and contents of all files to be stored
+    std::vector<std::pair<std::string, std::string>> files;
+
+    if (storage_format_ == StorageFormat::archive)
+    {
+        files.emplace_back(sequence_archive_filename, make_sequence_archive(seq));
+    }
+    else
+    {
+        files.reserve(seq.size() + 1);
+
+        std::ostringstream ss;
+        write_sequence_parameters(ss, seq);
+        files.emplace_back(sequence_lua_filename, ss.str());
+
+        const int max_digits = int( seq.size() / 10 ) + 1;
+        unsigned int idx = 0;
+        for (const auto& step : seq)
+        {
+            ss.str("");
+            ss << step;
+            files.emplace_back(extract_filename_step(++idx, max_digits, step), ss.str());
+        }
+    }
+
+    // Build the new sequence folder next to the old one and swap them
+    try
+    {
+        std::filesystem::remove_all(tmp_path); // leftover from an interrupted save
+        std::filesystem::create_directories(tmp_path);
+
+        // A backup of the old folder is only needed as long as the folder is missing
+        auto backup_path = tmp_path;
+        backup_path += ".old";
+        if (std::filesystem::exists(seq_path))
+            std::filesystem::remove_all(backup_path);
+    }
+    catch (const std::exception& e)
+    {
+        throw Error(cat("I/O error: ", e.what()));
+    }
+
+    try
+    {
+        const auto written_files = populate_folder(seq_path, tmp_path, files);
+        sync_files(written_files);
+        sync_directory(tmp_path);
+        replace_directory(tmp_path, seq_path);
+        sync_directory(path_);
+    }
+    catch (const Error&)
+    {
+        std::error_code error;
+        std::filesystem::remove_all(tmp_path, error);
+        throw;
+    }
+}
+
+void FolderSequenceStorage::write_catalog_file(const Catalog& catalog) const
+{
+    std::string content = cat("-- taskolib sequence catalog: 1\n-- folder time: ",
+        catalog.folder_time.time_since_epoch().count(), '\n');
+
+    for (const auto& seq : catalog.sequences)
+        content += cat(seq.path.string(), '\n');
+
+    content += "-- end\n";
+
+    // The file is overwritten in place: Replacing it would change the modification
+    // time of the base folder and invalidate the catalog immediately. A file that is
+    // incomplete after a crash is detected by the missing end marker.
+    try
+    {
+        write_file(path_ / catalog_filename, content);
+    }
+    catch (const Error&)
+    {
+        // The catalog file is only a cache, so failing to write it is not an error
+    }
+}
+
+} // namespace task
@@ -0,0 +1,85 @@
+/**
+ * \file   MappedFile.cc
+ * \author Lars Fröhlich
+ * \date   Created on October 18, 2026
+ * \brief  Implementation of the MappedFile class.
+ *
+ * \copyright Copyright 2026 Deutsches Elektronen-Synchrotron (DESY), Hamburg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <gul14/cat.h>
+
+#include "MappedFile.h"
+#include "taskolib/exceptions.h"
+
+using gul14::cat;
+
+namespace task {
+
+MappedFile::MappedFile(const std::filesystem::path& path)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        throw Error(cat("I/O error: unable to open file '", path.string(), "': ",
+                        std::strerror(errno)));
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0)
+    {
+        const int err = errno;
+        ::close(fd);
+        throw Error(cat("I/O error: unable to examine file '", path.string(), "': ",
+                        std::strerror(err)));
+    }
+
+    size_ = static_cast<std::size_t>(st.st_size);
+
+    if (size_ > 0)
+    {
+        void* data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            const int err = errno;
+            ::close(fd);
+            throw Error(cat("I/O error: unable to map file '", path.string(), "': ",
+                            std::strerror(err)));
+        }
+        data_ = data;
+    }
+
+    // The mapping stays valid after the file descriptor has been closed
+    ::close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+    if (data_)
+        ::munmap(data_, size_);
+}
+
+} // namespace task
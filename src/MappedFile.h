@@ -0,0 +1,72 @@
+/**
+ * \file   MappedFile.h
+ * \author Lars Fröhlich
+ * \date   Created on October 18, 2026
+ * \brief  Declaration of the MappedFile class.
+ *
+ * \copyright Copyright 2026 Deutsches Elektronen-Synchrotron (DESY), Hamburg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#ifndef TASKOLIB_MAPPEDFILE_H_
+#define TASKOLIB_MAPPEDFILE_H_
+
+#include <cstddef>
+#include <filesystem>
+
+#include <gul14/string_view.h>
+
+namespace task {
+
+/**
+ * A read-only memory mapping of a whole file.
+ *
+ * The contents of the file are available via view() for as long as the object exists,
+ * without being copied into a buffer. An empty file results in an empty view.
+ */
+class MappedFile
+{
+public:
+    /**
+     * Map the given file into memory.
+     * \exception Error is thrown if the file cannot be opened or mapped.
+     */
+    explicit MappedFile(const std::filesystem::path& path);
+
+    /// Unmap the file.
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /// Return the number of bytes in the file.
+    std::size_t size() const noexcept { return size_; }
+
+    /// Return a view of the file contents.
+    gul14::string_view view() const noexcept
+    {
+        return { static_cast<const char*>(data_), size_ };
+    }
+
+private:
+    void* data_{ nullptr };
+    std::size_t size_{ 0 };
+};
+
+} // namespace task
+
+#endif
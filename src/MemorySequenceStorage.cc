@@ -0,0 +1,107 @@
+/**
+ * \file   MemorySequenceStorage.cc
+ * \author Lars Fröhlich
+ * \date   Created on October 18, 2026
+ * \brief  Implementation of the MemorySequenceStorage class.
+ *
+ * \copyright Copyright 2026 Deutsches Elektronen-Synchrotron (DESY), Hamburg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include <string>
+#include <utility>
+
+#include <gul14/cat.h>
+
+#include "deserialize_sequence.h"
+#include "serialize_sequence.h"
+#include "taskolib/exceptions.h"
+#include "taskolib/MemorySequenceStorage.h"
+
+using gul14::cat;
+
+namespace task {
+
+MemorySequenceStorage::MemorySequenceStorage()
+    : sequences_{ std::make_shared<SequenceMap>() }
+{}
+
+MemorySequenceStorage::SequenceMap::iterator
+MemorySequenceStorage::find_sequence(UniqueId uid) const
+{
+    const auto it = sequences_->find(uid);
+    if (it == sequences_->end())
+        throw Error(cat("Sequence not found: Unknown unique ID ", to_string(uid)));
+
+    return it;
+}
+
+void MemorySequenceStorage::copy_sequence(UniqueId original_uid,
+    const SequenceName& new_name, UniqueId new_uid) const
+{
+    if (sequences_->count(new_uid))
+        throw Error(cat("Cannot copy sequence: Unique ID ", to_string(new_uid),
+            " is already in use"));
+
+    // The archive does not contain name and unique ID, so it can be copied unchanged
+    std::string archive = find_sequence(original_uid)->second.archive;
+    sequences_->emplace(new_uid, StoredSequence{ new_name, std::move(archive) });
+}
+
+std::vector<MemorySequenceStorage::SequenceOnDisk>
+MemorySequenceStorage::list_sequences() const
+{
+    std::vector<SequenceOnDisk> result;
+    result.reserve(sequences_->size());
+
+    for (const auto& [uid, stored] : *sequences_)
+    {
+        result.push_back(SequenceOnDisk{ make_sequence_filename(stored.name, uid),
+                                         stored.name, uid });
+    }
+
+    return result;
+}
+
+Sequence MemorySequenceStorage::load_sequence(UniqueId uid) const
+{
+    const auto it = find_sequence(uid);
+    const auto& stored = it->second;
+
+    Sequence seq{ "", stored.name, uid };
+    load_sequence_archive(stored.archive, make_sequence_filename(stored.name, uid), seq);
+    return seq;
+}
+
+void MemorySequenceStorage::remove_sequence(UniqueId unique_id) const
+{
+    sequences_->erase(find_sequence(unique_id));
+}
+
+void MemorySequenceStorage::rename_sequence(UniqueId unique_id,
+                                            const SequenceName& new_name) const
+{
+    find_sequence(unique_id)->second.name = new_name;
+}
+
+void MemorySequenceStorage::store_sequence(const Sequence& sequence) const
+{
+    (*sequences_)[sequence.get_unique_id()] =
+        StoredSequence{ sequence.get_name(), make_sequence_archive(sequence) };
+}
+
+} // namespace task
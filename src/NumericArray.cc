@@ -0,0 +1,231 @@
+/**
+ * \file   NumericArray.cc
+ * \author Lars Fröhlich
+ * \date   Created on October 18, 2026
+ * \brief  Implementation of the kernels for numeric arrays.
+ *
+ * \copyright Copyright 2026 Deutsches Elektronen-Synchrotron (DESY), Hamburg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include <algorithm>
+#include <type_traits>
+
+#include <gul14/cat.h>
+
+#include "taskolib/exceptions.h"
+#include "taskolib/NumericArray.h"
+
+using gul14::cat;
+
+// The kernels below operate on raw pointers with simple loop bodies and without early
+// exits, so that the compiler can vectorize them. Reductions use four independent
+// accumulators to break the dependency chain of the additions, which allows vectorized
+// floating-point sums without relaxing the IEEE semantics (-ffast-math). Integer
+// reductions accumulate in the unsigned type of the same width: Signed overflow would be
+// undefined behavior, whereas unsigned arithmetic wraps around like Lua integers do.
+
+namespace task {
+
+namespace {
+
+// The type in which reductions over elements of type T are accumulated
+template <typename T, bool = std::is_integral_v<T>>
+struct Accumulator
+{
+    using type = T;
+};
+
+template <typename T>
+struct Accumulator<T, true>
+{
+    using type = std::make_unsigned_t<T>;
+};
+
+// Return the sum of n elements, accumulated in type Acc.
+template <typename Acc, typename T>
+Acc sum_elements(const T* data, std::size_t n) noexcept
+{
+    Acc acc[4] = { Acc{}, Acc{}, Acc{}, Acc{} };
+    std::size_t i = 0;
+
+    for (; i + 4 <= n; i += 4)
+    {
+        acc[0] += static_cast<Acc>(data[i]);
+        acc[1] += static_cast<Acc>(data[i + 1]);
+        acc[2] += static_cast<Acc>(data[i + 2]);
+        acc[3] += static_cast<Acc>(data[i + 3]);
+    }
+
+    for (; i != n; ++i)
+        acc[0] += static_cast<Acc>(data[i]);
+
+    return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+}
+
+template <typename T>
+void throw_if_empty(const NumericArray<T>& array, const char* fct_name)
+{
+    if (array.empty())
+        throw Error(cat(fct_name, "() is not defined for an empty array"));
+}
+
+} // anonymous namespace
+
+
+template <typename T>
+T sum(const NumericArray<T>& array) noexcept
+{
+    using Acc = typename Accumulator<T>::type;
+    return static_cast<T>(sum_elements<Acc>(array.data(), array.size()));
+}
+
+template <typename T>
+double mean(const NumericArray<T>& array)
+{
+    throw_if_empty(array, "mean");
+
+    // Integers are summed as doubles, so the mean does not suffer from a wrapped sum
+    return sum_elements<double>(array.data(), array.size())
+        / static_cast<double>(array.size());
+}
+
+template <typename T>
+T minimum(const NumericArray<T>& array)
+{
+    throw_if_empty(array, "minimum");
+
+    const T* data = array.data();
+    const std::size_t n = array.size();
+
+    T result = data[0];
+    for (std::size_t i = 1; i < n; ++i)
+        result = data[i] < result ? data[i] : result;
+
+    return result;
+}
+
+template <typename T>
+T maximum(const NumericArray<T>& array)
+{
+    throw_if_empty(array, "maximum");
+
+    const T* data = array.data();
+    const std::size_t n = array.size();
+
+    T result = data[0];
+    for (std::size_t i = 1; i < n; ++i)
+        result = data[i] > result ? data[i] : result;
+
+    return result;
+}
+
+template <typename T>
+NumericArray<double> scale_and_offset(const NumericArray<T>& array, double factor,
+                                      double offset)
+{
+    const T* in = array.data();
+    const std::size_t n = array.size();
+
+    std::vector<double> result(n);
+    double* out = result.data();
+
+    for (std::size_t i = 0; i != n; ++i)
+        out[i] = factor * static_cast<double>(in[i]) + offset;
+
+    return NumericArray<double>{ std::move(result) };
+}
+
+template <typename T>
+T dot(const NumericArray<T>& a, const NumericArray<T>& b)
+{
+    if (a.size() != b.size())
+    {
+        throw Error(cat("dot() requires arrays of equal size (", a.size(), " != ",
+                        b.size(), ')'));
+    }
+
+    const T* x = a.data();
+    const T* y = b.data();
+    const std::size_t n = a.size();
+
+    using Acc = typename Accumulator<T>::type;
+
+    Acc acc[4] = { Acc{}, Acc{}, Acc{}, Acc{} };
+    std::size_t i = 0;
+
+    for (; i + 4 <= n; i += 4)
+    {
+        acc[0] += static_cast<Acc>(x[i]) * static_cast<Acc>(y[i]);
+        acc[1] += static_cast<Acc>(x[i + 1]) * static_cast<Acc>(y[i + 1]);
+        acc[2] += static_cast<Acc>(x[i + 2]) * static_cast<Acc>(y[i + 2]);
+        acc[3] += static_cast<Acc>(x[i + 3]) * static_cast<Acc>(y[i + 3]);
+    }
+
+    for (; i != n; ++i)
+        acc[0] += static_cast<Acc>(x[i]) * static_cast<Acc>(y[i]);
+
+    return static_cast<T>((acc[0] + acc[1]) + (acc[2] + acc[3]));
+}
+
+template <typename T>
+gul14::optional<std::size_t> find_threshold(const NumericArray<T>& array, T threshold)
+    noexcept
+{
+    const T* data = array.data();
+    const std::size_t n = array.size();
+
+    // Scan in blocks without an early exit so that the comparisons can be vectorized
+    constexpr std::size_t block_size = 64;
+
+    for (std::size_t start = 0; start < n; start += block_size)
+    {
+        const std::size_t end = std::min(start + block_size, n);
+
+        bool found = false;
+        for (std::size_t i = start; i != end; ++i)
+            found |= (data[i] >= threshold);
+
+        if (found)
+        {
+            for (std::size_t i = start; i != end; ++i)
+            {
+                if (data[i] >= threshold)
+                    return i;
+            }
+        }
+    }
+
+    return gul14::nullopt;
+}
+
+#define TASKOLIB_INSTANTIATE_ARRAY_KERNELS(T) \
+    template T sum(const NumericArray<T>&) noexcept; \
+    template double mean(const NumericArray<T>&); \
+    template T minimum(const NumericArray<T>&); \
+    template T maximum(const NumericArray<T>&); \
+    template NumericArray<double> scale_and_offset(const NumericArray<T>&, double, double); \
+    template T dot(const NumericArray<T>&, const NumericArray<T>&); \
+    template gul14::optional<std::size_t> find_threshold(const NumericArray<T>&, T) \
+        noexcept;
+
+TASKOLIB_INSTANTIATE_ARRAY_KERNELS(double)
+TASKOLIB_INSTANTIATE_ARRAY_KERNELS(long long)
+
+#undef TASKOLIB_INSTANTIATE_ARRAY_KERNELS
+
+} // namespace task
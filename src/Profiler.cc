@@ -0,0 +1,132 @@
+/**
+ * \file   Profiler.cc
+ * \author Lars Fröhlich
+ * \date   Created on October 18, 2026
+ * \brief  Implementation of the Profiler class.
+ *
+ * \copyright Copyright 2026 Deutsches Elektronen-Synchrotron (DESY), Hamburg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include <gul14/cat.h>
+#include <gul14/SmallVector.h>
+
+#include "sol/sol.hpp"
+#include "taskolib/exceptions.h"
+#include "taskolib/Profiler.h"
+
+using gul14::cat;
+
+namespace task {
+
+namespace {
+
+// Maximum number of stack frames that are examined for a single sample
+constexpr int max_stack_depth = 64;
+
+// Return a folded-stack frame name for the given activation record, e.g. "main:12",
+// "compute:5", or "[C] tostring".
+std::string make_frame_name(const lua_Debug& ar)
+{
+    if (ar.what && ar.what[0] == 'C')
+        return cat("[C] ", ar.name ? ar.name : "?");
+
+    if (ar.what && ar.what[0] == 'm') // "main"
+        return cat("main:", ar.currentline);
+
+    if (ar.name)
+        return cat(ar.name, ':', ar.currentline);
+
+    return cat("<function@", ar.linedefined, ">:", ar.currentline);
+}
+
+} // anonymous namespace
+
+
+Profiler::Profiler(std::uint32_t instruction_interval)
+    : instruction_interval_{ instruction_interval }
+{
+    if (instruction_interval_ == 0)
+        throw Error("Profiler instruction interval must be positive");
+}
+
+Profiler::Profiler(std::chrono::microseconds time_interval)
+    : time_interval_{ time_interval }
+{
+    if (time_interval_.count() <= 0)
+        throw Error("Profiler time interval must be positive");
+}
+
+void Profiler::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    stacks_.clear();
+    sample_count_ = 0;
+}
+
+std::string Profiler::get_folded_stacks() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    std::string result;
+    for (const auto& [stack, count] : stacks_)
+    {
+        result += stack;
+        result += ' ';
+        result += std::to_string(count);
+        result += '\n';
+    }
+
+    return result;
+}
+
+std::uint64_t Profiler::get_sample_count() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sample_count_;
+}
+
+void Profiler::sample(lua_State* lua_state, OptionalStepIndex step_idx,
+                      std::uint64_t weight)
+{
+    gul14::SmallVector<std::string, 16> frames;
+    lua_Debug ar;
+
+    for (int level = 0; level != max_stack_depth && lua_getstack(lua_state, level, &ar);
+         ++level)
+    {
+        if (lua_getinfo(lua_state, "nSl", &ar) == 0)
+            break;
+
+        frames.push_back(make_frame_name(ar));
+    }
+
+    // Frames are collected from the innermost to the outermost one, but the folded
+    // format expects the root first.
+    std::string stack = step_idx ? cat("step ", *step_idx) : std::string{ "step ?" };
+    for (auto it = frames.rbegin(); it != frames.rend(); ++it)
+    {
+        stack += ';';
+        stack += *it;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    stacks_[std::move(stack)] += weight;
+    sample_count_ += weight;
+}
+
+} // namespace task
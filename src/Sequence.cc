@@ -710,9 +710,9 @@ void Sequence::set_step_setup_script(gul14::string_view step_setup_script)
     step_setup_script_.assign(step_setup_script.data(), step_setup_script.size());
 }
 
-void Sequence::throw_if_full() const
+void Sequence::throw_if_full(std::size_t num_new_steps) const
 {
-    if (steps_.size() == max_size())
+    if (num_new_steps > max_size() - steps_.size())
         throw Error(cat("Reached maximum sequence size (", max_size(), " steps)"));
 }
 
@@ -4,7 +4,7 @@
  * \date   Created on July 22, 2022
  * \brief  Manage and control sequences.
  *
- * \copyright Copyright 2022-2023 Deutsches Elektronen-Synchrotron (DESY), Hamburg
+ * \copyright Copyright 2022-2026 Deutsches Elektronen-Synchrotron (DESY), Hamburg
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU Lesser General Public License as published
@@ -23,13 +23,11 @@
 // SPDX-License-Identifier: LGPL-2.1-or-later
 
 #include <algorithm>
-#include <fstream>
+#include <utility>
 
-#include <gul14/substring_checks.h>
+#include <gul14/cat.h>
 
-#include "deserialize_sequence.h"
-#include "internals.h"
-#include "serialize_sequence.h"
+#include "taskolib/exceptions.h"
 #include "taskolib/SequenceManager.h"
 
 using gul14::cat;
@@ -45,95 +43,34 @@ bool contains_id(const std::vector<SequenceManager::SequenceOnDisk>& sequences,
         [&uid](const auto& seq) { return seq.unique_id == uid; });
 }
 
-/// Create the filename. Push the extra leading zero to the step numberings (ie. leading
-/// zeros) to order them alphabetically.
-std::string extract_filename_step(const int number, int max_digits, const Step& step)
-{
-    std::ostringstream ss;
-    ss << "step_" << std::setw(max_digits) << std::setfill('0') << number << '_'
-       << to_string(step.get_type()) << ".lua";
-    return ss.str();
-}
-
-void remove_path(const std::filesystem::path& folder)
-{
-    try
-    {
-        if (std::filesystem::exists(folder))
-            std::filesystem::remove(folder); // remove previous stored step
-    }
-    catch (const std::exception& e)
-    {
-        throw Error(cat("I/O error: ", e.what()));
-    }
-}
-
-void store_sequence_parameters(const std::filesystem::path& lua_file, const Sequence& seq)
-{
-    remove_path(lua_file);
-
-    std::ofstream stream(lua_file);
-
-    if (not stream.is_open())
-        throw Error(gul14::cat("I/O error: unable to open file (", lua_file.string(), ")"));
-
-    if (not seq.get_maintainers().empty())
-        stream << "-- maintainers: " << seq.get_maintainers() << '\n';
-
-    stream << "-- label: " << seq.get_label() << '\n';
+} // anonymous namespace
 
-    stream << "-- timeout: ";
-    if (!isfinite(seq.get_timeout()))
-        stream << "infinite\n";
-    else
-        stream << static_cast<std::chrono::milliseconds>(seq.get_timeout()).count() << '\n';
 
-    stream << seq; // RAII closes the stream (let the destructor do the job)
-}
+SequenceManager::SequenceManager(std::filesystem::path path, StorageFormat format)
+    : storage_{ std::make_shared<FolderSequenceStorage>(std::move(path), format) }
+{}
 
-} // anonymous namespace
-
-SequenceManager::SequenceManager(std::filesystem::path path)
-    : path_{ std::move(path) }
+SequenceManager::SequenceManager(std::shared_ptr<SequenceStorage> storage)
+    : storage_{ std::move(storage) }
 {
-    if (path_.empty())
-        throw Error("Base path name for sequences must not be empty");
+    if (storage_ == nullptr)
+        throw Error("Sequence storage must not be null");
 }
 
 Sequence
 SequenceManager::copy_sequence(UniqueId original_uid, const SequenceName& new_name) const
 {
-    const auto sequences = list_sequences();
-    const UniqueId new_unique_id = create_unique_id(sequences);
-
-    Sequence sequence = load_sequence(original_uid, sequences);
-
-    sequence.set_unique_id(new_unique_id);
-    sequence.set_name(new_name);
-
-    store_sequence(sequence);
+    const UniqueId new_unique_id = create_unique_id(storage_->list_sequences());
 
-    return sequence;
+    storage_->copy_sequence(original_uid, new_name, new_unique_id);
+    return storage_->load_sequence(new_unique_id);
 }
 
-Sequence
-SequenceManager::create_sequence(gul14::string_view label, SequenceName name) const
+Sequence SequenceManager::create_sequence(gul14::string_view label, SequenceName name) const
 {
-    const auto sequences = list_sequences();
-    const UniqueId unique_id = create_unique_id(sequences);
-
-    const auto new_folder_name = make_sequence_filename(name, unique_id);
-    const auto new_path = path_ / new_folder_name;
-
-    std::error_code error;
-    std::filesystem::create_directory(new_path, error);
-    if (error)
-    {
-        throw Error(gul14::cat("Unable to create sequence folder ", new_path.string(),
-            ": ", error.message()));
-    }
-
-    return Sequence{ label, name, unique_id };
+    Sequence seq{ label, std::move(name), create_unique_id(storage_->list_sequences()) };
+    storage_->store_sequence(seq);
+    return seq;
 }
 
 UniqueId SequenceManager::create_unique_id(const std::vector<SequenceOnDisk>& sequences)
@@ -149,213 +86,78 @@ UniqueId SequenceManager::create_unique_id(const std::vector<SequenceOnDisk>& se
     throw Error("Unable to find a unique ID");
 }
 
-SequenceManager::SequenceOnDisk
-SequenceManager::find_sequence_on_disk(UniqueId uid,
-    const std::vector<SequenceManager::SequenceOnDisk>& sequences)
+std::filesystem::path SequenceManager::get_path() const
 {
-    const auto it = std::find_if(sequences.begin(), sequences.end(),
-        [uid](const auto& seq) { return seq.unique_id == uid; });
-
-    if (it == sequences.end())
-        throw Error(cat("Sequence not found: Unknown unique ID ", to_string(uid)));
+    const auto folder_storage = dynamic_cast<const FolderSequenceStorage*>(storage_.get());
+    if (folder_storage == nullptr)
+        return {};
 
-    return *it;
+    return folder_storage->get_path();
 }
 
 std::vector<SequenceManager::SequenceOnDisk> SequenceManager::list_sequences() const
 {
-    std::vector<SequenceOnDisk> sequences;
-    std::vector<std::filesystem::path> suspicious_folders;
-
-    for (const auto& entry : std::filesystem::directory_iterator{ path_ })
-    {
-        if (not entry.is_directory())
-            continue;
-        if (entry.path().filename() == ".git")
-            continue;
-
-        SequenceInfo seq_info = get_sequence_info_from_filename(
-            entry.path().filename().string());
-
-        auto rel_path = std::filesystem::relative(entry.path(), path_);
-
-        if (seq_info.name.has_value() && seq_info.unique_id.has_value())
-        {
-            sequences.push_back(SequenceOnDisk{
-                std::move(rel_path),
-                std::move(*seq_info.name),
-                std::move(*seq_info.unique_id) });
-        }
-        else
-        {
-            suspicious_folders.push_back(std::move(rel_path));
-        }
-    }
-
-    // Loop over all folders that did not have name and unique ID in their name.
-    for (const auto& folder : suspicious_folders)
-    {
-        // It could be a non-sequence folder or a sequence folder from an older version.
-        // We only believe it is the latter if it contains a sequence.lua file.
-        if (not std::filesystem::exists(path_ / folder / "sequence.lua"))
-            continue;
-
-        // So it is a sequence folder after all. We automatically generate a unique ID
-        // and rename the folder.
-        UniqueId unique_id = create_unique_id(sequences);
-
-        const auto [label, dummy1, dummy2] =
-            get_sequence_info_from_filename(folder.string());
-
-        SequenceName name = make_sequence_name_from_label(label);
-
-        const auto new_folder_name = make_sequence_filename(name, unique_id);
-
-        std::error_code error;
-        std::filesystem::rename(path_ / folder, path_ / new_folder_name, error);
-        if (error)
-        {
-            throw Error(gul14::cat("Sequence folder ", folder.string(),
-                " does not contain a unique ID and cannot be renamed to ",
-                new_folder_name, ": ", error.message()));
-        }
-
-        auto seq = load_sequence(unique_id);
-        if (seq.get_label().empty()) // legacy sequences do not store the label in the lua file
-        {
-            seq.set_label(label);
-            store_sequence(seq);
-        }
-
-        sequences.push_back(SequenceOnDisk{ new_folder_name, name, unique_id });
-    }
-
-    return sequences;
+    return storage_->list_sequences();
 }
 
 Sequence SequenceManager::load_sequence(UniqueId uid) const
 {
-    return load_sequence(uid, list_sequences());
+    return storage_->load_sequence(uid);
 }
 
 Sequence SequenceManager::load_sequence(UniqueId uid,
     const std::vector<SequenceOnDisk>& sequences) const
 {
-    const auto seq_on_disk = find_sequence_on_disk(uid, sequences);
-
-    const auto folder = path_ / seq_on_disk.path;
-
-    if (not std::filesystem::exists(folder))
-        throw Error(cat("Sequence file path does not exist: ", folder.string()));
-    else if (not std::filesystem::is_directory(folder))
-        throw Error(cat("Sequence file path is not a directory: ", folder.string()));
+    if (not contains_id(sequences, uid))
+        throw Error(cat("Sequence not found: Unknown unique ID ", to_string(uid)));
 
-    Sequence seq{ "", seq_on_disk.name, seq_on_disk.unique_id };
+    return storage_->load_sequence(uid);
+}
 
-    load_sequence_parameters(folder, seq);
+SequenceManager::SequenceHeader SequenceManager::load_sequence_header(UniqueId uid) const
+{
+    return storage_->load_sequence_header(uid);
+}
 
-    std::vector<std::filesystem::path> steps;
-    for (auto const& entry : std::filesystem::directory_iterator{folder})
-    {
-        if (entry.is_regular_file()
-            and gul14::starts_with(entry.path().filename().string(), "step_"))
-        {
-            steps.push_back(entry.path());
-        }
-    }
+std::vector<SequenceManager::SequenceHeader> SequenceManager::load_sequence_headers() const
+{
+    const auto sequences = storage_->list_sequences();
 
-    if (not steps.empty())
-    {
-        // load steps ...
-        std::sort(std::begin(steps), std::end(steps),
-            [](const auto& lhs, const auto& rhs) -> bool
-            { return lhs.filename() < rhs.filename(); });
+    std::vector<SequenceHeader> headers;
+    headers.reserve(sequences.size());
 
-        for (const auto& entry : steps)
-            seq.push_back(load_step(entry));
-    }
+    for (const auto& seq_on_disk : sequences)
+        headers.push_back(storage_->load_sequence_header(seq_on_disk.unique_id));
 
-    return seq;
+    return headers;
 }
 
-SequenceName SequenceManager::make_sequence_name_from_label(gul14::string_view label)
+std::shared_ptr<const Sequence> SequenceManager::load_sequence_snapshot(UniqueId uid) const
 {
-    std::string name;
-
-    if (label.size() > SequenceName::max_length)
-        label = label.substr(0, SequenceName::max_length);
-
-    for (const auto c : label)
-    {
-        if (gul14::contains(SequenceName::valid_characters, c))
-            name.push_back(c);
-        else
-            name.push_back('_');
-    }
-
-    return SequenceName{ name };
+    return storage_->load_sequence_snapshot(uid);
 }
 
 void SequenceManager::remove_sequence(UniqueId unique_id) const
 {
-    const auto sequences = list_sequences();
-    const auto seq_on_disk = find_sequence_on_disk(unique_id, sequences);
-    const auto path = path_ / seq_on_disk.path;
-
-    std::error_code error;
-    std::filesystem::remove_all(path, error);
-    if (error)
-    {
-        throw Error(cat("Cannot remove sequence folder ", path.string(), ": ",
-            error.message()));
-    }
+    storage_->remove_sequence(unique_id);
 }
 
 void SequenceManager::rename_sequence(UniqueId unique_id, const SequenceName& new_name)
     const
 {
-    const auto sequences = list_sequences();
-    const auto old_seq_on_disk = find_sequence_on_disk(unique_id, sequences);
-
-    const auto old_path = path_ / old_seq_on_disk.path;
-    const auto new_path = path_ / make_sequence_filename(new_name, unique_id);
-
-    std::error_code error;
-    std::filesystem::rename(old_path, new_path, error);
-    if (error)
-    {
-        throw Error(gul14::cat("Cannot rename folder ", old_path.string(),
-            " to ", new_path.string(), ": ", error.message()));
-    }
+    storage_->rename_sequence(unique_id, new_name);
 }
 
 void SequenceManager::rename_sequence(Sequence& sequence, const SequenceName& new_name)
     const
 {
-    rename_sequence(sequence.get_unique_id(), new_name);
+    storage_->rename_sequence(sequence.get_unique_id(), new_name);
     sequence.set_name(new_name);
 }
 
-void SequenceManager::store_sequence(const Sequence& seq) const
+void SequenceManager::store_sequence(const Sequence& sequence) const
 {
-    const int max_digits = int( seq.size() / 10 ) + 1;
-    const auto seq_path = path_ / make_sequence_filename(seq);
-    try
-    {
-        if (std::filesystem::exists(seq_path))
-            std::filesystem::remove_all(seq_path); // remove previous storage
-        std::filesystem::create_directories(seq_path);
-    }
-    catch (const std::exception& e)
-    {
-        throw Error(cat("I/O error: ", e.what()));
-    }
-
-    store_sequence_parameters(seq_path / sequence_lua_filename, seq);
-
-    unsigned int idx = 0;
-    for (const auto& step: seq)
-        store_step(seq_path / extract_filename_step(++idx, max_digits, step), step);
+    storage_->store_sequence(sequence);
 }
 
 } // namespace task
@@ -0,0 +1,53 @@
+/**
+ * \file   SequenceStorage.cc
+ * \author Lars Fröhlich
+ * \date   Created on October 18, 2026
+ * \brief  Generic implementations of the optional SequenceStorage operations.
+ *
+ * \copyright Copyright 2026 Deutsches Elektronen-Synchrotron (DESY), Hamburg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "serialize_sequence.h"
+#include "taskolib/SequenceStorage.h"
+
+namespace task {
+
+void SequenceStorage::copy_sequence(UniqueId original_uid, const SequenceName& new_name,
+                                    UniqueId new_uid) const
+{
+    Sequence seq = load_sequence(original_uid);
+    seq.set_name(new_name);
+    seq.set_unique_id(new_uid);
+    store_sequence(seq);
+}
+
+SequenceStorage::SequenceHeader SequenceStorage::load_sequence_header(UniqueId uid) const
+{
+    const Sequence seq = load_sequence(uid);
+
+    return SequenceHeader{ make_sequence_filename(seq), seq.get_name(), uid,
+                           seq.get_label(), seq.get_maintainers(), seq.get_timeout(),
+                           seq.size() };
+}
+
+std::shared_ptr<const Sequence> SequenceStorage::load_sequence_snapshot(UniqueId uid) const
+{
+    return std::make_shared<const Sequence>(load_sequence(uid));
+}
+
+} // namespace task
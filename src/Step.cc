@@ -22,6 +22,11 @@
 
 // SPDX-License-Identifier: LGPL-2.1-or-later
 
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+
 #include <gul14/cat.h>
 #include <gul14/finalizer.h>
 #include <gul14/trim.h>
@@ -37,91 +42,251 @@
 using namespace std::literals;
 using gul14::cat;
 
+
+namespace task {
+
 namespace {
 
-template <typename>
-[[maybe_unused]] inline constexpr bool always_false_v = false;
+// Store a value of type T under the given name in the variable table, unless the table
+// already holds an equal value of the same type. Returns a pointer to the stored value or
+// null if the table was left untouched. The comparison uses only read access, so a table
+// that shares its entries with another one is not cloned if nothing has changed.
+template <typename T, typename U>
+const VariableValue* store_if_modified(VariableTable& variables,
+    const VariableName& varname, const U& value)
+{
+    const auto it = std::as_const(variables).find(varname);
+    if (it != variables.cend())
+    {
+        const T* stored_value = std::get_if<T>(&it->second);
+        if (stored_value && *stored_value == value)
+            return nullptr;
+    }
 
-} // anonymous namespace
+    VariableValue& stored = variables[varname];
+
+    if (T* stored_value = std::get_if<T>(&stored))
+        *stored_value = value; // reuses the allocated memory for strings
+    else
+        stored = T(value);
 
+    return &stored;
+}
 
-namespace task {
+// Bookkeeping for the lazy import of context variables into a Lua state.
+struct LazyVariableImport
+{
+    const Context* context{ nullptr };
+
+    // Used variables that the script has not accessed yet; the keys refer to the
+    // interned (and therefore stable) name strings.
+    std::unordered_map<std::string_view, VariableName> pending;
+
+    // Used variables that the script has read or written
+    VariableNames accessed;
+
+    // Number of variables that have actually been copied into the Lua state
+    std::uint64_t num_imported{ 0 };
+};
+
+// Install a metatable on the global table of the Lua state that imports the given
+// variables from the context on their first access and records which of them have been
+// accessed.
+void install_lazy_variable_import(const VariableNames& varnames, const Context& context,
+                                  sol::state& lua, LazyVariableImport& state)
+{
+    state.context = &context;
+    state.pending.reserve(varnames.size());
+
+    sol::table globals = lua.globals();
+
+    for (const VariableName& varname : varnames)
+    {
+        if (context.variables.count(varname))
+        {
+            // As with the eager import, context variables replace globals of the same
+            // name that may have been defined by the step setup script.
+            globals.raw_set(varname.string(), sol::lua_nil);
+        }
+        else if (globals.raw_get<sol::object>(varname.string()).get_type()
+                 != sol::type::lua_nil)
+        {
+            // A global from the setup script is not intercepted by the metatable, so it
+            // is exported unconditionally as in the eager mode.
+            state.accessed.insert(varname);
+            continue;
+        }
+
+        state.pending.emplace(varname.string(), varname);
+    }
+
+    // Remove a name from the pending list and mark it as accessed. Returns the variable
+    // name or an empty optional if the key does not refer to a pending variable.
+    const auto mark_accessed =
+        [&state](const sol::stack_object& key) -> gul14::optional<VariableName>
+        {
+            if (key.get_type() != sol::type::string)
+                return gul14::nullopt;
+
+            const auto it = state.pending.find(key.as<std::string_view>());
+            if (it == state.pending.end())
+                return gul14::nullopt;
+
+            VariableName varname = it->second;
+            state.pending.erase(it);
+            state.accessed.insert(varname);
+            return varname;
+        };
+
+    sol::table metatable = lua.create_table();
+
+    metatable[sol::meta_function::index] =
+        [&state, mark_accessed](sol::table globals, sol::stack_object key,
+                                sol::this_state lua_state) -> sol::object
+        {
+            const auto varname = mark_accessed(key);
+            if (not varname)
+                return sol::lua_nil;
+
+            const auto it = state.context->variables.find(*varname);
+            if (it == state.context->variables.end())
+                return sol::lua_nil;
+
+            sol::object obj = make_lua_object(lua_state, it->second);
+            globals.raw_set(varname->string(), obj);
+            ++state.num_imported;
+            return obj;
+        };
+
+    metatable[sol::meta_function::new_index] =
+        [mark_accessed](sol::table globals, sol::stack_object key, sol::stack_object value)
+        {
+            mark_accessed(key);
+            globals.raw_set(key, value);
+        };
 
-void Step::copy_used_variables_from_context_to_lua(const Context& context, sol::state& lua)
+    globals[sol::metatable_key] = metatable;
+}
+
+} // anonymous namespace
+
+std::uint64_t
+Step::copy_used_variables_from_context_to_lua(const Context& context, sol::state& lua)
 {
-    VariableNames import_varnames = get_used_context_variable_names();
+    std::uint64_t num_imported = 0;
 
-    for (const VariableName& varname : import_varnames)
+    for (const VariableName& varname : used_context_variable_names_)
     {
         auto it = context.variables.find(varname);
         if (it == context.variables.end())
             continue;
 
-        std::visit(
-            [&lua, varname_str = varname.string()](auto&& value)
-            {
-                using T = std::decay_t<decltype(value)>;
-
-                if constexpr (std::is_same_v<T, VarInteger>)
-                    lua[varname_str] = LuaInteger{ value };
-                else if constexpr (std::is_same_v<T, VarFloat>)
-                    lua[varname_str] = LuaFloat{ value };
-                else if constexpr (std::is_same_v<T, VarString>)
-                    lua[varname_str] = LuaString{ value };
-                else if constexpr (std::is_same_v<T, VarBool>)
-                    lua[varname_str] = LuaBool{ value };
-                else
-                    static_assert(always_false_v<T>, "Unhandled type in variable import");
-            },
-            it->second);
+        lua[varname.string()] = make_lua_object(lua, it->second);
+        ++num_imported;
     }
+
+    return num_imported;
 }
 
-void Step::copy_used_variables_from_lua_to_context(const sol::state& lua, Context& context)
+VariableChanges
+Step::copy_used_variables_from_lua_to_context(const VariableNames& varnames,
+                                              const sol::state& lua, Context& context)
 {
-    const VariableNames export_varnames = get_used_context_variable_names();
+    VariableChanges changes;
 
-    for (const VariableName& varname : export_varnames)
+    // Only variables whose value differs from the one in the context are written back.
+    // The comparison works directly on the Lua values, so unmodified strings are neither
+    // copied nor reallocated.
+    for (const VariableName& varname : varnames)
     {
+        const VariableValue* modified_value = nullptr;
+
         sol::object var = lua.get<sol::object>(varname.string());
         switch (var.get_type())
         {
             case sol::type::number:
                 // For this check to work, SOL_SAFE_NUMERICS needs to be set to 1
                 if (var.is<LuaInteger>())
-                    context.variables[varname] = VarInteger{ var.as<LuaInteger>() };
+                {
+                    modified_value = store_if_modified<VarInteger>(context.variables,
+                        varname, var.as<LuaInteger>());
+                }
                 else
-                    context.variables[varname] = VarFloat{ var.as<LuaFloat>() };
+                {
+                    modified_value = store_if_modified<VarFloat>(context.variables,
+                        varname, var.as<LuaFloat>());
+                }
                 break;
             case sol::type::string:
-                context.variables[varname] = VarString{ var.as<LuaString>() };
+                modified_value = store_if_modified<VarString>(context.variables,
+                    varname, var.as<std::string_view>());
                 break;
             case sol::type::boolean:
-                context.variables[varname] = VarBool{ var.as<LuaBool>() };
+                modified_value = store_if_modified<VarBool>(context.variables,
+                    varname, var.as<LuaBool>());
                 break;
             case sol::type::lua_nil:
-                context.variables.erase(varname);
+                if (context.variables.erase(varname))
+                    changes.emplace_back(varname, gul14::nullopt);
                 break;
+            case sol::type::userdata:
+                if (var.is<VarFloatArray>())
+                {
+                    modified_value = store_if_modified<VarFloatArray>(context.variables,
+                        varname, var.as<const VarFloatArray&>());
+                    break;
+                }
+                if (var.is<VarIntArray>())
+                {
+                    modified_value = store_if_modified<VarIntArray>(context.variables,
+                        varname, var.as<const VarIntArray&>());
+                    break;
+                }
+                if (var.is<VarBytes>())
+                {
+                    modified_value = store_if_modified<VarBytes>(context.variables,
+                        varname, var.as<const VarBytes&>());
+                    break;
+                }
+                [[fallthrough]];
             default:
                 throw Error(cat("Variable ", varname.string(),
                     " cannot be exported because it is of the unsupported type '",
                     sol::type_name(lua.lua_state(), var.get_type()), "'."));
         }
+
+        if (modified_value)
+            changes.emplace_back(varname, *modified_value);
     }
+
+    return changes;
 }
 
 bool Step::execute_impl(Context& context, CommChannel* comm,
                         OptionalStepIndex opt_step_index,
-                        TimeoutTrigger* sequence_timeout)
+                        TimeoutTrigger* sequence_timeout, StepStatistics& statistics)
 {
+    VmCounters vm_counters; // must outlive the Lua state
+    LazyVariableImport lazy_import; // must outlive the Lua state
     sol::state lua;
 
+    // Copy the counters before the Lua state is closed (and runs its finalizers)
+    const auto copy_statistics =
+        gul14::finally([&]() { statistics = vm_counters.statistics; });
+
     open_safe_library_subset(lua);
     install_custom_commands(lua);
 
+    if (not context.constants.empty())
+        install_constant_table(lua, context.constants);
+
+    if (context.blackboard)
+        install_blackboard(lua, *context.blackboard);
+
     if (context.step_setup_function)
         context.step_setup_function(lua);
 
+    install_vm_counters(lua, vm_counters);
     install_timeout_and_termination_request_hook(lua, Clock::now(), get_timeout(),
                                                  opt_step_index, context, comm,
                                                  sequence_timeout);
@@ -133,9 +298,35 @@ bool Step::execute_impl(Context& context, CommChannel* comm,
             throw Error(gul14::cat("[setup] ",std::get<std::string>(result_or_error)));
     }
 
-    copy_used_variables_from_context_to_lua(context, lua);
+    const VariableNames* export_varnames = &used_context_variable_names_;
+
+    if (context.variable_import_mode == VariableImportMode::lazy)
+    {
+        install_lazy_variable_import(used_context_variable_names_, context, lua,
+                                     lazy_import);
+        export_varnames = &lazy_import.accessed;
+    }
+    else
+    {
+        vm_counters.statistics.num_imported_variables =
+            copy_used_variables_from_context_to_lua(context, lua);
+    }
+
     const auto result_or_error = execute_lua_script(lua, get_script());
-    copy_used_variables_from_lua_to_context(lua, context);
+
+    if (context.variable_import_mode == VariableImportMode::lazy)
+        vm_counters.statistics.num_imported_variables = lazy_import.num_imported;
+
+    auto changes = copy_used_variables_from_lua_to_context(*export_varnames, lua, context);
+    vm_counters.statistics.num_exported_variables = changes.size();
+
+    if (not changes.empty())
+    {
+        Message msg{ Message::Type::context_variables_changed, "Context variables changed",
+                     Clock::now(), opt_step_index };
+        msg.set_variable_changes(std::move(changes));
+        send_message(std::move(msg), context, comm);
+    }
 
     if (std::holds_alternative<std::string>(result_or_error))
         throw Error(std::get<std::string>(result_or_error));
@@ -175,23 +366,34 @@ bool Step::execute(Context& context, CommChannel* comm, OptionalStepIndex index,
     set_running(true);
     send_message(Message::Type::step_started, "Step started", now, index, context, comm);
 
+    StepStatistics statistics;
+
     try
     {
-        const bool result = execute_impl(context, comm, index, sequence_timeout);
+        const bool result = execute_impl(context, comm, index, sequence_timeout,
+                                         statistics);
+        statistics_ += statistics;
 
-        send_message(Message::Type::step_stopped,
+        Message msg{ Message::Type::step_stopped,
             requires_bool_return_value(get_type())
                 ? cat("Step finished (logical result: ", result ? "true" : "false", ')')
                 : "Step finished"s,
-            Clock::now(), index, context, comm);
+            Clock::now(), index };
+        msg.set_statistics(statistics);
+        send_message(std::move(msg), context, comm);
 
         return result;
     }
     catch(const std::exception& e)
     {
-        auto [msg, _] = remove_abort_markers(e.what());
-        send_message(Message::Type::step_stopped_with_error, msg, Clock::now(), index,
-                     context, comm);
+        statistics_ += statistics;
+
+        auto [text, _] = remove_abort_markers(e.what());
+        Message msg{ Message::Type::step_stopped_with_error, std::move(text),
+                     Clock::now(), index };
+        msg.set_statistics(statistics);
+        send_message(std::move(msg), context, comm);
+
         throw Error(e.what(), index);
     }
 }
@@ -238,6 +440,19 @@ Step& Step::set_script(const std::string& script)
     return *this;
 }
 
+Step& Step::set_script(std::string&& script)
+{
+    script_ = std::move(script);
+    set_time_of_last_modification(Clock::now());
+    return *this;
+}
+
+Step& Step::set_statistics(const StepStatistics& statistics)
+{
+    statistics_ = statistics;
+    return *this;
+}
+
 Step& Step::set_time_of_last_execution(TimePoint t)
 {
     time_of_last_execution_ = t;
@@ -0,0 +1,322 @@
+/**
+ * \file   TraceRecorder.cc
+ * \author Lars Fröhlich
+ * \date   Created on October 18, 2026
+ * \brief  Implementation of the TraceRecorder class.
+ *
+ * \copyright Copyright 2026 Deutsches Elektronen-Synchrotron (DESY), Hamburg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include <algorithm>
+#include <cstdio>
+
+#include <gul14/cat.h>
+#include <gul14/join_split.h>
+#include <gul14/substring_checks.h>
+
+#include "taskolib/TraceRecorder.h"
+
+using gul14::cat;
+
+namespace task {
+
+namespace {
+
+// Return the given string as a quoted JSON string literal.
+std::string json_string(gul14::string_view str)
+{
+    std::string result;
+    result.reserve(str.size() + 2);
+    result += '"';
+
+    for (const char c : str)
+    {
+        switch (c)
+        {
+        case '"': result += "\\\""; break;
+        case '\\': result += "\\\\"; break;
+        case '\n': result += "\\n"; break;
+        case '\r': result += "\\r"; break;
+        case '\t': result += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                char buf[8];
+                std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned int>(c));
+                result += buf;
+            }
+            else
+            {
+                result += c;
+            }
+        }
+    }
+
+    result += '"';
+    return result;
+}
+
+// Return the timestamp in microseconds since the epoch.
+long long to_us(TimePoint t)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        t.time_since_epoch()).count();
+}
+
+} // anonymous namespace
+
+
+TraceRecorder::TraceRecorder(const Sequence& sequence)
+{
+    steps_.reserve(sequence.size());
+    enclosing_blocks_.reserve(sequence.size());
+
+    // Block indices of all currently open blocks; IF blocks are only tracked as
+    // placeholders so that the matching END can be found.
+    constexpr std::size_t if_placeholder = static_cast<std::size_t>(-1);
+    std::vector<std::size_t> stack;
+
+    const auto current_blocks =
+        [&stack]()
+        {
+            std::vector<std::size_t> blocks;
+            std::copy_if(stack.begin(), stack.end(), std::back_inserter(blocks),
+                [](std::size_t idx) { return idx != if_placeholder; });
+            return blocks;
+        };
+
+    const auto add_block =
+        [this, &stack](BlockType type, StepIndex idx, const std::string& label)
+        {
+            blocks_.push_back(Block{ type, idx, label });
+            stack.push_back(blocks_.size() - 1);
+        };
+
+    for (StepIndex idx = 0; idx != sequence.size(); ++idx)
+    {
+        const Step& step = sequence[idx];
+        steps_.emplace_back(
+            step.get_label().empty() ? cat("Step ", idx) : step.get_label(),
+            step.get_type());
+
+        switch (step.get_type())
+        {
+        case Step::type_while:
+            add_block(BlockType::while_loop, idx, step.get_label());
+            enclosing_blocks_.push_back(current_blocks());
+            add_block(BlockType::while_iteration, idx, step.get_label());
+            break;
+
+        case Step::type_try:
+            enclosing_blocks_.push_back(current_blocks());
+            add_block(BlockType::try_block, idx, step.get_label());
+            break;
+
+        case Step::type_catch:
+            if (not stack.empty())
+                stack.pop_back();
+            enclosing_blocks_.push_back(current_blocks());
+            add_block(BlockType::catch_block, idx, step.get_label());
+            break;
+
+        case Step::type_if:
+            enclosing_blocks_.push_back(current_blocks());
+            stack.push_back(if_placeholder);
+            break;
+
+        case Step::type_end:
+            if (not stack.empty())
+            {
+                const auto block_idx = stack.back();
+                stack.pop_back();
+                if (block_idx != if_placeholder
+                    && blocks_[block_idx].type == BlockType::while_iteration
+                    && not stack.empty())
+                {
+                    stack.pop_back(); // the loop itself
+                }
+            }
+            enclosing_blocks_.push_back(current_blocks());
+            break;
+
+        case Step::type_action:
+        case Step::type_elseif:
+        case Step::type_else:
+            enclosing_blocks_.push_back(current_blocks());
+            break;
+        }
+    }
+}
+
+void TraceRecorder::add_event(char phase, gul14::string_view name,
+                              gul14::string_view category, TimePoint t,
+                              gul14::string_view args)
+{
+    std::string event = cat("{\"name\":", json_string(name),
+                            ",\"cat\":", json_string(category),
+                            ",\"ph\":\"", phase, "\",\"ts\":", to_us(t),
+                            ",\"pid\":1,\"tid\":1");
+
+    if (phase == 'i')
+        event += ",\"s\":\"t\"";
+
+    if (not args.empty())
+    {
+        event += ",\"args\":";
+        event.append(args.data(), args.size());
+    }
+
+    event += '}';
+    events_.push_back(std::move(event));
+}
+
+void TraceRecorder::clear()
+{
+    events_.clear();
+    open_blocks_.clear();
+    open_sequence_name_.clear();
+    open_step_ = gul14::nullopt;
+}
+
+std::string TraceRecorder::get_json() const
+{
+    return cat("{\"traceEvents\":[\n", gul14::join(events_, ",\n"),
+               "\n],\"displayTimeUnit\":\"ms\"}\n");
+}
+
+void TraceRecorder::record(const Message& msg)
+{
+    const TimePoint t = msg.get_timestamp();
+    const OptionalStepIndex idx = msg.get_index();
+    const std::string text_args = cat("{\"text\":", json_string(msg.get_text()), '}');
+
+    const auto close_open_step =
+        [this, t]()
+        {
+            if (not open_step_)
+                return;
+
+            const auto& [name, type] = steps_[*open_step_];
+            add_event('E', name, to_string(type), t);
+            open_step_ = gul14::nullopt;
+        };
+
+    switch (msg.get_type())
+    {
+    case Message::Type::output:
+        add_event('i', "print", "output", t, text_args);
+        break;
+
+    case Message::Type::sequence_started:
+    {
+        gul14::string_view name = msg.get_text();
+        if (gul14::ends_with(name, " started"))
+            name.remove_suffix(8);
+
+        open_sequence_name_ = std::string(name);
+        add_event('B', open_sequence_name_, "sequence", t);
+        break;
+    }
+
+    case Message::Type::sequence_stopped_with_error:
+        add_event('i', "error", "error", t, text_args);
+        [[fallthrough]];
+
+    case Message::Type::sequence_stopped:
+        close_open_step();
+        transition_to({}, t);
+        if (not open_sequence_name_.empty())
+        {
+            add_event('E', open_sequence_name_, "sequence", t);
+            open_sequence_name_.clear();
+        }
+        break;
+
+    case Message::Type::step_started:
+        close_open_step();
+        if (not idx || *idx >= steps_.size())
+            break;
+
+        transition_to(enclosing_blocks_[*idx], t);
+        add_event('B', steps_[*idx].first, to_string(steps_[*idx].second), t,
+                  cat("{\"index\":", *idx, '}'));
+        open_step_ = idx;
+        break;
+
+    case Message::Type::step_stopped_with_error:
+        add_event('i', "error", "error", t, text_args);
+        close_open_step();
+        break;
+
+    case Message::Type::step_stopped:
+        close_open_step();
+        break;
+
+    case Message::Type::context_variables_changed:
+    case Message::Type::undefined:
+        break;
+    }
+}
+
+void TraceRecorder::transition_to(const std::vector<std::size_t>& blocks, TimePoint t)
+{
+    // Find the common prefix of the currently open blocks and the requested ones
+    const auto mismatch = std::mismatch(open_blocks_.begin(), open_blocks_.end(),
+                                        blocks.begin(), blocks.end());
+    const auto num_common = static_cast<std::size_t>(mismatch.first - open_blocks_.begin());
+
+    const auto block_name =
+        [this](const Block& block) -> std::string
+        {
+            switch (block.type)
+            {
+            case BlockType::while_loop:
+                return cat("WHILE ", block.label);
+            case BlockType::while_iteration:
+                return cat("Iteration ", block.num_iterations);
+            case BlockType::try_block:
+                return "TRY";
+            case BlockType::catch_block:
+                return "CATCH";
+            }
+            return "";
+        };
+
+    while (open_blocks_.size() > num_common)
+    {
+        const Block& block = blocks_[open_blocks_.back()];
+        add_event('E', block_name(block), "block", t);
+        open_blocks_.pop_back();
+    }
+
+    for (auto it = blocks.begin() + num_common; it != blocks.end(); ++it)
+    {
+        Block& block = blocks_[*it];
+
+        if (block.type == BlockType::while_loop)
+            blocks_[*it + 1].num_iterations = 0; // the iteration block follows the loop
+        else if (block.type == BlockType::while_iteration)
+            ++block.num_iterations;
+
+        add_event('B', block_name(block), "block", t,
+                  cat("{\"index\":", block.head_index, '}'));
+        open_blocks_.push_back(*it);
+    }
+}
+
+} // namespace task
@@ -4,7 +4,7 @@
  * \date   Created on January 6, 2022
  * \brief  Implementation of the VariableName class.
  *
- * \copyright Copyright 2022 Deutsches Elektronen-Synchrotron (DESY), Hamburg
+ * \copyright Copyright 2022-2026 Deutsches Elektronen-Synchrotron (DESY), Hamburg
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU Lesser General Public License as published
@@ -24,6 +24,9 @@
 
 #include <algorithm>
 #include <cctype>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
 #include <gul14/cat.h>
 #include "taskolib/exceptions.h"
 #include "taskolib/VariableName.h"
@@ -54,37 +57,93 @@ void check_name(gul14::string_view name)
     }
 }
 
-} // anonymous namespace
-
+// Set when the intern cache of the current thread has been destroyed.
+thread_local bool thread_cache_destroyed = false;
 
-VariableName::VariableName(const char* name)
+const char* checked_c_string(const char* name)
 {
     if (name == nullptr)
         throw Error("A null pointer is not a valid variable name");
-
-    check_name(name);
-    name_ = name;
+    return name;
 }
 
+} // anonymous namespace
+
+
+VariableName::VariableName(const char* name)
+    : entry_{ intern(checked_c_string(name)) }
+{}
+
 VariableName::VariableName(const std::string& name)
-{
-    check_name(name);
-    name_ = name;
-}
+    : entry_{ intern(name) }
+{}
 
 VariableName::VariableName(std::string&& name)
+    : entry_{ intern(name) }
+{}
+
+const VariableName::Entry* VariableName::intern(gul14::string_view name)
 {
-    check_name(name);
-    name_ = std::move(name);
+    // The table is intentionally leaked so that names stay valid during static
+    // destruction. The deque never moves its elements, so the keys of the map (views
+    // into the stored names) and the returned pointers remain valid.
+    struct InternTable
+    {
+        std::mutex mutex;
+        std::deque<Entry> entries;
+        std::unordered_map<gul14::string_view, const Entry*> index;
+    };
+    static InternTable& table = *new InternTable;
+
+    // Each thread remembers the names it has already looked up, so that constructing a
+    // known name does not touch the mutex. Once the cache of the thread has been
+    // destroyed (during thread exit or static destruction), only the table is used.
+    struct ThreadCache
+    {
+        std::unordered_map<gul14::string_view, const Entry*> index;
+        ~ThreadCache() { thread_cache_destroyed = true; }
+    };
+    thread_local ThreadCache cache;
+
+    if (not thread_cache_destroyed)
+    {
+        auto it = cache.index.find(name);
+        if (it != cache.index.end())
+            return it->second;
+    }
+
+    const Entry* entry = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(table.mutex);
+
+        auto it = table.index.find(name);
+        if (it != table.index.end())
+        {
+            entry = it->second;
+        }
+        else
+        {
+            check_name(name);
+
+            std::string name_str(name);
+            const auto hash = std::hash<std::string>{}(name_str);
+            const auto symbol = static_cast<std::uint32_t>(table.entries.size());
+
+            entry = &table.entries.emplace_back(
+                Entry{ std::move(name_str), hash, symbol });
+            table.index.emplace(entry->name, entry);
+        }
+    }
+
+    if (not thread_cache_destroyed)
+        cache.index.emplace(entry->name, entry);
+
+    return entry;
 }
 
 VariableName& VariableName::operator+=(gul14::string_view suffix)
 {
-    std::string new_name = name_ + suffix;
-
-    check_name(new_name);
-
-    name_ = std::move(new_name);
+    entry_ = intern(string() + suffix);
     return *this;
 }
 
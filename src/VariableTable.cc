@@ -0,0 +1,191 @@
+/**
+ * \file   VariableTable.cc
+ * \author Lars Fröhlich
+ * \date   Created on October 18, 2026
+ * \brief  Implementation of the VariableTable class and of associated free functions.
+ *
+ * \copyright Copyright 2026 Deutsches Elektronen-Synchrotron (DESY), Hamburg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <utility>
+
+#include <gul14/cat.h>
+
+#include "taskolib/VariableTable.h"
+
+using gul14::cat;
+
+namespace task {
+
+namespace {
+
+bool symbol_less(const std::pair<VariableName, VariableValue>& entry,
+                 const VariableName& name) noexcept
+{
+    return entry.first.get_symbol() < name.get_symbol();
+}
+
+template <typename Iterator>
+Iterator lower_bound(Iterator begin, Iterator end, const VariableName& name)
+{
+    return std::lower_bound(begin, end, name, symbol_less);
+}
+
+} // anonymous namespace
+
+
+VariableTable::VariableTable(std::initializer_list<value_type> init)
+{
+    reserve(init.size());
+    for (const auto& [name, value] : init)
+        emplace(name, value);
+}
+
+const VariableValue& VariableTable::at(const VariableName& name) const
+{
+    auto it = find(name);
+    if (it == end())
+        throw std::out_of_range(cat("Unknown variable \"", name.string(), '"'));
+    return it->second;
+}
+
+VariableTable::iterator VariableTable::begin()
+{
+    return iterator{ mutable_entries().begin() };
+}
+
+std::pair<VariableTable::iterator, bool>
+VariableTable::emplace(const VariableName& name, VariableValue value)
+{
+    Entries& entries = mutable_entries();
+
+    auto it = lower_bound(entries.begin(), entries.end(), name);
+    if (it != entries.end() && it->first == name)
+        return { iterator{ it }, false };
+
+    return { iterator{ entries.emplace(it, name, std::move(value)) }, true };
+}
+
+VariableTable::iterator VariableTable::end()
+{
+    return iterator{ mutable_entries().end() };
+}
+
+const VariableTable::Entries& VariableTable::entries() const noexcept
+{
+    static const Entries empty_entries;
+    return entries_ ? *entries_ : empty_entries;
+}
+
+VariableTable::size_type VariableTable::erase(const VariableName& name)
+{
+    const auto it = std::as_const(*this).find(name);
+    if (it == cend())
+        return 0; // avoid cloning shared entries
+
+    erase(it);
+    return 1;
+}
+
+VariableTable::iterator VariableTable::erase(const_iterator pos)
+{
+    // The iterator may refer to shared entries that are cloned by mutable_entries()
+    const auto offset = pos.it_ - entries().begin();
+    Entries& entries = mutable_entries();
+    return iterator{ entries.erase(entries.begin() + offset) };
+}
+
+VariableTable::iterator VariableTable::find(const VariableName& name)
+{
+    Entries& entries = mutable_entries();
+
+    auto it = lower_bound(entries.begin(), entries.end(), name);
+    return iterator{ (it != entries.end() && it->first == name) ? it : entries.end() };
+}
+
+VariableTable::const_iterator VariableTable::find(const VariableName& name) const
+{
+    const Entries& entries = this->entries();
+
+    auto it = lower_bound(entries.begin(), entries.end(), name);
+    return const_iterator{
+        (it != entries.end() && it->first == name) ? it : entries.end() };
+}
+
+std::pair<VariableTable::iterator, bool>
+VariableTable::insert_or_assign(const VariableName& name, VariableValue value)
+{
+    Entries& entries = mutable_entries();
+
+    auto it = lower_bound(entries.begin(), entries.end(), name);
+    if (it != entries.end() && it->first == name)
+    {
+        it->second = std::move(value);
+        return { iterator{ it }, false };
+    }
+
+    return { iterator{ entries.emplace(it, name, std::move(value)) }, true };
+}
+
+VariableTable::Entries& VariableTable::mutable_entries()
+{
+    if (not entries_)
+    {
+        entries_ = std::make_shared<Entries>();
+    }
+    else if (entries_.use_count() != 1)
+    {
+        entries_ = std::make_shared<Entries>(*entries_);
+    }
+    else
+    {
+        // We hold the only reference, so no other table can start sharing the entries.
+        // The count is read with relaxed ordering; the fence synchronizes with the
+        // release of the last other reference, so its reads happen before our writes.
+        std::atomic_thread_fence(std::memory_order_acquire);
+    }
+
+    return *entries_;
+}
+
+VariableValue& VariableTable::operator[](const VariableName& name)
+{
+    Entries& entries = mutable_entries();
+
+    auto it = lower_bound(entries.begin(), entries.end(), name);
+    if (it == entries.end() || it->first != name)
+        it = entries.emplace(it, name, VariableValue{});
+
+    return it->second;
+}
+
+void apply_variable_changes(VariableTable& variables, const VariableChanges& changes)
+{
+    for (const auto& [name, opt_value] : changes)
+    {
+        if (opt_value)
+            variables.insert_or_assign(name, *opt_value);
+        else
+            variables.erase(name);
+    }
+}
+
+} // namespace task
@@ -24,11 +24,14 @@
 
 #include <algorithm>
 #include <cctype>
+#include <charconv>
 #include <chrono>
+#include <cstdint>
 #include <ctime>
 #include <fstream>
-#include <set>
-#include <sstream>
+#include <iterator>
+#include <limits>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -36,6 +39,7 @@
 
 #include "deserialize_sequence.h"
 #include "internals.h"
+#include "MappedFile.h"
 #include "taskolib/hash_string.h"
 
 using gul14::cat;
@@ -165,18 +169,111 @@ void extract_context_variable_names(gul14::string_view extract, Step& step)
     auto end = extract.find("]");
     if (end == gul14::string_view::npos)
         throw Error("context variable names: cannot find trailing ']'");
+    extract = extract.substr(0, end);
+
     VariableNames variableNames{};
-    for (auto variable: gul14::split(extract.substr(0, end), std::regex{"[ \t]*,[ \t]*"})) {
-        variable = gul14::trim(variable);
+    while (not extract.empty())
+    {
+        const auto comma = extract.find(',');
+        const auto variable = gul14::trim_sv(extract.substr(0, comma));
         if (not variable.empty())
-            variableNames.emplace(variable);
+            variableNames.emplace(std::string{ variable });
+
+        if (comma == gul14::string_view::npos)
+            break;
+        extract.remove_prefix(comma + 1);
     }
     if (not variableNames.empty())
         step.set_used_context_variable_names(variableNames);
 }
 
+/// Return the number of days between 1970-01-01 and the given date (proleptic Gregorian).
+std::int64_t days_from_civil(std::int64_t y, unsigned int m, unsigned int d) noexcept
+{
+    y -= m <= 2;
+    const std::int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const auto yoe = static_cast<unsigned int>(y - era * 400);
+    const unsigned int doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    const unsigned int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<std::int64_t>(doe) - 719468;
+}
+
+/// Parse a fixed number of decimal digits, returning -1 if a non-digit is encountered.
+int parse_digits(gul14::string_view str, std::size_t pos, std::size_t num_digits) noexcept
+{
+    int value = 0;
+    for (std::size_t i = pos; i != pos + num_digits; ++i)
+    {
+        const auto c = str[i];
+        if (c < '0' or c > '9')
+            return -1;
+        value = 10 * value + (c - '0');
+    }
+    return value;
+}
+
+/**
+ * Decode a local time in the fixed format "YYYY-MM-DD HH:MM:SS" without going through
+ * strptime() and mktime() for every call.
+ *
+ * The offset between local time and UTC is determined with mktime() once per local hour
+ * and cached per thread, so that a sequence of similar timestamps requires no time zone
+ * lookups. An empty optional is returned if the string does not have the exact format.
+ */
+gul14::optional<TimePoint> decode_timestamp(gul14::string_view str)
+{
+    str = gul14::trim_sv(str);
+    if (str.size() != 19 or str[4] != '-' or str[7] != '-' or str[10] != ' '
+        or str[13] != ':' or str[16] != ':')
+    {
+        return gul14::nullopt;
+    }
+
+    const int year = parse_digits(str, 0, 4);
+    const int month = parse_digits(str, 5, 2);
+    const int day = parse_digits(str, 8, 2);
+    const int hour = parse_digits(str, 11, 2);
+    const int minute = parse_digits(str, 14, 2);
+    const int second = parse_digits(str, 17, 2);
+
+    if (year < 1900 or month < 1 or month > 12 or day < 1 or day > 31 or hour < 0
+        or hour > 23 or minute < 0 or minute > 59 or second < 0 or second > 59)
+    {
+        return gul14::nullopt;
+    }
+
+    // Seconds since the epoch as if the local time were UTC
+    const std::int64_t naive_hour = days_from_civil(year, month, day) * 24 + hour;
+
+    struct OffsetCache
+    {
+        std::int64_t naive_hour{ std::numeric_limits<std::int64_t>::min() };
+        std::int64_t offset_s{ 0 };
+    };
+    thread_local OffsetCache cache;
+
+    if (cache.naive_hour != naive_hour)
+    {
+        std::tm t{};
+        t.tm_year = year - 1900;
+        t.tm_mon = month - 1;
+        t.tm_mday = day;
+        t.tm_hour = hour;
+        t.tm_isdst = -1; // Daylight Saving Time (DST) is unknown -> use local time zone
+        cache.offset_s = static_cast<std::int64_t>(std::mktime(&t)) - naive_hour * 3600;
+        cache.naive_hour = naive_hour;
+    }
+
+    const std::int64_t t = naive_hour * 3600 + minute * 60 + second + cache.offset_s;
+    return TimePoint::clock::from_time_t(static_cast<std::time_t>(t));
+}
+
 TimePoint extract_time(const std::string& issue, gul14::string_view extract)
 {
+    if (auto decoded = decode_timestamp(extract))
+        return *decoded;
+
+    // Fall back to the general parser for anything but the standard format
     std::tm t;
 
     if (strptime(std::string{ extract }.c_str(), "%Y-%m-%d %H:%M:%S",&t) == nullptr)
@@ -218,12 +315,58 @@ Timeout parse_timeout(gul14::string_view extract)
 
 void extract_disabled(gul14::string_view extract, Step& step)
 {
-    bool val{ };
-    std::stringstream ss{ std::string{ extract } };
-    ss >> std::boolalpha >> val;
-    if (ss.fail())
+    extract = gul14::trim_sv(extract);
+    const auto word = extract.substr(0, extract.find_first_of(" \t"));
+
+    if (word == "true")
+        step.set_disabled(true);
+    else if (word == "false")
+        step.set_disabled(false);
+    else
         throw Error("disabled: unknown value, expect true or false");
-    step.set_disabled(val);
+}
+
+/// A read-only stream buffer that reads directly from a string_view without copying it.
+class ViewStreamBuffer : public std::streambuf
+{
+public:
+    explicit ViewStreamBuffer(gul14::string_view view)
+    {
+        char* begin = const_cast<char*>(view.data());
+        setg(begin, begin, begin + view.size());
+    }
+};
+
+/// Parse the header line "-- <keyword>: <value>" of a sequence archive.
+gul14::string_view parse_archive_header_line(gul14::string_view& data,
+    gul14::string_view prefix, const std::filesystem::path& file)
+{
+    const auto end = data.find('\n');
+    if (end == data.npos or not gul14::starts_with(data, prefix))
+    {
+        throw Error(cat("Invalid sequence archive '", file.string(),
+                        "': Missing header line '", prefix, "'"));
+    }
+
+    auto value = data.substr(prefix.size(), end - prefix.size());
+    data.remove_prefix(end + 1);
+    return value;
+}
+
+/// Parse an unsigned number from the start of str and remove it (and trailing spaces).
+std::size_t parse_archive_number(gul14::string_view& str, const std::filesystem::path& file)
+{
+    std::size_t value{};
+    const auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+    if (ec != std::errc{})
+    {
+        throw Error(cat("Invalid sequence archive '", file.string(),
+                        "': Unable to parse number ('", str, "')"));
+    }
+
+    str.remove_prefix(ptr - str.data());
+    str = gul14::trim_left_sv(str);
+    return value;
 }
 
 } // anonymous namespace
@@ -257,146 +400,267 @@ SequenceInfo get_sequence_info_from_filename(gul14::string_view filename)
 
 std::istream& operator>>(std::istream& stream, Step& step)
 {
+    const std::string content{ std::istreambuf_iterator<char>{ stream },
+                               std::istreambuf_iterator<char>{} };
+
+    if (stream.bad())
+        throw Error(gul14::cat("I/O error: serious error on file system (bad flag is set)"));
+
+    stream.setstate(std::ios::eofbit);
+
+    step = parse_step(content);
+
+    return stream;
+}
+
+Step load_step(const std::filesystem::path& lua_file)
+{
+    std::unique_ptr<MappedFile> mapped_file;
+
+    try
+    {
+        mapped_file = std::make_unique<MappedFile>(lua_file);
+    }
+    catch (const Error&)
+    {
+        throw Error(gul14::cat("I/O error: unable to open file '", lua_file.string(), "'"));
+    }
+
+    return parse_step(mapped_file->view());
+}
+
+Step parse_step(gul14::string_view content)
+{
+    enum KeywordFlag : unsigned int
+    {
+        kw_type = 1, kw_label = 2, kw_variables = 4, kw_modification = 8,
+        kw_execution = 16, kw_timeout = 32, kw_disabled = 64
+    };
+
     TimePoint last_modification{}; // since any manipulation on step sets a new time point
-    std::string line;
-    std::stringstream script;
-    bool load_script = false; // flag to store non Step properties to the script
-    bool has_type = false; // sanity check: must have type
-    bool has_label = false; // sanity check: must have label
-    std::set<unsigned long> encountered_keywords; // validate multiple keyword definition
-    Step step_internal; // temporary Step. Will be move to step after loading
+    unsigned int encountered_keywords = 0; // validate multiple keyword definition
+    Step step;
 
-    while(std::getline(stream, line, '\n'))
+    std::size_t pos = 0;
+    while (pos < content.size())
     {
-        if (load_script)
+        auto line_end = content.find('\n', pos);
+        if (line_end == gul14::string_view::npos)
+            line_end = content.size();
+
+        const auto [keyword, remaining_line] =
+            extract_keyword(content.substr(pos, line_end - pos));
+
+        if (keyword.empty() && gul14::trim_sv(remaining_line).empty()) // nothing useful
         {
-            script << line << '\n';
+            pos = line_end + 1;
             continue;
         }
-        auto [keyword, remaining_line] = extract_keyword(line);
-        if (keyword.empty() && gul14::trim_sv(remaining_line).empty()) // load_script is false -> nothing useful
-            continue;
 
-        const auto keyword_hash = hash_djb2a(keyword);
+        // Using switch cases with string hashes (see operator"" _sh in case_string.h)
+        // DJB2A hash algorithm: http://www.cse.yorku.ca/%7Eoz/hash.html
+        unsigned int flag = 0;
+        switch (hash_djb2a(keyword))
+        {
+            case "type"_sh: flag = kw_type; break;
+            case "label"_sh: flag = kw_label; break;
+            case "use context variable names"_sh: flag = kw_variables; break;
+            case "time of last modification"_sh: flag = kw_modification; break;
+            case "time of last execution"_sh: flag = kw_execution; break;
+            case "timeout"_sh: flag = kw_timeout; break;
+            case "disabled"_sh: flag = kw_disabled; break;
+            default: break;
+        }
 
-        // validate multiple keyword declaration
-        if (encountered_keywords.count(keyword_hash))
+        if (flag == 0) // The first line that is no keyword starts the script
+            break;
+
+        if (encountered_keywords & flag)
         {
             throw Error(gul14::cat("Syntax error: Encountered keyword '", keyword,
                                    "' multiple times"));
         }
-        encountered_keywords.insert(keyword_hash);
+        encountered_keywords |= flag;
 
-        // Using switch cases with string hashes (see operator"" _sh in case_string.h)
-        // DJB2A hash algorithm: http://www.cse.yorku.ca/%7Eoz/hash.html
-        // Interesting hashing algorithm comparison:
-        // https://softwareengineering.stackexchange.com/questions/49550/which-hashing-algorithm-is-best-for-uniqueness-and-speed/145633#145633
-        switch(keyword_hash)
+        switch (flag)
         {
-            case "type"_sh:
-                extract_type(remaining_line, step_internal);
-                has_type = true;
+            case kw_type:
+                extract_type(remaining_line, step);
                 break;
-
-            case "label"_sh:
-                extract_label(remaining_line, step_internal);
-                has_label = true;
+            case kw_label:
+                extract_label(remaining_line, step);
                 break;
-
-            case "use context variable names"_sh:
-                extract_context_variable_names(remaining_line, step_internal);
+            case kw_variables:
+                extract_context_variable_names(remaining_line, step);
                 break;
-
-            case "time of last modification"_sh:
-                last_modification = extract_time("time of last modification", remaining_line);
+            case kw_modification:
+                last_modification = extract_time("time of last modification",
+                                                 remaining_line);
                 break;
-
-            case "time of last execution"_sh:
-                extract_time_of_last_execution(remaining_line, step_internal);
+            case kw_execution:
+                extract_time_of_last_execution(remaining_line, step);
                 break;
-
-            case "timeout"_sh:
-                step_internal.set_timeout(parse_timeout(remaining_line));
+            case kw_timeout:
+                step.set_timeout(parse_timeout(remaining_line));
                 break;
-
-            case "disabled"_sh:
-                extract_disabled(remaining_line, step_internal);
+            case kw_disabled:
+                extract_disabled(remaining_line, step);
                 break;
-
-            default:
-                script << line << '\n';
-                load_script = true;
         }
-    }
 
-    if (stream.bad())
-        throw Error(gul14::cat("I/O error: serious error on file system (bad flag is set)"));
-    // need to get !eof (eof indicates that also the fail bit is set)
-    else if (not stream.eof() and stream.fail())
-        throw Error(gul14::cat("I/O error: failure on loading step"));
+        pos = line_end + 1;
+    }
 
-    if (not has_type) // sanity check: missing type
+    if (not (encountered_keywords & kw_type)) // sanity check: missing type
         throw Error("Step must have type declaration");
-    else if (not has_label) // sanity check: missing label
+    else if (not (encountered_keywords & kw_label)) // sanity check: missing label
         throw Error("Step must have label declaration");
 
-    if (not script.str().empty())
+    // The rest of the content is the script, without the final line break
+    if (pos < content.size())
     {
-        auto temp = script.str();
-        step_internal.set_script(temp.substr(0, temp.size() - 1)); // remove last cr
+        auto script = content.substr(pos);
+        if (script.back() == '\n')
+            script.remove_suffix(1);
+        step.set_script(std::string{ script });
     }
 
     // finally set time points ...
     if (last_modification.time_since_epoch().count() != 0LL)
-        step_internal.set_time_of_last_modification(last_modification);
+        step.set_time_of_last_modification(last_modification);
     else // sanity check: if no time is provided set it to current time
-        step_internal.set_time_of_last_modification(TimePoint::clock::now());
-
-    step = std::move(step_internal);
+        step.set_time_of_last_modification(TimePoint::clock::now());
 
-    return stream;
+    return step;
 }
 
-Step load_step(const std::filesystem::path& lua_file)
+void load_sequence_parameters(const std::filesystem::path& folder, Sequence& sequence)
 {
-    Step step{};
-    std::ifstream stream(lua_file);
+    if (not std::filesystem::exists(folder))
+        throw Error(gul14::cat("Folder does not exist: '", folder.string(), '\''));
 
-    if (not stream.is_open())
-        throw Error(gul14::cat("I/O error: unable to open file '", lua_file.string(), "'"));
+    auto stream = std::ifstream(folder / sequence_lua_filename);
+    if (stream.good())
+        load_sequence_parameters(stream, sequence);
+    else
+        sequence.set_step_setup_script("");
+}
 
-    stream >> step; // RAII closes the stream (let the destructor do the job)
+void load_sequence_parameters(std::istream& stream, Sequence& sequence)
+{
+    std::string step_setup_script;
+    std::string line;
 
-    return step;
+    while(std::getline(stream, line, '\n'))
+    {
+        auto keyword = gul14::trim_left_sv(line);
+
+        if (gul14::starts_with(keyword, "-- maintainers:"))
+            sequence.set_maintainers(keyword.substr(15));
+        else if (gul14::starts_with(keyword, "-- label:"))
+            sequence.set_label(gul14::trim_sv(keyword.substr(9)));
+        else if (gul14::starts_with(keyword, "-- timeout:"))
+            sequence.set_timeout(parse_timeout(keyword.substr(11)));
+        else
+            step_setup_script += (line + '\n');
+    }
+
+    sequence.set_step_setup_script(step_setup_script);
 }
 
-void load_sequence_parameters(const std::filesystem::path& folder, Sequence& sequence)
+namespace {
+
+// Parse the header and index of a mapped sequence archive and return views on all of its
+// entries. Entry 0 holds the sequence parameters, the others hold the steps.
+std::vector<gul14::string_view>
+parse_archive_entries(gul14::string_view data, const std::filesystem::path& file)
 {
-    if (not std::filesystem::exists(folder))
-        throw Error(gul14::cat("Folder does not exist: '", folder.string(), '\''));
+    auto version = parse_archive_header_line(data, "-- taskolib sequence archive: ", file);
+    if (parse_archive_number(version, file) != 1)
+    {
+        throw Error(cat("Unsupported sequence archive version in '", file.string(),
+                        "'"));
+    }
 
-    std::string step_setup_script;
+    auto num_str = parse_archive_header_line(data, "-- entries: ", file);
+    const std::size_t num_entries = parse_archive_number(num_str, file);
 
-    auto stream = std::ifstream(folder / sequence_lua_filename);
-    if (stream.good())
+    // Each index line has at least 6 characters, which bounds the entry count
+    if (num_entries == 0 or num_entries > data.size() / 6)
     {
-        std::string line;
-        while(std::getline(stream, line, '\n'))
+        throw Error(cat("Invalid sequence archive '", file.string(),
+                        "': Bad number of entries (", num_entries, ")"));
+    }
+
+    std::vector<std::pair<std::size_t, std::size_t>> index; // offset and size
+    index.reserve(num_entries);
+
+    for (std::size_t i = 0; i != num_entries; ++i)
+    {
+        auto line = parse_archive_header_line(data, "-- ", file);
+        const std::size_t offset = parse_archive_number(line, file);
+        const std::size_t size = parse_archive_number(line, file);
+        index.emplace_back(offset, size);
+    }
+
+    // After the header, data starts with the first entry
+    std::vector<gul14::string_view> entries;
+    entries.reserve(num_entries);
+
+    for (const auto& [offset, size] : index)
+    {
+        if (offset > data.size() or size > data.size() - offset)
         {
-            auto keyword = gul14::trim_left_sv(line);
-
-            if (gul14::starts_with(keyword, "-- maintainers:"))
-                sequence.set_maintainers(keyword.substr(15));
-            else if (gul14::starts_with(keyword, "-- label:"))
-                sequence.set_label(gul14::trim_sv(keyword.substr(9)));
-            else if (gul14::starts_with(keyword, "-- timeout:"))
-                sequence.set_timeout(parse_timeout(keyword.substr(11)));
-            else
-                step_setup_script += (line + '\n');
+            throw Error(cat("Invalid sequence archive '", file.string(),
+                            "': Entry exceeds the file size"));
         }
+        entries.push_back(data.substr(offset, size));
     }
 
-    sequence.set_step_setup_script(step_setup_script);
+    return entries;
+}
+
+void load_archive_parameters(gul14::string_view entry, Sequence& sequence)
+{
+    ViewStreamBuffer buffer{ entry };
+    std::istream stream{ &buffer };
+    load_sequence_parameters(stream, sequence);
+}
+
+} // anonymous namespace
+
+void load_sequence_archive(const std::filesystem::path& file, Sequence& sequence)
+{
+    const MappedFile mapped_file{ file };
+    load_sequence_archive(mapped_file.view(), file, sequence);
+}
+
+void load_sequence_archive(gul14::string_view data, const std::filesystem::path& file,
+                           Sequence& sequence)
+{
+    const auto entries = parse_archive_entries(data, file);
+
+    load_archive_parameters(entries[0], sequence);
+
+    std::vector<Step> steps;
+    steps.reserve(entries.size() - 1);
+
+    for (std::size_t i = 1; i < entries.size(); ++i)
+        steps.push_back(parse_step(entries[i]));
+
+    sequence.insert(sequence.end(), std::make_move_iterator(steps.begin()),
+        std::make_move_iterator(steps.end()));
+}
+
+std::size_t load_sequence_archive_parameters(const std::filesystem::path& file,
+                                             Sequence& sequence)
+{
+    const MappedFile mapped_file{ file };
+    const auto entries = parse_archive_entries(mapped_file.view(), file);
+
+    load_archive_parameters(entries[0], sequence);
+
+    return entries.size() - 1;
 }
 
 } // namespace task
@@ -29,6 +29,7 @@
 #include <iostream>
 
 #include <gul14/optional.h>
+#include <gul14/string_view.h>
 
 #include "taskolib/Sequence.h"
 #include "taskolib/SequenceName.h"
@@ -128,6 +129,19 @@ std::istream& operator>>(std::istream& stream, Step& step);
  */
 Step load_step(const std::filesystem::path& lua_file);
 
+/**
+ * Parse a Step from a buffer holding the content of a step file.
+ *
+ * This is the parser behind operator>>() and load_step(). It makes a single pass over
+ * the contiguous buffer (e.g. a memory-mapped file) and extracts the metadata from views
+ * into the buffer; the only copy of the script is the one stored in the returned Step.
+ * Timestamps in the standard format "%Y-%m-%d %H:%M:%S" are decoded without a time zone
+ * lookup for every call.
+ *
+ * \exception Error is thrown if the content is not a valid step description.
+ */
+Step parse_step(gul14::string_view content);
+
 /**
  * Load sequence parameters like the step setup script and the sequence timeout.
  *
@@ -137,6 +151,52 @@ Step load_step(const std::filesystem::path& lua_file);
  */
 void load_sequence_parameters(const std::filesystem::path& folder, Sequence& sequence);
 
+/**
+ * Load sequence parameters like the step setup script and the sequence timeout from an
+ * input stream in the format of the file `sequence.lua`.
+ */
+void load_sequence_parameters(std::istream& stream, Sequence& sequence);
+
+/**
+ * Load the parameters and all steps of a sequence from an archive file.
+ *
+ * The file is mapped into memory as a whole, and all entries are parsed directly from
+ * the mapped memory. The steps are appended to the given sequence. See
+ * store_sequence_archive() for a description of the file format.
+ *
+ * \param file      the archive file
+ * \param sequence  the sequence into which the parameters and steps are loaded
+ *
+ * \exception Error is thrown if the file cannot be read or if it is not a valid archive.
+ */
+void load_sequence_archive(const std::filesystem::path& file, Sequence& sequence);
+
+/**
+ * Load the parameters and all steps of a sequence from the content of an archive file
+ * (see make_sequence_archive()).
+ *
+ * \param data      the content of the archive
+ * \param file      the name of the archive, only used in error messages
+ * \param sequence  the sequence into which the parameters and steps are loaded
+ *
+ * \exception Error is thrown if the data is not a valid archive.
+ */
+void load_sequence_archive(gul14::string_view data, const std::filesystem::path& file,
+                           Sequence& sequence);
+
+/**
+ * Load only the sequence parameters (label, maintainers, timeout, and step setup script)
+ * from an archive file without parsing any steps.
+ *
+ * \param file      the archive file
+ * \param sequence  the sequence into which the parameters are loaded
+ * \returns the number of steps in the archive.
+ *
+ * \exception Error is thrown if the file cannot be read or if it is not a valid archive.
+ */
+std::size_t load_sequence_archive_parameters(const std::filesystem::path& file,
+                                             Sequence& sequence);
+
 } // namespace task
 
 #endif
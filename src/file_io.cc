@@ -0,0 +1,293 @@
+/**
+ * \file   file_io.cc
+ * \author Lars Fröhlich
+ * \date   Created on October 18, 2026
+ * \brief  Implementation of file input/output helpers for crash-safe storage.
+ *
+ * \copyright Copyright 2026 Deutsches Elektronen-Synchrotron (DESY), Hamburg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#endif
+
+#include <gul14/cat.h>
+
+#include "file_io.h"
+#include "taskolib/exceptions.h"
+
+using gul14::cat;
+
+namespace task {
+
+namespace {
+
+/// A file descriptor that is closed automatically.
+class FileDescriptor
+{
+public:
+    FileDescriptor(const std::filesystem::path& path, int flags, mode_t mode = 0)
+        : fd_{ ::open(path.c_str(), flags | O_CLOEXEC, mode) }
+    {
+        if (fd_ < 0)
+        {
+            throw Error(cat("I/O error: unable to open ", path.string(), ": ",
+                            std::strerror(errno)));
+        }
+    }
+
+    ~FileDescriptor() { ::close(fd_); }
+
+    FileDescriptor(const FileDescriptor&) = delete;
+    FileDescriptor& operator=(const FileDescriptor&) = delete;
+
+    int get() const noexcept { return fd_; }
+
+private:
+    int fd_;
+};
+
+void rename_or_throw(const std::filesystem::path& from, const std::filesystem::path& to)
+{
+    std::error_code error;
+    std::filesystem::rename(from, to, error);
+    if (error)
+    {
+        throw Error(cat("I/O error: cannot rename ", from.string(), " to ", to.string(),
+                        ": ", error.message()));
+    }
+}
+
+void sync_or_throw(const FileDescriptor& fd, const std::filesystem::path& path)
+{
+    if (::fsync(fd.get()) != 0)
+    {
+        throw Error(cat("I/O error: unable to synchronize ", path.string(), ": ",
+                        std::strerror(errno)));
+    }
+}
+
+void write_fd(const FileDescriptor& fd, const std::filesystem::path& file,
+              gul14::string_view content)
+{
+    while (not content.empty())
+    {
+        const auto num_written = ::write(fd.get(), content.data(), content.size());
+        if (num_written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            throw Error(cat("I/O error: unable to write ", file.string(), ": ",
+                            std::strerror(errno)));
+        }
+        content.remove_prefix(static_cast<std::size_t>(num_written));
+    }
+}
+
+/// Copy the remaining data of the file in to the file out.
+void copy_data(const FileDescriptor& in, const FileDescriptor& out,
+               const std::filesystem::path& from, const std::filesystem::path& to)
+{
+#ifdef __linux__
+    for (;;)
+    {
+        const auto num_copied = ::copy_file_range(in.get(), nullptr, out.get(), nullptr,
+                                                  std::size_t{ 1 } << 30, 0);
+        if (num_copied == 0)
+            return;
+        if (num_copied > 0)
+            continue;
+        if (errno == EINTR)
+            continue;
+        if (errno == EXDEV or errno == EINVAL or errno == ENOSYS or errno == EOPNOTSUPP)
+            break; // not supported between these files, fall back to read() and write()
+
+        throw Error(cat("I/O error: cannot copy ", from.string(), " to ", to.string(),
+                        ": ", std::strerror(errno)));
+    }
+#endif
+
+    char buffer[65536];
+    for (;;)
+    {
+        const auto num_read = ::read(in.get(), buffer, sizeof(buffer));
+        if (num_read == 0)
+            return;
+        if (num_read < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            throw Error(cat("I/O error: unable to read ", from.string(), ": ",
+                            std::strerror(errno)));
+        }
+        write_fd(out, to, gul14::string_view{ buffer, static_cast<std::size_t>(num_read) });
+    }
+}
+
+} // anonymous namespace
+
+void clone_file(const std::filesystem::path& from, const std::filesystem::path& to)
+{
+    const FileDescriptor in{ from, O_RDONLY };
+
+    struct stat status;
+    if (::fstat(in.get(), &status) != 0)
+    {
+        throw Error(cat("I/O error: unable to examine ", from.string(), ": ",
+                        std::strerror(errno)));
+    }
+
+    const FileDescriptor out{ to, O_WRONLY | O_CREAT | O_EXCL, status.st_mode & 07777 };
+
+#ifdef FICLONE
+    if (::ioctl(out.get(), FICLONE, in.get()) != 0)
+        copy_data(in, out, from, to);
+#else
+    copy_data(in, out, from, to);
+#endif
+
+    const struct timespec times[2] = { status.st_atim, status.st_mtim };
+    if (::futimens(out.get(), times) != 0)
+    {
+        throw Error(cat("I/O error: unable to set the modification time of ",
+                        to.string(), ": ", std::strerror(errno)));
+    }
+}
+
+gul14::optional<FileStamp> get_file_stamp(const std::filesystem::path& file)
+{
+    struct stat status;
+    if (::stat(file.c_str(), &status) != 0)
+        return gul14::nullopt;
+
+    FileStamp stamp;
+    stamp.inode = static_cast<std::uint64_t>(status.st_ino);
+    stamp.size = static_cast<std::uint64_t>(status.st_size);
+    stamp.mtime_ns = static_cast<std::int64_t>(status.st_mtim.tv_sec) * 1'000'000'000
+        + status.st_mtim.tv_nsec;
+    return stamp;
+}
+
+std::string read_file(const std::filesystem::path& file)
+{
+    std::ifstream stream(file, std::ios::binary);
+    if (not stream.is_open())
+        throw Error(cat("I/O error: unable to open file (", file.string(), ")"));
+
+    return std::string{ std::istreambuf_iterator<char>{ stream },
+                        std::istreambuf_iterator<char>{} };
+}
+
+void replace_directory(const std::filesystem::path& replacement,
+                       const std::filesystem::path& target)
+{
+    if (not std::filesystem::exists(target))
+    {
+        rename_or_throw(replacement, target);
+        return;
+    }
+
+#ifdef RENAME_EXCHANGE
+    if (::renameat2(AT_FDCWD, replacement.c_str(), AT_FDCWD, target.c_str(),
+                    RENAME_EXCHANGE) == 0)
+    {
+        std::error_code error;
+        std::filesystem::remove_all(replacement, error); // now holds the old directory
+        return;
+    }
+#endif
+
+    auto backup = replacement;
+    backup += ".old";
+
+    std::error_code error;
+    std::filesystem::remove_all(backup, error);
+
+    rename_or_throw(target, backup);
+
+    try
+    {
+        rename_or_throw(replacement, target);
+    }
+    catch (const Error&)
+    {
+        // Put the old directory back. If even that fails, the backup is restored by
+        // FolderSequenceStorage::scan_base_folder().
+        std::filesystem::rename(backup, target, error);
+        throw;
+    }
+
+    std::filesystem::remove_all(backup, error);
+}
+
+void sync_directory(const std::filesystem::path& dir)
+{
+    const FileDescriptor fd{ dir, O_RDONLY | O_DIRECTORY };
+    sync_or_throw(fd, dir);
+}
+
+void sync_files(const std::vector<std::filesystem::path>& files)
+{
+    for (const auto& file : files)
+        sync_or_throw(FileDescriptor{ file, O_RDONLY }, file);
+}
+
+void write_file(const std::filesystem::path& file, gul14::string_view content)
+{
+    const FileDescriptor fd{ file, O_WRONLY | O_CREAT | O_TRUNC, 0666 };
+    write_fd(fd, file, content);
+}
+
+void write_file_atomically(const std::filesystem::path& file, gul14::string_view content)
+{
+    auto tmp_file = file;
+    tmp_file += ".tmp";
+
+    try
+    {
+        {
+            const FileDescriptor fd{ tmp_file, O_WRONLY | O_CREAT | O_TRUNC, 0666 };
+            write_fd(fd, tmp_file, content);
+            sync_or_throw(fd, tmp_file);
+        }
+
+        rename_or_throw(tmp_file, file);
+    }
+    catch (const Error&)
+    {
+        std::error_code error;
+        std::filesystem::remove(tmp_file, error);
+        throw;
+    }
+
+    auto dir = file.parent_path();
+    sync_directory(dir.empty() ? std::filesystem::path{ "." } : dir);
+}
+
+} // namespace task
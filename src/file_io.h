@@ -0,0 +1,138 @@
+/**
+ * \file   file_io.h
+ * \author Lars Fröhlich
+ * \date   Created on October 18, 2026
+ * \brief  Declaration of file input/output helpers for crash-safe storage.
+ *
+ * \copyright Copyright 2026 Deutsches Elektronen-Synchrotron (DESY), Hamburg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#ifndef TASKOLIB_FILE_IO_H_
+#define TASKOLIB_FILE_IO_H_
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <gul14/optional.h>
+#include <gul14/string_view.h>
+
+namespace task {
+
+/**
+ * Identifying properties of a file that change whenever its content is replaced or
+ * modified: inode number, size, and modification time.
+ */
+struct FileStamp
+{
+    std::uint64_t inode{ 0 };
+    std::uint64_t size{ 0 };
+    std::int64_t mtime_ns{ 0 }; ///< Modification time in nanoseconds since the epoch
+
+    friend bool operator==(const FileStamp& a, const FileStamp& b) noexcept
+    {
+        return a.inode == b.inode and a.size == b.size and a.mtime_ns == b.mtime_ns;
+    }
+
+    friend bool operator!=(const FileStamp& a, const FileStamp& b) noexcept
+    {
+        return not (a == b);
+    }
+};
+
+/**
+ * Copy a file as cheaply as the filesystem allows, preserving its modification time.
+ *
+ * On Linux, the copy is first attempted as a reflink (FICLONE), which shares the data
+ * blocks of both files on copy-on-write filesystems such as Btrfs or XFS and takes
+ * constant time. If that is not supported, the data is copied within the kernel with
+ * copy_file_range(), and finally with plain reads and writes. The target must not exist.
+ * The data is not synchronized to disk (see sync_files()).
+ *
+ * \exception Error is thrown if the file cannot be copied.
+ */
+void clone_file(const std::filesystem::path& from, const std::filesystem::path& to);
+
+/**
+ * Return the stamp of the given file, or an empty optional if it cannot be examined
+ * (e.g. because it does not exist).
+ */
+gul14::optional<FileStamp> get_file_stamp(const std::filesystem::path& file);
+
+/**
+ * Read the whole content of a file into a string.
+ * \exception Error is thrown if the file cannot be read.
+ */
+std::string read_file(const std::filesystem::path& file);
+
+/**
+ * Replace the directory target by the directory replacement as atomically as the
+ * filesystem allows and remove the old content of target afterwards.
+ *
+ * On Linux, both directories are exchanged with a single renameat2() call, so target
+ * always refers to a complete directory. Elsewhere (or if the filesystem does not
+ * support the exchange), the old directory is first renamed to a backup name next to
+ * replacement (the name of replacement with the suffix `.old`), leaving a short window
+ * in which target does not exist. If replacement cannot be renamed afterwards, the
+ * backup is renamed back to target before the exception is thrown. If target does not
+ * exist at all, replacement is simply renamed.
+ *
+ * \exception Error is thrown if the directories cannot be renamed.
+ */
+void replace_directory(const std::filesystem::path& replacement,
+                       const std::filesystem::path& target);
+
+/**
+ * Flush the directory entries of the given directory to disk.
+ * \exception Error is thrown if the directory cannot be synchronized.
+ */
+void sync_directory(const std::filesystem::path& dir);
+
+/**
+ * Flush the data of the given files to disk with one fsync() call per file.
+ *
+ * The directory entries of new files are not flushed (see sync_directory()).
+ *
+ * \exception Error is thrown if the data cannot be synchronized.
+ */
+void sync_files(const std::vector<std::filesystem::path>& files);
+
+/**
+ * Write a file with the given content, replacing an existing file.
+ *
+ * The data is not synchronized to disk (see sync_files()).
+ *
+ * \exception Error is thrown if the file cannot be written.
+ */
+void write_file(const std::filesystem::path& file, gul14::string_view content);
+
+/**
+ * Replace a file with the given content in a crash-safe way.
+ *
+ * The content is written into a temporary file next to the target, flushed to disk, and
+ * renamed over the target. Finally, the directory entry is flushed. After a crash, the
+ * file therefore holds either its old or its new content, never a mixture.
+ *
+ * \exception Error is thrown if the file cannot be written.
+ */
+void write_file_atomically(const std::filesystem::path& file, gul14::string_view content);
+
+} // namespace task
+
+#endif
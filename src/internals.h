@@ -38,6 +38,15 @@ enum class ErrorCause { terminated_by_script, aborted, uncaught_error };
 /// Define the Lua sequence filename for storing and loading Lua script.
 const char sequence_lua_filename[] = "sequence.lua";
 
+/// Define the filename of a sequence archive (a whole sequence in a single file).
+const char sequence_archive_filename[] = "sequence.pack";
+
+/// Define the filename of the content hashes of the files in a sequence folder.
+const char file_hashes_filename[] = ".sequence_hashes";
+
+/// Define the filename of the persistent sequence catalog in the base folder.
+const char catalog_filename[] = ".sequence_catalog";
+
 /**
  * A marker string (the word "ABORT" surrounded by Unicode stop signs) whose presence
  * anywhere in an error message signals that the execution of a script should be stopped.
@@ -22,7 +22,14 @@
 
 // SPDX-License-Identifier: LGPL-2.1-or-later
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
 #include <limits>
+#include <thread>
+#include <tuple>
+#include <vector>
 
 #include <gul14/gul.h>
 
@@ -42,6 +49,10 @@ static const char comm_channel_key[] =
     "TASKOLIB_COMM_CH";
 static const char context_key[] =
     "TASKOLIB_CONTEXT";
+static const char profiler_countdown_key[] =
+    "TASKOLIB_PROF_CNT";
+static const char profiler_next_sample_us_key[] =
+    "TASKOLIB_PROF_NEXT_US";
 static const char sequence_timeout_key[] =
     "TASKOLIB_SEQ_TO_MS";
 static const char step_index_key[] =
@@ -51,11 +62,482 @@ static const char step_timeout_ms_since_epoch_key[] =
 static const char step_timeout_s_key[] =
     "TASKOLIB_STP_TO_S";
 
+// Return the current time of the steady clock in microseconds.
+task::LuaInteger get_steady_us()
+{
+    using std::chrono::microseconds;
+    using std::chrono::duration_cast;
+
+    return duration_cast<microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 } // anonymous namespace
 
 
 namespace task {
 
+namespace {
+
+template <typename>
+[[maybe_unused]] inline constexpr bool always_false_v = false;
+
+// A Lua memory allocator that counts allocated bytes and forwards all requests to the
+// original allocator. The userdata is a pointer to a VmCounters object.
+void* counting_alloc(void* ud, void* ptr, std::size_t osize, std::size_t nsize)
+{
+    auto* counters = static_cast<VmCounters*>(ud);
+
+    // If ptr is null, osize encodes the type of the new object instead of a size.
+    if (ptr == nullptr)
+        counters->statistics.bytes_allocated += nsize;
+    else if (nsize > osize)
+        counters->statistics.bytes_allocated += nsize - osize;
+
+    return counters->original_alloc(counters->original_alloc_ud, ptr, osize, nsize);
+}
+
+// Return a pointer to the VmCounters of the given Lua state or null if none are
+// installed.
+VmCounters* get_vm_counters(lua_State* lua_state)
+{
+    void* ud = nullptr;
+    if (lua_getallocf(lua_state, &ud) != counting_alloc)
+        return nullptr;
+    return static_cast<VmCounters*>(ud);
+}
+
+int gc_sentinel_finalizer(lua_State* lua_state);
+
+// Create an unreferenced table with a finalizer. It is collected at the end of the next
+// garbage collection cycle, whereupon its finalizer counts the cycle and creates a new
+// sentinel.
+void create_gc_sentinel(lua_State* lua_state, VmCounters* counters)
+{
+    lua_createtable(lua_state, 0, 0);
+    lua_createtable(lua_state, 0, 1);
+    lua_pushlightuserdata(lua_state, counters);
+    lua_pushcclosure(lua_state, gc_sentinel_finalizer, 1);
+    lua_setfield(lua_state, -2, "__gc");
+    lua_setmetatable(lua_state, -2);
+    lua_pop(lua_state, 1);
+}
+
+int gc_sentinel_finalizer(lua_State* lua_state)
+{
+    auto* counters = static_cast<VmCounters*>(lua_touserdata(lua_state, lua_upvalueindex(1)));
+    ++counters->statistics.num_gc_cycles;
+    create_gc_sentinel(lua_state, counters);
+    return 0;
+}
+
+// Update the instruction and hook counters and the peak stack depth.
+void update_vm_counters_from_hook(lua_State* lua_state)
+{
+    VmCounters* counters = get_vm_counters(lua_state);
+    if (counters == nullptr)
+        return;
+
+    auto& stats = counters->statistics;
+    ++stats.num_hook_calls;
+    stats.num_instructions += lua_gethookcount(lua_state);
+
+    // Only probe the levels beyond the peak depth observed so far
+    lua_Debug ar;
+    auto depth = stats.peak_stack_depth;
+    while (lua_getstack(lua_state, static_cast<int>(depth), &ar))
+        ++depth;
+    stats.peak_stack_depth = depth;
+}
+
+// Convert a 1-based Lua index into a 0-based array index or throw if it is out of range.
+template <typename T>
+std::size_t get_array_index(const NumericArray<T>& array, LuaInteger lua_index)
+{
+    if (lua_index < 1 || static_cast<std::size_t>(lua_index) > array.size())
+    {
+        throw Error(cat("Array index ", lua_index, " out of range (size ", array.size(),
+                        ')'));
+    }
+    return static_cast<std::size_t>(lua_index - 1);
+}
+
+// Register a NumericArray type as a Lua usertype under the given name. The arrays are
+// stored as full userdata holding a NumericArray object, so they share their storage with
+// the context variables they were imported from.
+template <typename T>
+void register_array_type(sol::state& lua, const char* name)
+{
+    using Array = NumericArray<T>;
+
+    lua.new_usertype<Array>(name,
+        sol::no_constructor,
+        "new", [](LuaInteger size, sol::optional<T> value)
+            {
+                if (size < 0)
+                    throw Error(cat("Invalid array size ", size));
+                return Array(static_cast<std::size_t>(size), value.value_or(T{}));
+            },
+        "from_table", [](const sol::table& table)
+            {
+                std::vector<T> values;
+                values.reserve(table.size());
+                for (std::size_t i = 1; i <= table.size(); ++i)
+                    values.push_back(table.get<T>(i));
+                return Array(std::move(values));
+            },
+        "to_table", [](const Array& array) { return sol::as_table(array.get()); },
+        "sum", [](const Array& array) { return sum(array); },
+        "mean", [](const Array& array) { return mean(array); },
+        "min", [](const Array& array) { return minimum(array); },
+        "max", [](const Array& array) { return maximum(array); },
+        "scale", [](const Array& array, double factor, sol::optional<double> offset)
+            {
+                return scale_and_offset(array, factor, offset.value_or(0.0));
+            },
+        "dot", [](const Array& a, const Array& b) { return dot(a, b); },
+        "find", [](const Array& array, T threshold) -> sol::optional<LuaInteger>
+            {
+                const auto idx = find_threshold(array, threshold);
+                if (not idx)
+                    return sol::nullopt;
+                return static_cast<LuaInteger>(*idx + 1);
+            },
+        sol::meta_function::length, [](const Array& array) { return array.size(); },
+        sol::meta_function::index, [](const Array& array, LuaInteger idx)
+            {
+                return array[get_array_index(array, idx)];
+            },
+        sol::meta_function::new_index, [](Array& array, LuaInteger idx, T value)
+            {
+                array.set(get_array_index(array, idx), value);
+            });
+}
+
+// Return the time until the step or the sequence timeout expires, whichever comes first.
+// The result is zero if a timeout has already expired and very large if no timeout is
+// set.
+std::chrono::nanoseconds get_time_until_timeout(lua_State* lua_state)
+{
+    using std::chrono::duration_cast;
+    using std::chrono::milliseconds;
+    using std::chrono::nanoseconds;
+
+    // Far enough in the future for all practical purposes, but safe from overflows
+    nanoseconds result = std::chrono::hours{ 24 * 365 };
+
+    sol::state_view lua(lua_state);
+    const auto registry = lua.registry();
+
+    sol::optional<LuaInteger> timeout_ms = registry[step_timeout_ms_since_epoch_key];
+    if (timeout_ms.has_value())
+    {
+        const LuaInteger now_ms = std::chrono::round<milliseconds>(
+            Clock::now().time_since_epoch()).count();
+        if (*timeout_ms - now_ms < duration_cast<milliseconds>(result).count())
+            result = milliseconds{ *timeout_ms - now_ms };
+    }
+
+    sol::optional<TimeoutTrigger*> sequence_timeout = registry[sequence_timeout_key];
+    if (sequence_timeout.has_value() && *sequence_timeout != nullptr
+        && isfinite((*sequence_timeout)->get_timeout()))
+    {
+        const auto deadline = (*sequence_timeout)->get_start_time()
+            + static_cast<Timeout::Duration>((*sequence_timeout)->get_timeout());
+        result = std::min(result, duration_cast<nanoseconds>(deadline - Clock::now()));
+    }
+
+    return std::max(result, nanoseconds{ 0 });
+}
+
+// Read an unsigned integer with the given number of bytes (1...8) from memory.
+std::uint64_t read_uint(const char* data, std::size_t num_bytes, bool little_endian)
+{
+    const auto* bytes = reinterpret_cast<const unsigned char*>(data);
+    std::uint64_t value = 0;
+
+    if (little_endian)
+    {
+        for (std::size_t i = num_bytes; i-- > 0;)
+            value = (value << 8) | bytes[i];
+    }
+    else
+    {
+        for (std::size_t i = 0; i != num_bytes; ++i)
+            value = (value << 8) | bytes[i];
+    }
+
+    return value;
+}
+
+// Read an optional size suffix from an unpack format string, starting at position i.
+std::size_t read_format_size(gul14::string_view format, std::size_t& i,
+                             std::size_t default_size)
+{
+    const auto is_digit = [](char c) { return c >= '0' && c <= '9'; };
+
+    if (i == format.size() || not is_digit(format[i]))
+        return default_size;
+
+    std::size_t size = 0;
+    while (i != format.size() && is_digit(format[i]) && size <= 16)
+        size = 10 * size + static_cast<std::size_t>(format[i++] - '0');
+
+    return size;
+}
+
+// Decode binary data like Lua's string.unpack(): Return the values described by the
+// format string, followed by the 1-based position of the first unread byte. Supported
+// options are < > = (byte order), b B h H i[n] I[n] l L j J T (integers of up to 8 bytes),
+// f d n (floating-point numbers), s[n] z (strings), and x (one byte of padding).
+sol::variadic_results unpack_bytes(sol::this_state lua_state, const Bytes& bytes,
+                                   gul14::string_view format, sol::optional<LuaInteger> init)
+{
+    static const bool native_little_endian =
+        []() { const std::uint16_t probe = 1;
+               return *reinterpret_cast<const unsigned char*>(&probe) == 1; }();
+
+    LuaInteger start = init.value_or(1);
+    if (start < 0)
+        start += static_cast<LuaInteger>(bytes.size()) + 1;
+    if (start < 1 || static_cast<std::size_t>(start - 1) > bytes.size())
+        throw Error("unpack(): Initial position out of range");
+
+    const char* data = bytes.data();
+    std::size_t pos = static_cast<std::size_t>(start - 1);
+    bool little_endian = native_little_endian;
+    sol::variadic_results results;
+
+    const auto require = [&bytes, &pos](std::size_t num_bytes)
+        {
+            if (num_bytes > bytes.size() - pos)
+                throw Error("unpack(): Data too short");
+        };
+
+    for (std::size_t i = 0; i != format.size();)
+    {
+        const char option = format[i++];
+        std::size_t size = 0;
+
+        switch (option)
+        {
+            case ' ':
+                break;
+            case '<':
+                little_endian = true;
+                break;
+            case '>':
+                little_endian = false;
+                break;
+            case '=':
+                little_endian = native_little_endian;
+                break;
+            case 'x':
+                require(1);
+                ++pos;
+                break;
+            case 'b': case 'B':
+                size = 1;
+                [[fallthrough]];
+            case 'h': case 'H':
+                if (size == 0)
+                    size = 2;
+                [[fallthrough]];
+            case 'l': case 'L': case 'j': case 'J': case 'T':
+                if (size == 0)
+                    size = 8;
+                [[fallthrough]];
+            case 'i': case 'I':
+            {
+                if (size == 0)
+                    size = read_format_size(format, i, 4);
+                if (size < 1 || size > 8)
+                    throw Error(cat("unpack(): Integer size ", size, " out of range [1, 8]"));
+
+                require(size);
+                std::uint64_t value = read_uint(data + pos, size, little_endian);
+                pos += size;
+
+                const bool is_signed = option >= 'a' && option <= 'z';
+                if (is_signed && size < 8 && ((value >> (8 * size - 1)) & 1u))
+                    value |= ~std::uint64_t{ 0 } << (8 * size);
+
+                results.push_back(sol::make_object(lua_state, static_cast<LuaInteger>(value)));
+                break;
+            }
+            case 'f':
+            {
+                require(4);
+                const auto bits =
+                    static_cast<std::uint32_t>(read_uint(data + pos, 4, little_endian));
+                pos += 4;
+                float value;
+                std::memcpy(&value, &bits, sizeof(value));
+                results.push_back(sol::make_object(lua_state, LuaFloat{ value }));
+                break;
+            }
+            case 'd': case 'n':
+            {
+                require(8);
+                const std::uint64_t bits = read_uint(data + pos, 8, little_endian);
+                pos += 8;
+                double value;
+                std::memcpy(&value, &bits, sizeof(value));
+                results.push_back(sol::make_object(lua_state, LuaFloat{ value }));
+                break;
+            }
+            case 's':
+            {
+                size = read_format_size(format, i, 8);
+                if (size < 1 || size > 8)
+                    throw Error(cat("unpack(): Length size ", size, " out of range [1, 8]"));
+
+                require(size);
+                const std::uint64_t len = read_uint(data + pos, size, little_endian);
+                pos += size;
+                require(len);
+                results.push_back(sol::make_object(lua_state,
+                    std::string_view{ data + pos, static_cast<std::size_t>(len) }));
+                pos += len;
+                break;
+            }
+            case 'z':
+            {
+                const auto view = bytes.view();
+                const auto end = view.find('\0', pos);
+                if (end == view.npos)
+                    throw Error("unpack(): Unfinished string for format 'z'");
+                results.push_back(sol::make_object(lua_state,
+                    std::string_view{ data + pos, end - pos }));
+                pos = end + 1;
+                break;
+            }
+            default:
+                throw Error(cat("unpack(): Invalid format option '", option, '\''));
+        }
+    }
+
+    results.push_back(sol::make_object(lua_state, static_cast<LuaInteger>(pos + 1)));
+    return results;
+}
+
+// Register the Bytes type as a Lua usertype. Bytes objects are immutable and share their
+// storage with the context variables they were imported from.
+void register_bytes_type(sol::state& lua)
+{
+    lua.new_usertype<Bytes>("Bytes",
+        sol::no_constructor,
+        "new", [](std::string_view str) { return Bytes(str.data(), str.size()); },
+        "sub", [](const Bytes& bytes, sol::optional<LuaInteger> i,
+                  sol::optional<LuaInteger> j)
+            {
+                // Same index rules as for string.sub()
+                const auto size = static_cast<LuaInteger>(bytes.size());
+                LuaInteger first = i.value_or(1);
+                LuaInteger last = j.value_or(-1);
+
+                if (first < 0)
+                    first = std::max(size + first + 1, LuaInteger{ 1 });
+                else if (first == 0)
+                    first = 1;
+
+                if (last < 0)
+                    last = size + last + 1;
+                else if (last > size)
+                    last = size;
+
+                if (first > last)
+                    return Bytes{};
+
+                return bytes.slice(static_cast<std::size_t>(first - 1),
+                                   static_cast<std::size_t>(last - first + 1));
+            },
+        "unpack", unpack_bytes,
+        "to_string", [](const Bytes& bytes) { return bytes.to_string(); },
+        sol::meta_function::length, [](const Bytes& bytes) { return bytes.size(); },
+        sol::meta_function::index, [](const Bytes& bytes, LuaInteger idx) -> LuaInteger
+            {
+                if (idx < 1 || static_cast<std::size_t>(idx) > bytes.size())
+                {
+                    throw Error(cat("Byte index ", idx, " out of range (size ",
+                                    bytes.size(), ')'));
+                }
+                return bytes[static_cast<std::size_t>(idx - 1)];
+            },
+        sol::meta_function::new_index,
+            [](const Bytes&, sol::stack_object, sol::stack_object)
+            {
+                throw Error("Bytes objects are read-only");
+            },
+        sol::meta_function::equal_to,
+            [](const Bytes& a, const Bytes& b) { return a == b; });
+}
+
+// Convert a constant value into a Lua object in the given Lua state.
+sol::object make_lua_object(lua_State* lua_state, const ConstantValue& value)
+{
+    return std::visit(
+        [lua_state](auto&& value) -> sol::object
+        {
+            using T = std::decay_t<decltype(value)>;
+
+            if constexpr (std::is_same_v<T, VarInteger>)
+                return sol::make_object(lua_state, LuaInteger{ value });
+            else if constexpr (std::is_same_v<T, VarFloat>)
+                return sol::make_object(lua_state, LuaFloat{ value });
+            else if constexpr (std::is_same_v<T, VarBool>)
+                return sol::make_object(lua_state, LuaBool{ value });
+            else // VarString, arrays (shared), nested tables (shared)
+                return sol::make_object(lua_state, value);
+        },
+        value);
+}
+
+// Convert a timeout in seconds into nanoseconds, limiting it to one year to avoid an
+// overflow for "infinite" values.
+std::chrono::nanoseconds to_nanoseconds(double seconds)
+{
+    using std::chrono::duration;
+    using std::chrono::duration_cast;
+    using std::chrono::nanoseconds;
+
+    seconds = gul14::clamp(seconds, 0.0, 365.0 * 24.0 * 3600.0);
+    return duration_cast<nanoseconds>(duration<double>(seconds));
+}
+
+// Call a blocking wait function of a blackboard as
+// `wait_fct(std::chrono::nanoseconds timeout, const std::atomic<bool>* cancel)`.
+// The timeout is limited to the remaining step or sequence timeout, and an immediate
+// termination request on the CommChannel wakes the function up at once. Afterwards, a Lua
+// error is raised if a timeout has expired or if termination has been requested.
+template <typename WaitFct>
+auto wait_on_blackboard(lua_State* lua_state, const Blackboard& blackboard,
+                        std::chrono::nanoseconds timeout, WaitFct wait_fct)
+{
+    // The extra millisecond accounts for the resolution of the step timeout check
+    timeout = std::min(timeout,
+        get_time_until_timeout(lua_state) + std::chrono::milliseconds{ 1 });
+
+    CommChannel* comm = get_comm_channel_ptr_from_registry(lua_state);
+    const std::atomic<bool>* cancel = nullptr;
+
+    if (comm)
+    {
+        comm->set_termination_listener([&blackboard]() { blackboard.wake_waiters(); });
+        cancel = &comm->immediate_termination_requested_;
+    }
+
+    const auto remove_listener = gul14::finally(
+        [comm]() { if (comm) comm->set_termination_listener(nullptr); });
+
+    auto result = wait_fct(timeout, cancel);
+
+    hook_check_timeout_and_termination_request(lua_state, nullptr);
+    return result;
+}
+
+} // anonymous namespace
+
 void abort_script_with_error(lua_State* lua_state, const std::string& msg)
 {
     sol::state_view lua(lua_state);
@@ -193,8 +675,11 @@ LuaInteger get_ms_since_epoch(TimePoint t0, std::chrono::milliseconds dt)
         return std::numeric_limits<LuaInteger>::max();
 }
 
-void hook_check_timeout_and_termination_request(lua_State* lua_state, lua_Debug*)
+void hook_check_timeout_and_termination_request(lua_State* lua_state, lua_Debug* ar)
 {
+    if (ar != nullptr)
+        update_vm_counters_from_hook(lua_state);
+
     // If necessary, these functions raise Lua errors to terminate the execution of the
     // script. As we use a C++ compiled Lua, the error is thrown as an exception that is
     // caught by a Lua-internal handler.
@@ -202,6 +687,13 @@ void hook_check_timeout_and_termination_request(lua_State* lua_state, lua_Debug*
     check_script_timeout(lua_state);
 }
 
+void hook_check_timeout_termination_request_and_sample(lua_State* lua_state,
+                                                       lua_Debug* ar)
+{
+    hook_check_timeout_and_termination_request(lua_state, ar);
+    sample_call_stack_if_due(lua_state);
+}
+
 void hook_abort_with_error(lua_State* lua_state, lua_Debug*)
 {
     sol::state_view lua(lua_state);
@@ -218,6 +710,160 @@ void install_custom_commands(sol::state& lua)
     lua["sleep"] = sleep_fct;
     lua["terminate_sequence"] =
         [](sol::this_state lua){ abort_script_with_error(lua, ""); };
+    lua["wait_until"] = wait_until_fct;
+
+    install_data_types(lua);
+}
+
+void install_data_types(sol::state& lua)
+{
+    register_array_type<VarFloat>(lua, "FloatArray");
+    register_array_type<VarInteger>(lua, "IntArray");
+    register_bytes_type(lua);
+}
+
+void install_blackboard(sol::state& lua, Blackboard& blackboard)
+{
+    const auto to_lua = [](sol::this_state lua_state,
+                           const gul14::optional<VariableValue>& value) -> sol::object
+        {
+            if (not value)
+                return sol::lua_nil;
+            return make_lua_object(lua_state, *value);
+        };
+
+    sol::table table = lua.create_named_table("blackboard");
+
+    table["get"] = [&blackboard, to_lua](sol::this_state lua_state,
+                                         const std::string& name)
+        {
+            return to_lua(lua_state, blackboard.get(VariableName{ name }));
+        };
+
+    table["set"] = [&blackboard](const std::string& name, const sol::object& value)
+        -> LuaInteger
+        {
+            const VariableName varname{ name };
+
+            if (value.get_type() == sol::type::lua_nil)
+            {
+                blackboard.erase(varname);
+                return static_cast<LuaInteger>(blackboard.get_version(varname));
+            }
+
+            return static_cast<LuaInteger>(blackboard.set(varname, to_variable_value(value)));
+        };
+
+    table["version"] = [&blackboard](const std::string& name)
+        {
+            return static_cast<LuaInteger>(blackboard.get_version(VariableName{ name }));
+        };
+
+    table["compare_exchange"] = [&blackboard](const std::string& name,
+        const sol::object& expected, const sol::object& desired)
+        {
+            gul14::optional<VariableValue> expected_value;
+            if (expected.get_type() != sol::type::lua_nil)
+                expected_value = to_variable_value(expected);
+
+            return blackboard.compare_exchange(VariableName{ name }, expected_value,
+                                               to_variable_value(desired));
+        };
+
+    // Block until the variable changes, a timeout expires, or termination is requested
+    table["wait"] = [&blackboard, to_lua](sol::this_state lua_state,
+        const std::string& name, LuaInteger version, sol::optional<double> timeout_s)
+        -> std::tuple<LuaInteger, sol::object>
+        {
+            const VariableName varname{ name };
+            const double timeout = timeout_s.value_or(
+                std::numeric_limits<double>::infinity());
+            const auto t0 = gul14::tic();
+
+            hook_check_timeout_and_termination_request(lua_state, nullptr);
+
+            while (true)
+            {
+                const auto entry = wait_on_blackboard(lua_state, blackboard,
+                    to_nanoseconds(timeout - gul14::toc(t0)),
+                    [&](std::chrono::nanoseconds dt, const std::atomic<bool>* cancel)
+                    {
+                        return blackboard.wait_for_change(varname,
+                            static_cast<std::uint64_t>(version), dt, cancel);
+                    });
+
+                // Loop only after spurious wakeups (e.g. by a termination request for
+                // another sequence that shares the blackboard)
+                if (entry.version != static_cast<std::uint64_t>(version)
+                    || gul14::toc(t0) >= timeout)
+                {
+                    return { static_cast<LuaInteger>(entry.version),
+                             to_lua(lua_state, entry.value) };
+                }
+            }
+        };
+}
+
+void install_constant_table(sol::state& lua, const ConstantTable& constants)
+{
+    // Stateless iterator for pairs(): Return the entry that follows the given key.
+    auto next_entry = [](sol::this_state lua_state, const ConstantTable& table,
+                         sol::optional<std::string> key)
+        -> std::tuple<sol::object, sol::object>
+        {
+            auto it = table.begin();
+            if (key)
+            {
+                it = std::upper_bound(table.begin(), table.end(), *key,
+                    [](const std::string& key, const ConstantTable::Entry& entry)
+                    {
+                        return key < entry.first;
+                    });
+            }
+
+            if (it == table.end())
+                return { sol::lua_nil, sol::lua_nil };
+
+            return { sol::make_object(lua_state, it->first),
+                     make_lua_object(lua_state, it->second) };
+        };
+
+    lua.new_usertype<ConstantTable>("ConstantTable",
+        sol::no_constructor,
+        sol::meta_function::index,
+            [](sol::this_state lua_state, const ConstantTable& table,
+               sol::stack_object key) -> sol::object
+            {
+                if (key.get_type() != sol::type::string)
+                    return sol::lua_nil;
+
+                const ConstantValue* value = table.find(key.as<std::string_view>());
+                if (value == nullptr)
+                    return sol::lua_nil;
+
+                return make_lua_object(lua_state, *value);
+            },
+        sol::meta_function::new_index,
+            [](const ConstantTable&, sol::stack_object, sol::stack_object)
+            {
+                throw Error("Constant tables are read-only");
+            },
+        sol::meta_function::length, [](const ConstantTable& table) { return table.size(); },
+        sol::meta_function::pairs,
+            [next_entry](sol::this_state lua_state, const ConstantTable& table)
+            {
+                return std::make_tuple(sol::make_object(lua_state, next_entry),
+                                       sol::make_object(lua_state, table), sol::lua_nil);
+            });
+
+    lua["constants"] = constants;
+}
+
+void install_vm_counters(lua_State* lua_state, VmCounters& counters)
+{
+    counters.original_alloc = lua_getallocf(lua_state, &counters.original_alloc_ud);
+    lua_setallocf(lua_state, counting_alloc, &counters);
+    create_gc_sentinel(lua_state, &counters);
 }
 
 void install_timeout_and_termination_request_hook(sol::state& lua, TimePoint now,
@@ -232,8 +878,57 @@ void install_timeout_and_termination_request_hook(sol::state& lua, TimePoint now
     registry[context_key] = &context;
     registry[sequence_timeout_key] = sequence_timeout;
 
-    // Install a hook that is called after every 100 Lua instructions
-    lua_sethook(lua, hook_check_timeout_and_termination_request, LUA_MASKCOUNT, 100);
+    if (not context.profiler)
+    {
+        // Install a hook that is called after every 100 Lua instructions
+        lua_sethook(lua, hook_check_timeout_and_termination_request, LUA_MASKCOUNT, 100);
+        return;
+    }
+
+    // With profiling enabled, the hook may have to run more often than every 100
+    // instructions to honor short sampling intervals.
+    int hook_count = 100;
+    const auto instruction_interval = context.profiler->get_instruction_interval();
+
+    if (instruction_interval != 0)
+    {
+        registry[profiler_countdown_key] = LuaInteger{ instruction_interval };
+        if (instruction_interval < 100)
+            hook_count = static_cast<int>(instruction_interval);
+    }
+    else
+    {
+        registry[profiler_next_sample_us_key] = get_steady_us()
+            + context.profiler->get_time_interval().count();
+    }
+
+    lua_sethook(lua, hook_check_timeout_termination_request_and_sample, LUA_MASKCOUNT,
+                hook_count);
+}
+
+sol::object make_lua_object(lua_State* lua_state, const VariableValue& value)
+{
+    return std::visit(
+        [lua_state](auto&& value) -> sol::object
+        {
+            using T = std::decay_t<decltype(value)>;
+
+            if constexpr (std::is_same_v<T, VarInteger>)
+                return sol::make_object(lua_state, LuaInteger{ value });
+            else if constexpr (std::is_same_v<T, VarFloat>)
+                return sol::make_object(lua_state, LuaFloat{ value });
+            else if constexpr (std::is_same_v<T, VarString>)
+                return sol::make_object(lua_state, value);
+            else if constexpr (std::is_same_v<T, VarBool>)
+                return sol::make_object(lua_state, LuaBool{ value });
+            else if constexpr (std::is_same_v<T, VarFloatArray>
+                               || std::is_same_v<T, VarIntArray>
+                               || std::is_same_v<T, VarBytes>)
+                return sol::make_object(lua_state, value); // shares the storage
+            else
+                static_assert(always_false_v<T>, "Unhandled type in variable import");
+        },
+        value);
 }
 
 void open_safe_library_subset(sol::state& lua)
@@ -279,15 +974,197 @@ void print_fct(sol::this_state sol, sol::variadic_args va)
     }
 }
 
+void sample_call_stack_if_due(lua_State* lua_state)
+{
+    try
+    {
+        Profiler* profiler = get_context_from_registry(lua_state).profiler.get();
+        if (profiler == nullptr)
+            return;
+
+        auto registry = sol::state_view(lua_state).registry();
+        std::uint64_t weight = 0;
+
+        if (const LuaInteger interval = profiler->get_instruction_interval(); interval != 0)
+        {
+            // Count down the instructions executed since the last hook call
+            LuaInteger countdown = registry[profiler_countdown_key].get_or(interval);
+            countdown -= lua_gethookcount(lua_state);
+
+            if (countdown <= 0)
+            {
+                weight = 1 + static_cast<std::uint64_t>(-countdown / interval);
+                countdown += static_cast<LuaInteger>(weight) * interval;
+            }
+
+            registry[profiler_countdown_key] = countdown;
+        }
+        else
+        {
+            const LuaInteger now_us = get_steady_us();
+            const LuaInteger next_us = registry[profiler_next_sample_us_key].get_or(now_us);
+
+            if (now_us < next_us)
+                return;
+
+            // Attribute all time intervals that elapsed since the last sample to the
+            // current call stack
+            const LuaInteger period = profiler->get_time_interval().count();
+            weight = 1 + static_cast<std::uint64_t>((now_us - next_us) / period);
+            registry[profiler_next_sample_us_key] =
+                next_us + static_cast<LuaInteger>(weight) * period;
+        }
+
+        if (weight != 0)
+            profiler->sample(lua_state, get_step_idx_from_registry(lua_state), weight);
+    }
+    catch (const Error& e)
+    {
+        abort_script_with_error(lua_state, e.what());
+    }
+}
+
 void sleep_fct(double seconds, sol::this_state sol)
 {
-    auto t0 = gul14::tic();
-    while (gul14::toc(t0) < seconds)
+    using std::chrono::duration;
+    using std::chrono::duration_cast;
+    using std::chrono::steady_clock;
+
+    // Limit the sleep time to avoid an overflow for "infinite" values
+    seconds = gul14::clamp(seconds, 0.0, 365.0 * 24.0 * 3600.0);
+    const auto end = steady_clock::now()
+        + duration_cast<steady_clock::duration>(duration<double>(seconds));
+
+    while (true)
     {
         hook_check_timeout_and_termination_request(sol, nullptr);
-        double sec = gul14::clamp(seconds - gul14::toc(t0), 0.0, 0.01);
-        gul14::sleep(sec);
+
+        const auto now = steady_clock::now();
+        if (now >= end)
+            return;
+
+        // Wake up when the step or sequence timeout expires at the latest. The extra
+        // millisecond accounts for the resolution of the step timeout check.
+        const auto wait_time = std::min<steady_clock::duration>(end - now,
+            get_time_until_timeout(sol) + std::chrono::milliseconds{ 1 });
+
+        // Block on the CommChannel so that termination requests wake us up immediately
+        CommChannel* comm = get_comm_channel_ptr_from_registry(sol);
+        if (comm)
+            comm->wait_for_termination_request(wait_time);
+        else
+            std::this_thread::sleep_for(wait_time);
+    }
+}
+
+VariableValue to_variable_value(const sol::object& obj)
+{
+    switch (obj.get_type())
+    {
+        case sol::type::number:
+            // For this check to work, SOL_SAFE_NUMERICS needs to be set to 1
+            if (obj.is<LuaInteger>())
+                return VarInteger{ obj.as<LuaInteger>() };
+            return VarFloat{ obj.as<LuaFloat>() };
+        case sol::type::string:
+            return obj.as<VarString>();
+        case sol::type::boolean:
+            return VarBool{ obj.as<LuaBool>() };
+        case sol::type::userdata:
+            if (obj.is<VarFloatArray>())
+                return obj.as<VarFloatArray>();
+            if (obj.is<VarIntArray>())
+                return obj.as<VarIntArray>();
+            if (obj.is<VarBytes>())
+                return obj.as<VarBytes>();
+            [[fallthrough]];
+        default:
+            throw Error(cat("Unsupported value type '",
+                            sol::type_name(obj.lua_state(), obj.get_type()), '\''));
+    }
+}
+
+bool wait_until_fct(const sol::object& condition, sol::optional<double> timeout_s,
+                    sol::optional<double> poll_interval_s, sol::this_state sol)
+{
+    constexpr double min_interval = 0.001;
+
+    const double timeout = timeout_s.value_or(std::numeric_limits<double>::infinity());
+    const double max_interval = std::max(poll_interval_s.value_or(0.1), min_interval);
+
+    Blackboard* blackboard = get_context_from_registry(sol).blackboard.get();
+
+    std::function<bool()> is_fulfilled;
+
+    switch (condition.get_type())
+    {
+        case sol::type::function:
+            is_fulfilled = [fct = condition.as<sol::protected_function>()]()
+                {
+                    sol::protected_function_result result = fct();
+                    if (not result.valid())
+                    {
+                        sol::error err = result;
+                        throw Error(err.what());
+                    }
+                    return result.get_type() != sol::type::lua_nil
+                        && result.get_type() != sol::type::none
+                        && (result.get_type() != sol::type::boolean || result.get<bool>());
+                };
+            break;
+        case sol::type::string:
+        {
+            if (blackboard == nullptr)
+                throw Error("wait_until(): No blackboard is available for a variable name");
+
+            is_fulfilled = [blackboard, name = VariableName{ condition.as<std::string>() }]()
+                {
+                    const auto value = blackboard->get(name);
+                    return value && *value != VariableValue{ VarBool{ false } };
+                };
+            break;
+        }
+        default:
+            throw Error("wait_until(): The condition must be a function or a blackboard "
+                        "variable name");
+    }
+
+    std::uint64_t generation = blackboard ? blackboard->get_generation() : 0;
+    double interval = min_interval;
+    const auto t0 = gul14::tic();
+
+    while (not is_fulfilled())
+    {
+        const double remaining = timeout - gul14::toc(t0);
+        if (remaining <= 0.0)
+            return false;
+
+        const double wait_time = std::min(interval, remaining);
+        bool changed = false;
+
+        if (blackboard)
+        {
+            // Wait for the current poll interval, but wake up early if the blackboard
+            // changes, a timeout expires, or termination is requested.
+            const auto new_generation = wait_on_blackboard(sol, *blackboard,
+                to_nanoseconds(wait_time),
+                [&](std::chrono::nanoseconds dt, const std::atomic<bool>* cancel)
+                {
+                    return blackboard->wait_for_any_change(generation, dt, cancel);
+                });
+            changed = (new_generation != generation);
+            generation = new_generation;
+        }
+        else
+        {
+            sleep_fct(wait_time, sol);
+        }
+
+        // Back off while nothing happens, but poll quickly again after a change
+        interval = changed ? min_interval : std::min(2.0 * interval, max_interval);
     }
+
+    return true;
 }
 
 } // namespace task
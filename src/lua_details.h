@@ -31,16 +31,41 @@
 #include <variant>
 
 #include "sol/sol.hpp"
+#include "taskolib/Blackboard.h"
 #include "taskolib/CommChannel.h"
+#include "taskolib/ConstantTable.h"
 #include "taskolib/Context.h"
+#include "taskolib/StepStatistics.h"
 #include "taskolib/TimeoutTrigger.h"
 
+// A ConstantTable provides begin() and end(), but it must be exposed to Lua as a usertype
+// with its own metamethods instead of being treated as a container.
+template <>
+struct sol::is_container<task::ConstantTable> : std::false_type {};
+
+// The same holds for numeric arrays, whose elements can only be modified via set().
+template <typename T>
+struct sol::is_container<task::NumericArray<T>> : std::false_type {};
+
 namespace task {
 
 // Check that the lua lib has been build with the expected types
 static_assert(std::is_same<LuaFloat, double>::value, "Unexpected Lua-internal floating point type");
 static_assert(std::is_same<LuaInteger, long long>::value, "Unexpected Lua-internal integer type");
 
+/**
+ * A collector for the Lua VM counters of a single step execution (see StepStatistics).
+ *
+ * It is registered as the userdata of a counting memory allocator and of a garbage
+ * collection sentinel, so it must outlive the Lua state in which it is installed.
+ */
+struct VmCounters
+{
+    StepStatistics statistics; ///< The counters collected so far
+    lua_Alloc original_alloc{ nullptr }; ///< Allocator that is wrapped by the counting one
+    void* original_alloc_ud{ nullptr }; ///< Userdata for the original allocator
+};
+
 // Abort the execution of the script by raising a Lua error with the given error message.
 void abort_script_with_error(lua_State* lua_state, const std::string& msg);
 
@@ -91,8 +116,39 @@ LuaInteger get_ms_since_epoch(TimePoint t0, std::chrono::milliseconds dt);
 void hook_abort_with_error(lua_State* lua_state, lua_Debug*);
 
 // Check if the step timeout has expired or if immediate termination has been requested
-// via the comm channel. If so, raise a Lua error.
-void hook_check_timeout_and_termination_request(lua_State* lua_state, lua_Debug*);
+// via the comm channel. If so, raise a Lua error. If VM counters are installed and the
+// function is called as a hook (with a non-null lua_Debug pointer), the counters are
+// updated.
+void hook_check_timeout_and_termination_request(lua_State* lua_state, lua_Debug* ar);
+
+// Perform the same checks as hook_check_timeout_and_termination_request(), then sample the
+// Lua call stack for the Profiler of the Context if the sampling interval has passed.
+// This hook is installed instead of the former one if profiling is enabled.
+void hook_check_timeout_termination_request_and_sample(lua_State* lua_state,
+                                                       lua_Debug* ar);
+
+// Make the data types FloatArray, IntArray, and Bytes (see install_custom_commands())
+// available in the given Lua state.
+void install_data_types(sol::state& lua);
+
+/**
+ * Make the given blackboard available as the global table "blackboard" in the given Lua
+ * state (see Blackboard). The blackboard must outlive the Lua state.
+ * \code
+ * blackboard.get(name)                      -- value or nil
+ * blackboard.set(name, value)               -- returns the new version; nil erases
+ * blackboard.version(name)                  -- 0 if never written
+ * blackboard.compare_exchange(name, expected, desired) -- true if the value was set
+ * blackboard.wait(name, version [, timeout]) -- returns the version and the value
+ *                                              after a change or after the timeout
+ * \endcode
+ */
+void install_blackboard(sol::state& lua, Blackboard& blackboard);
+
+// Make the given constant table available as the read-only global "constants" in the
+// given Lua state. Nested tables are exposed in the same way. The Lua objects refer to
+// the shared data of the table, so no entries are copied until they are accessed.
+void install_constant_table(sol::state& lua, const ConstantTable& constants);
 
 /**
  * Install implementations for some custom functions in the given Lua state.
@@ -100,17 +156,51 @@ void hook_check_timeout_and_termination_request(lua_State* lua_state, lua_Debug*
  * print() -- print a string on the (virtual) console; this function calls the
  *            print_function callback from the given context
  * sleep() -- wait for a given number of seconds
+ * terminate_sequence() -- stop the sequence without an error
+ * wait_until() -- wait for a condition in the current Lua state (see wait_until_fct())
+ * \endcode
+ *
+ * Additionally, the array types FloatArray and IntArray (see VarFloatArray and
+ * VarIntArray) are made available:
+ * \code
+ * a = FloatArray.new(n [, value])   -- array of n elements (default: 0)
+ * a = IntArray.from_table({1, 2, 3})
+ * #a, a[i], a[i] = x                -- size and element access (1-based)
+ * a:sum(), a:mean(), a:min(), a:max(), a:dot(b)
+ * a:scale(factor [, offset])        -- new FloatArray with factor * a[i] + offset
+ * a:find(threshold)                 -- index of first element >= threshold, or nil
+ * a:to_table()
+ * \endcode
+ *
+ * Binary data (see VarBytes) is available as the immutable type Bytes:
+ * \code
+ * b = Bytes.new(str)                -- copy of a Lua string
+ * #b, b[i]                          -- size and byte value (1-based)
+ * b:sub(i [, j])                    -- slice without copy, same indices as string.sub()
+ * b:unpack(fmt [, pos])             -- decode values like string.unpack()
+ * b:to_string()
  * \endcode
  */
 void install_custom_commands(sol::state& lua);
 
+// Start collecting Lua VM counters for the given Lua state: This installs a counting
+// memory allocator and a sentinel object that counts garbage collection cycles. The
+// instruction and hook counters and the stack depth are updated by
+// hook_check_timeout_and_termination_request().
+void install_vm_counters(lua_State* lua_state, VmCounters& counters);
+
 // Install hooks that check for timeouts and immediate termination requests while a Lua
 // script is being executed. If one of both occurs, the script terminates with an error
-// message that contains the abort marker.
+// message that contains the abort marker. If the context has a Profiler, the hook also
+// samples the call stack in the configured interval.
 void install_timeout_and_termination_request_hook(sol::state& lua, TimePoint now,
     std::chrono::milliseconds timeout, OptionalStepIndex step_idx, const Context& context,
     CommChannel* comm_channel, TimeoutTrigger* sequence_timeout);
 
+// Convert a variable value into a Lua object in the given Lua state. Arrays and binary
+// data are exposed as userdata that shares the storage of the value.
+sol::object make_lua_object(lua_State* lua_state, const VariableValue& value);
+
 // Open a safe subset of the Lua standard libraries in the given Lua state.
 //
 // This opens the math, string, table, and UTF8 libraries. The base library is also
@@ -124,9 +214,42 @@ void open_safe_library_subset(sol::state& lua);
 // and finally sends a message of type Message::Type::output with the result.
 void print_fct(sol::this_state, sol::variadic_args);
 
+// Take a sample of the Lua call stack for the Profiler stored in the Context if the
+// configured sampling interval (in instructions or in time) has passed since the last
+// sample. If the Context has no Profiler, the function does nothing.
+void sample_call_stack_if_due(lua_State* lua_state);
+
 // Pause execution for the specified time, observing timeouts and termination requests.
 void sleep_fct(double seconds, sol::this_state sol);
 
+/**
+ * Convert a Lua object into a variable value.
+ *
+ * \exception Error is thrown if the object has a type that cannot be stored in a
+ *            VariableValue (e.g. nil, a table, or a function).
+ */
+VariableValue to_variable_value(const sol::object& obj);
+
+/**
+ * Wait until a condition is fulfilled, observing timeouts and termination requests.
+ *
+ * This is the implementation of the Lua function
+ * \code
+ * wait_until(condition [, timeout [, poll_interval]])
+ * \endcode
+ * The condition is either a function that is called until it returns a value other than
+ * nil or false, or the name of a blackboard variable that has to be set to a value other
+ * than false. The condition is evaluated in the calling Lua state. The poll interval
+ * starts at 1 ms and is doubled after each unsuccessful evaluation up to poll_interval
+ * (default: 0.1 s). If the context has a Blackboard, any write to it wakes the wait up
+ * immediately and resets the poll interval.
+ *
+ * \returns true if the condition was fulfilled, false if the timeout (in seconds,
+ *          default: infinite) expired first.
+ */
+bool wait_until_fct(const sol::object& condition, sol::optional<double> timeout_s,
+                    sol::optional<double> poll_interval_s, sol::this_state sol);
+
 } // namespace task
 
 #endif
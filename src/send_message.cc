@@ -30,8 +30,12 @@ void send_message(Message::Type type, gul14::string_view text, TimePoint timesta
                   OptionalStepIndex index, const Context& context,
                   CommChannel* comm_channel)
 {
-    Message msg{ type, std::string(text), timestamp, index };
+    send_message(Message{ type, std::string(text), timestamp, index }, context,
+                 comm_channel);
+}
 
+void send_message(Message msg, const Context& context, CommChannel* comm_channel)
+{
     if (context.message_callback_function)
         context.message_callback_function(msg);
 
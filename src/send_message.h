@@ -51,6 +51,18 @@ void send_message(Message::Type type, gul14::string_view text, TimePoint timesta
                   OptionalStepIndex index, const Context& context,
                   CommChannel* comm_channel = nullptr);
 
+/**
+ * Call the message callback and enqueue the given message in the communication channel,
+ * if any.
+ *
+ * \param msg           The message to be sent
+ * \param context       Context with a message callback function
+ * \param comm_channel  Pointer to the communication channel. If this is null, the
+ *                      function does not attempt to push the message into any message
+ *                      queue.
+ */
+void send_message(Message msg, const Context& context, CommChannel* comm_channel = nullptr);
+
 } // namespace task
 
 #endif
@@ -22,11 +22,13 @@
 
 // SPDX-License-Identifier: LGPL-2.1-or-later
 
-#include <fstream>
 #include <sstream>
+#include <string>
+#include <vector>
 
 #include <gul14/gul.h>
 
+#include "file_io.h"
 #include "internals.h"
 #include "serialize_sequence.h"
 
@@ -93,32 +95,74 @@ std::ostream& operator<<(std::ostream& stream, const Step& step)
 
 void store_step(const std::filesystem::path& lua_file, const Step& step)
 {
-    if (std::filesystem::exists(lua_file))
+    std::ostringstream stream;
+    stream << step;
+    write_file_atomically(lua_file, stream.str());
+}
+
+std::ostream& operator<<(std::ostream& stream, const Sequence& sequence)
+{
+    stream << sequence.get_step_setup_script();
+
+    check_stream(stream);
+
+    return stream;
+}
+
+std::string make_sequence_archive(const Sequence& sequence)
+{
+    std::vector<std::string> entries;
+    entries.reserve(sequence.size() + 1);
+
+    std::ostringstream entry;
+    write_sequence_parameters(entry, sequence);
+    entries.push_back(entry.str());
+
+    for (const auto& step : sequence)
     {
-        std::error_code err{};
-        std::filesystem::remove(lua_file, err);
-        if (err)
-        {
-            throw Error(cat("I/O error: Unable to remove file '", lua_file.string(),
-                "': ", err.message()));
-        }
+        entry.str("");
+        entry << step;
+        entries.push_back(entry.str());
     }
 
-    std::ofstream stream(lua_file);
+    std::string header = cat("-- taskolib sequence archive: 1\n-- entries: ",
+                             entries.size(), '\n');
+    std::size_t offset = 0;
+    for (const auto& e : entries)
+    {
+        header += cat("-- ", offset, ' ', e.size(), '\n');
+        offset += e.size();
+    }
 
-    if (not stream.is_open())
-        throw Error(gul14::cat("I/O error: unable to open file (", lua_file.string(), ")"));
+    std::string archive;
+    archive.reserve(header.size() + offset);
+    archive += header;
+    for (const auto& e : entries)
+        archive += e;
 
-    stream << step; // RAII closes the stream (let the destructor do the job)
+    return archive;
 }
 
-std::ostream& operator<<(std::ostream& stream, const Sequence& sequence)
+void store_sequence_archive(const std::filesystem::path& file, const Sequence& sequence)
 {
-    stream << sequence.get_step_setup_script();
+    write_file_atomically(file, make_sequence_archive(sequence));
+}
 
-    check_stream(stream);
+void write_sequence_parameters(std::ostream& stream, const Sequence& sequence)
+{
+    if (not sequence.get_maintainers().empty())
+        stream << "-- maintainers: " << sequence.get_maintainers() << '\n';
 
-    return stream;
+    stream << "-- label: " << sequence.get_label() << '\n';
+
+    stream << "-- timeout: ";
+    if (!isfinite(sequence.get_timeout()))
+        stream << "infinite\n";
+    else
+        stream << static_cast<std::chrono::milliseconds>(sequence.get_timeout()).count()
+               << '\n';
+
+    stream << sequence;
 }
 
 
@@ -99,6 +99,9 @@ std::ostream& operator<<(std::ostream& stream, const Step& step);
  *
  * The label is explicitly escaped on storing and unescaped on loading.
  *
+ * The file is replaced atomically (see write_file_atomically()), so a crash during the
+ * call leaves either the old or the new file behind.
+ *
  * \param lua_file  filename under which the step should be stored
  * \param step  the Step object that should be serialized
  */
@@ -115,6 +118,51 @@ void store_step(const std::filesystem::path& lua_file, const Step& step);
  */
 std::ostream& operator<<(std::ostream& stream, const Sequence& sequence);
 
+/**
+ * Serialize a whole sequence into the content of a single archive file.
+ *
+ * The archive starts with a header that lists the offset and size of each entry, followed
+ * by the concatenated entries themselves:
+ *
+ * \code
+ * -- taskolib sequence archive: 1
+ * -- entries: <N>
+ * -- <offset> <size>
+ * ... (N lines)
+ * <data>
+ * \endcode
+ *
+ * Offsets are counted in bytes from the first byte after the header. The first entry
+ * holds the sequence parameters in the same format as the file `sequence.lua` (see
+ * write_sequence_parameters()), and the following entries hold the steps in the same
+ * format as the individual step files (see store_step()). Since the entries are located
+ * via the index, their content is not restricted in any way.
+ *
+ * \param sequence  the sequence that should be serialized
+ * \returns the content of the archive file.
+ */
+std::string make_sequence_archive(const Sequence& sequence);
+
+/**
+ * Store a whole sequence in a single archive file (see make_sequence_archive()).
+ *
+ * The file is replaced atomically (see write_file_atomically()).
+ *
+ * \param file      filename under which the archive should be stored
+ * \param sequence  the sequence that should be serialized
+ *
+ * \exception Error is thrown if the file cannot be written.
+ */
+void store_sequence_archive(const std::filesystem::path& file, const Sequence& sequence);
+
+/**
+ * Serialize the parameters of a sequence (maintainers, label, timeout, and step setup
+ * script) to the output stream.
+ *
+ * This is the content of the file `sequence.lua` in a sequence folder.
+ */
+void write_sequence_parameters(std::ostream& stream, const Sequence& sequence);
+
 } // namespace task
 
 #endif
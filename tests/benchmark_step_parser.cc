@@ -0,0 +1,161 @@
+/**
+ * \file   benchmark_step_parser.cc
+ * \author Lars Fröhlich
+ * \date   Created on October 18, 2026
+ * \brief  Throughput benchmark for the step file parser.
+ *
+ * \copyright Copyright 2026 Deutsches Elektronen-Synchrotron (DESY), Hamburg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include <chrono>
+#include <ctime>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gul14/cat.h>
+
+#include "deserialize_sequence.h"
+#include "serialize_sequence.h"
+
+using namespace task;
+
+namespace {
+
+using BenchmarkClock = std::chrono::steady_clock;
+
+/// Run fct repeatedly for at least min_duration and return the average time per run.
+template <typename Fct>
+double measure_seconds_per_run(Fct fct,
+    BenchmarkClock::duration min_duration = std::chrono::milliseconds{ 500 })
+{
+    fct(); // warm-up
+
+    std::size_t num_runs = 0;
+    const auto t0 = BenchmarkClock::now();
+    auto t1 = t0;
+    do
+    {
+        fct();
+        ++num_runs;
+        t1 = BenchmarkClock::now();
+    }
+    while (t1 - t0 < min_duration);
+
+    return std::chrono::duration<double>(t1 - t0).count() / num_runs;
+}
+
+void report(const std::string& name, std::size_t num_bytes, double seconds)
+{
+    std::cout << name << ": " << num_bytes / seconds / 1e6 << " MB/s\n";
+}
+
+std::vector<std::string> make_step_files(std::size_t num_steps)
+{
+    std::vector<std::string> files;
+    files.reserve(num_steps);
+
+    for (std::size_t i = 0; i != num_steps; ++i)
+    {
+        Step step{ Step::type_action };
+        step.set_label(gul14::cat("Step number ", i));
+        step.set_used_context_variable_names(VariableNames{ "a", "b", "counter" });
+        step.set_time_of_last_execution(Clock::now());
+        step.set_script(gul14::cat(
+            "-- Increment the counter and compute something\n"
+            "counter = counter + 1\n"
+            "for i = 1, 10 do\n"
+            "    a = a + i * b\n"
+            "end\n"
+            "if a > ", i, " then\n"
+            "    print('a is large')\n"
+            "end\n"));
+
+        std::ostringstream ss;
+        ss << step;
+        files.push_back(ss.str());
+    }
+
+    return files;
+}
+
+} // anonymous namespace
+
+int main()
+{
+    const auto files = make_step_files(1000);
+
+    std::size_t num_bytes = 0;
+    for (const auto& f : files)
+        num_bytes += f.size();
+
+    std::size_t checksum = 0;
+
+    report("parse_step() on contiguous buffers", num_bytes,
+        measure_seconds_per_run([&]()
+        {
+            for (const auto& f : files)
+                checksum += parse_step(f).get_script().size();
+        }));
+
+    report("operator>>() on string streams", num_bytes,
+        measure_seconds_per_run([&]()
+        {
+            for (const auto& f : files)
+            {
+                std::istringstream ss{ f };
+                Step step;
+                ss >> step;
+                checksum += step.get_script().size();
+            }
+        }));
+
+    // Timestamp decoding: fast path vs. strptime() + mktime()
+    const std::string step_with_time =
+        "-- type: action\n-- label: x\n-- time of last execution: 2022-06-13 16:30:32\n";
+    constexpr int num_timestamps = 10'000;
+
+    const double fast = measure_seconds_per_run([&]()
+        {
+            for (int i = 0; i != num_timestamps; ++i)
+            {
+                checksum += static_cast<std::size_t>(parse_step(step_with_time)
+                    .get_time_of_last_execution().time_since_epoch().count());
+            }
+        });
+
+    const double reference = measure_seconds_per_run([&]()
+        {
+            for (int i = 0; i != num_timestamps; ++i)
+            {
+                std::tm t{};
+                strptime("2022-06-13 16:30:32", "%Y-%m-%d %H:%M:%S", &t);
+                t.tm_isdst = -1;
+                checksum += static_cast<std::size_t>(std::mktime(&t));
+            }
+        });
+
+    std::cout << "Step with timestamp: " << num_timestamps / fast / 1e6
+              << " M steps/s\n"
+              << "strptime() + mktime() alone: " << num_timestamps / reference / 1e6
+              << " M timestamps/s\n"
+              << "(checksum " << checksum << ")\n";
+
+    return 0;
+}
@@ -0,0 +1,327 @@
+/**
+ * \file   test_Blackboard.cc
+ * \author Lars Fröhlich
+ * \date   Created on October 18, 2026
+ * \brief  Test suite for the Blackboard class.
+ *
+ * \copyright Copyright 2026 Deutsches Elektronen-Synchrotron (DESY), Hamburg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gul14/catch.h>
+
+#include "taskolib/Blackboard.h"
+#include "taskolib/Step.h"
+
+using namespace std::literals;
+using namespace task;
+using Catch::Matchers::Contains;
+
+TEST_CASE("Blackboard: set(), get(), erase()", "[Blackboard]")
+{
+    Blackboard bb;
+
+    REQUIRE(bb.get("x") == gul14::nullopt);
+    REQUIRE(bb.get_version("x") == 0);
+    REQUIRE(bb.erase("x") == false);
+
+    REQUIRE(bb.set("x", VarInteger{ 42 }) == 1);
+    REQUIRE(bb.get("x") == VariableValue{ VarInteger{ 42 } });
+    REQUIRE(bb.get_version("x") == 1);
+
+    REQUIRE(bb.set("x", VarString{ "text" }) == 2);
+    const auto entry = bb.load("x");
+    REQUIRE(entry.value == VariableValue{ VarString{ "text" } });
+    REQUIRE(entry.version == 2);
+
+    REQUIRE(bb.erase("x") == true);
+    REQUIRE(bb.get("x") == gul14::nullopt);
+    REQUIRE(bb.get_version("x") == 3);
+    REQUIRE(bb.erase("x") == false);
+    REQUIRE(bb.get_version("x") == 3);
+
+    // Other variables are independent
+    REQUIRE(bb.get_version("y") == 0);
+}
+
+TEST_CASE("Blackboard: compare_exchange()", "[Blackboard]")
+{
+    Blackboard bb;
+
+    REQUIRE(bb.compare_exchange("x", VarInteger{ 1 }, VarInteger{ 2 }) == false);
+    REQUIRE(bb.get_version("x") == 0);
+
+    REQUIRE(bb.compare_exchange("x", gul14::nullopt, VarInteger{ 1 }) == true);
+    REQUIRE(bb.compare_exchange("x", gul14::nullopt, VarInteger{ 5 }) == false);
+    REQUIRE(bb.compare_exchange("x", VarInteger{ 1 }, VarInteger{ 2 }) == true);
+    REQUIRE(bb.get("x") == VariableValue{ VarInteger{ 2 } });
+    REQUIRE(bb.get_version("x") == 2);
+}
+
+TEST_CASE("Blackboard: Concurrent increments", "[Blackboard]")
+{
+    Blackboard bb;
+    bb.set("counter", VarInteger{ 0 });
+
+    constexpr int num_threads = 4;
+    constexpr int num_increments = 1000;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t != num_threads; ++t)
+    {
+        threads.emplace_back([&bb]()
+            {
+                for (int i = 0; i != num_increments; ++i)
+                {
+                    while (true)
+                    {
+                        const auto old_value = bb.get("counter");
+                        const auto n = std::get<VarInteger>(*old_value);
+                        if (bb.compare_exchange("counter", old_value, VarInteger{ n + 1 }))
+                            break;
+                    }
+                }
+            });
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    REQUIRE(bb.get("counter") == VariableValue{ VarInteger{ num_threads * num_increments } });
+    REQUIRE(bb.get_version("counter") == num_threads * num_increments + 1);
+}
+
+TEST_CASE("Blackboard: Concurrent reads of replaced values", "[Blackboard]")
+{
+    Blackboard bb;
+    const std::string long_text(1000, 'x');
+    bb.set("text", VarString{ long_text });
+
+    std::atomic<bool> done{ false };
+    std::atomic<int> num_bad_reads{ 0 };
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t != 4; ++t)
+    {
+        readers.emplace_back([&]()
+            {
+                while (not done)
+                {
+                    const auto entry = bb.load("text");
+                    if (entry.value != VariableValue{ VarString{ long_text } })
+                        ++num_bad_reads;
+                }
+            });
+    }
+
+    // Every write retires the previous record while the readers may still copy it
+    for (int i = 0; i != 20000; ++i)
+        bb.set("text", VarString{ long_text });
+
+    done = true;
+    for (auto& thread : readers)
+        thread.join();
+
+    REQUIRE(num_bad_reads == 0);
+    REQUIRE(bb.get_version("text") == 20001);
+}
+
+TEST_CASE("Blackboard: wait_for_change()", "[Blackboard]")
+{
+    Blackboard bb;
+
+    SECTION("Timeout")
+    {
+        const auto entry = bb.wait_for_change("x", 0, 10ms);
+        REQUIRE(entry.version == 0);
+        REQUIRE(entry.value == gul14::nullopt);
+    }
+
+    SECTION("Immediate return if the version differs")
+    {
+        bb.set("x", VarBool{ true });
+        const auto entry = bb.wait_for_change("x", 0, 1h);
+        REQUIRE(entry.version == 1);
+    }
+
+    SECTION("Wake up on a write from another thread")
+    {
+        std::thread writer([&bb]()
+            {
+                std::this_thread::sleep_for(10ms);
+                bb.set("x", VarFloat{ 1.5 });
+            });
+
+        const auto entry = bb.wait_for_change("x", 0, 1h);
+        writer.join();
+
+        REQUIRE(entry.version == 1);
+        REQUIRE(entry.value == VariableValue{ VarFloat{ 1.5 } });
+    }
+
+    SECTION("Wake up when the cancel flag is set")
+    {
+        std::atomic<bool> cancel{ false };
+        std::thread canceller([&bb, &cancel]()
+            {
+                std::this_thread::sleep_for(10ms);
+                cancel = true;
+                bb.wake_waiters();
+            });
+
+        const auto entry = bb.wait_for_change("x", 0, 1h, &cancel);
+        const auto generation = bb.wait_for_any_change(0, 1h, &cancel);
+        canceller.join();
+
+        REQUIRE(entry.version == 0);
+        REQUIRE(generation == 0);
+    }
+}
+
+TEST_CASE("Blackboard: Access from steps", "[Blackboard]")
+{
+    auto bb = std::make_shared<Blackboard>();
+
+    Context context1;
+    context1.blackboard = bb;
+    Context context2;
+    context2.blackboard = bb;
+
+    Step step;
+    step.set_used_context_variable_names(VariableNames{ "v", "ver", "ok" });
+
+    step.set_script(R"(
+        ver = blackboard.set('state', 'ready')
+        ok = blackboard.compare_exchange('count', nil, 1)
+        blackboard.set('data', FloatArray.new(3, 1.0))
+        )");
+    step.execute(context1);
+    REQUIRE(std::get<VarInteger>(context1.variables["ver"]) == 1);
+    REQUIRE(std::get<VarBool>(context1.variables["ok"]) == true);
+
+    step.set_script(R"(
+        v = blackboard.get('state') .. blackboard.get('count') .. blackboard.get('data'):sum()
+        ver = blackboard.version('missing')
+        ok = blackboard.compare_exchange('count', 2, 3)
+        )");
+    step.execute(context2);
+    REQUIRE(std::get<VarString>(context2.variables["v"]) == "ready13.0");
+    REQUIRE(std::get<VarInteger>(context2.variables["ver"]) == 0);
+    REQUIRE(std::get<VarBool>(context2.variables["ok"]) == false);
+
+    SECTION("Erasing with nil")
+    {
+        step.set_script("ver = blackboard.set('state', nil); v = blackboard.get('state')");
+        step.execute(context1);
+        REQUIRE(bb->get("state") == gul14::nullopt);
+        REQUIRE(std::get<VarInteger>(context1.variables["ver"]) == 2);
+        REQUIRE(context1.variables.count("v") == 0);
+    }
+
+    SECTION("Waiting for a change")
+    {
+        std::thread writer([bb]()
+            {
+                std::this_thread::sleep_for(20ms);
+                bb->set("state", VarString{ "done" });
+            });
+
+        step.set_script("ver, v = blackboard.wait('state', 1, 10)");
+        step.execute(context2);
+        writer.join();
+
+        REQUIRE(std::get<VarInteger>(context2.variables["ver"]) == 2);
+        REQUIRE(std::get<VarString>(context2.variables["v"]) == "done");
+
+        step.set_script("ver, v = blackboard.wait('state', 2, 0.02)");
+        step.execute(context2);
+        REQUIRE(std::get<VarInteger>(context2.variables["ver"]) == 2);
+    }
+
+    SECTION("Waiting is ended by an immediate termination request")
+    {
+        CommChannel comm;
+        std::thread requester([&comm]()
+            {
+                std::this_thread::sleep_for(20ms);
+                comm.request_immediate_termination();
+            });
+
+        step.set_script("blackboard.wait('state', 1)");
+        REQUIRE_THROWS_WITH(step.execute(context2, &comm), Contains("Stop on user request"));
+
+        comm.immediate_termination_requested_ = false;
+        step.set_script("wait_until('never_set')");
+        std::thread requester2([&comm]()
+            {
+                std::this_thread::sleep_for(20ms);
+                comm.request_immediate_termination();
+            });
+        REQUIRE_THROWS_WITH(step.execute(context2, &comm), Contains("Stop on user request"));
+
+        requester.join();
+        requester2.join();
+    }
+
+    SECTION("Waiting respects the step timeout")
+    {
+        step.set_timeout(Timeout{ 50ms });
+        step.set_script("blackboard.wait('state', 1)");
+        REQUIRE_THROWS_WITH(step.execute(context2), Contains("Timeout"));
+    }
+
+    SECTION("Unsupported values")
+    {
+        step.set_script("blackboard.set('t', {})");
+        REQUIRE_THROWS_WITH(step.execute(context1), Contains("Unsupported"));
+    }
+
+    SECTION("No blackboard attached")
+    {
+        Context context;
+        step.set_script("ok = (blackboard == nil)");
+        step.execute(context);
+        REQUIRE(std::get<VarBool>(context.variables["ok"]) == true);
+    }
+}
+
+TEST_CASE("Blackboard: get_generation() and wait_for_any_change()", "[Blackboard]")
+{
+    Blackboard bb;
+    REQUIRE(bb.get_generation() == 0);
+
+    bb.set("a", VarInteger{ 1 });
+    bb.set("b", VarInteger{ 2 });
+    bb.compare_exchange("a", VarInteger{ 5 }, VarInteger{ 6 }); // no write
+    REQUIRE(bb.get_generation() == 2);
+
+    REQUIRE(bb.wait_for_any_change(2, 5ms) == 2);
+    REQUIRE(bb.wait_for_any_change(1, 1h) == 2);
+
+    std::thread writer([&bb]()
+        {
+            std::this_thread::sleep_for(10ms);
+            bb.erase("b");
+        });
+    REQUIRE(bb.wait_for_any_change(2, 1h) == 3);
+    writer.join();
+}
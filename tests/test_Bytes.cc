@@ -0,0 +1,86 @@
+/**
+ * \file   test_Bytes.cc
+ * \author Lars Fröhlich
+ * \date   Created on October 18, 2026
+ * \brief  Test suite for the Bytes class.
+ *
+ * \copyright Copyright 2026 Deutsches Elektronen-Synchrotron (DESY), Hamburg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include <gul14/catch.h>
+
+#include "taskolib/Bytes.h"
+#include "taskolib/exceptions.h"
+
+using namespace task;
+
+TEST_CASE("Bytes: Default constructor", "[Bytes]")
+{
+    Bytes bytes;
+    REQUIRE(bytes.empty());
+    REQUIRE(bytes.size() == 0);
+    REQUIRE(bytes.data() == nullptr);
+    REQUIRE(bytes.to_string() == "");
+    REQUIRE(bytes == Bytes{ std::string{} });
+}
+
+TEST_CASE("Bytes: Construction", "[Bytes]")
+{
+    Bytes moved{ std::string{ "Hello" } };
+    REQUIRE(moved.size() == 5);
+    REQUIRE(moved.view() == "Hello");
+    REQUIRE(moved[1] == 'e');
+
+    const unsigned char raw[] = { 0, 255, 7 };
+    Bytes copied{ raw, sizeof(raw) };
+    REQUIRE(copied.size() == 3);
+    REQUIRE(copied[1] == 255);
+    REQUIRE(copied.data() != reinterpret_cast<const char*>(raw));
+}
+
+TEST_CASE("Bytes: Copies and slices share their storage", "[Bytes]")
+{
+    const Bytes bytes{ std::string{ "0123456789" } };
+
+    const Bytes copy = bytes;
+    REQUIRE(copy.shares_storage_with(bytes));
+    REQUIRE(copy.data() == bytes.data());
+
+    const Bytes slice = bytes.slice(2, 3);
+    REQUIRE(slice.shares_storage_with(bytes));
+    REQUIRE(slice.view() == "234");
+    REQUIRE(slice.data() == bytes.data() + 2);
+
+    REQUIRE(bytes.slice(8).view() == "89");
+    REQUIRE(bytes.slice(8, 100).view() == "89");
+    REQUIRE(bytes.slice(10).empty());
+    REQUIRE(slice.slice(1, 1).view() == "3");
+    REQUIRE_THROWS_AS(bytes.slice(11), Error);
+}
+
+TEST_CASE("Bytes: Comparison", "[Bytes]")
+{
+    const Bytes a{ std::string{ "abcabc" } };
+    const Bytes b{ std::string{ "abc" } };
+
+    REQUIRE(a.slice(0, 3) == b);
+    REQUIRE(a.slice(3) == b);
+    REQUIRE(a.slice(0, 3) == a.slice(3, 3));
+    REQUIRE(a != b);
+    REQUIRE(a.slice(1, 3) != b);
+}
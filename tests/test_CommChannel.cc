@@ -22,12 +22,15 @@
 
 // SPDX-License-Identifier: LGPL-2.1-or-later
 
+#include <thread>
 #include <type_traits>
 
 #include <gul14/catch.h>
+#include <gul14/time_util.h>
 
 #include "taskolib/CommChannel.h"
 
+using namespace std::literals;
 using namespace task;
 
 TEST_CASE("CommChannel: Constructor", "[CommChannel]")
@@ -37,3 +40,50 @@ TEST_CASE("CommChannel: Constructor", "[CommChannel]")
 
     CommChannel c;
 }
+
+TEST_CASE("CommChannel: wait_for_termination_request()", "[CommChannel]")
+{
+    CommChannel c;
+
+    SECTION("Timeout")
+    {
+        const auto t0 = gul14::tic();
+        REQUIRE(c.wait_for_termination_request(10ms) == false);
+        REQUIRE(gul14::toc(t0) >= 0.01);
+    }
+
+    SECTION("Wake up on request")
+    {
+        std::thread requester([&c]()
+            {
+                std::this_thread::sleep_for(10ms);
+                c.request_immediate_termination();
+            });
+
+        const auto t0 = gul14::tic();
+        REQUIRE(c.wait_for_termination_request(10s) == true);
+        REQUIRE(gul14::toc(t0) < 5.0);
+        requester.join();
+
+        REQUIRE(c.immediate_termination_requested_);
+        REQUIRE(c.wait_for_termination_request(10s) == true); // returns immediately
+    }
+}
+
+TEST_CASE("CommChannel: set_termination_listener()", "[CommChannel]")
+{
+    CommChannel c;
+    int num_calls = 0;
+
+    c.set_termination_listener([&c, &num_calls]()
+        {
+            REQUIRE(c.immediate_termination_requested_);
+            ++num_calls;
+        });
+    c.request_immediate_termination();
+    REQUIRE(num_calls == 1);
+
+    c.set_termination_listener(nullptr);
+    c.request_immediate_termination();
+    REQUIRE(num_calls == 1);
+}
@@ -0,0 +1,209 @@
+/**
+ * \file   test_ConstantTable.cc
+ * \author Lars Fröhlich
+ * \date   Created on October 18, 2026
+ * \brief  Test suite for the ConstantTable class.
+ *
+ * \copyright Copyright 2026 Deutsches Elektronen-Synchrotron (DESY), Hamburg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include <thread>
+#include <vector>
+
+#include <gul14/catch.h>
+
+#include "taskolib/ConstantTable.h"
+#include "taskolib/exceptions.h"
+#include "taskolib/Step.h"
+
+using namespace std::literals;
+using namespace task;
+using Catch::Matchers::Contains;
+
+TEST_CASE("ConstantTable: Default constructor", "[ConstantTable]")
+{
+    ConstantTable table;
+    REQUIRE(table.empty());
+    REQUIRE(table.size() == 0);
+    REQUIRE(table.begin() == table.end());
+    REQUIRE(table.find("a") == nullptr);
+    REQUIRE_THROWS_AS(table.at("a"), Error);
+}
+
+TEST_CASE("ConstantTable: Construction from entries", "[ConstantTable]")
+{
+    ConstantTable table{
+        { "pi", VarFloat{ 3.14 } },
+        { "name", VarString{ "Magnet" } },
+        { "gains", VarFloatArray{ 1.0, 2.0 } },
+        { "nested", ConstantTable{ { "n", VarInteger{ 4 } } } }
+    };
+
+    REQUIRE(table.size() == 4);
+    REQUIRE(std::get<VarFloat>(table.at("pi")) == 3.14);
+    REQUIRE(std::get<VarString>(*table.find("name")) == "Magnet");
+    REQUIRE(std::get<VarInteger>(std::get<ConstantTable>(table.at("nested")).at("n")) == 4);
+
+    // Entries are sorted by key
+    REQUIRE(table.begin()->first == "gains");
+
+    REQUIRE_THROWS_AS((ConstantTable{ { "a", VarBool{ true } }, { "a", VarBool{ false } } }),
+                      Error);
+    REQUIRE_THROWS_AS((ConstantTable{ { "", VarBool{ true } } }), Error);
+}
+
+TEST_CASE("ConstantTable: Copies share their data", "[ConstantTable]")
+{
+    const ConstantTable a{ { "x", VarInteger{ 1 } } };
+    const ConstantTable b = a;
+    REQUIRE(b.shares_storage_with(a));
+    REQUIRE(b == a);
+
+    const ConstantTable c = a.with("y", VarInteger{ 2 });
+    REQUIRE_FALSE(c.shares_storage_with(a));
+    REQUIRE(c != a);
+    REQUIRE(c.size() == 2);
+    REQUIRE(a.size() == 1);
+
+    const ConstantTable d = c.with("x", VarInteger{ 3 });
+    REQUIRE(std::get<VarInteger>(d.at("x")) == 3);
+    REQUIRE(std::get<VarInteger>(c.at("x")) == 1);
+}
+
+TEST_CASE("ConstantTable: from_lua()", "[ConstantTable]")
+{
+    SECTION("Supported types")
+    {
+        const auto table = ConstantTable::from_lua(R"(
+            return {
+                i = 42, f = 1.5, s = "text", b = true,
+                ints = { 1, 2, 3 }, floats = { 1, 2.5 },
+                arr = FloatArray.new(3, 2.0),
+                nested = { deeper = { value = -1 } },
+                empty = {}
+            })");
+
+        REQUIRE(table.size() == 9);
+        REQUIRE(std::get<VarInteger>(table.at("i")) == 42);
+        REQUIRE(std::get<VarFloat>(table.at("f")) == 1.5);
+        REQUIRE(std::get<VarString>(table.at("s")) == "text");
+        REQUIRE(std::get<VarBool>(table.at("b")) == true);
+        REQUIRE(std::get<VarIntArray>(table.at("ints")) == VarIntArray{ 1, 2, 3 });
+        REQUIRE(std::get<VarFloatArray>(table.at("floats")) == VarFloatArray{ 1.0, 2.5 });
+        REQUIRE(std::get<VarFloatArray>(table.at("arr")) == VarFloatArray(3, 2.0));
+        REQUIRE(std::get<ConstantTable>(table.at("empty")).empty());
+
+        const auto& nested = std::get<ConstantTable>(table.at("nested"));
+        const auto& deeper = std::get<ConstantTable>(nested.at("deeper"));
+        REQUIRE(std::get<VarInteger>(deeper.at("value")) == -1);
+    }
+
+    SECTION("Errors")
+    {
+        REQUIRE_THROWS_WITH(ConstantTable::from_lua("return 1"), Contains("must return"));
+        REQUIRE_THROWS_WITH(ConstantTable::from_lua("error('fail')"), Contains("fail"));
+        REQUIRE_THROWS_WITH(ConstantTable::from_lua("return { a = { 1, 'x' } }"),
+                            Contains("constants.a[2]"));
+        REQUIRE_THROWS_WITH(ConstantTable::from_lua("return { a = { [2] = 1 } }"),
+                            Contains("constants.a"));
+        REQUIRE_THROWS_WITH(ConstantTable::from_lua("return { f = math.sin }"),
+                            Contains("constants.f"));
+    }
+
+    SECTION("Timeout")
+    {
+        REQUIRE_THROWS_WITH(ConstantTable::from_lua("while true do end", Timeout{ 20ms }),
+                            Contains("Timeout"));
+    }
+}
+
+TEST_CASE("ConstantTable: Access from steps", "[ConstantTable]")
+{
+    Context context;
+    context.constants = ConstantTable{
+        { "calibration", ConstantTable::from_lua("return { gain = { 1.0, 1.5, 2.0 } }") },
+        { "offset", VarInteger{ 10 } },
+        { "unit", VarString{ "A" } }
+    };
+
+    Step step;
+    step.set_used_context_variable_names(VariableNames{ "result", "keys", "gain" });
+
+    SECTION("Read access")
+    {
+        step.set_script(R"(
+            gain = constants.calibration.gain
+            result = gain[2] * 2 + constants.offset
+            keys = ''
+            for k, v in pairs(constants) do keys = keys .. k .. ',' end
+            keys = keys .. #constants
+            if constants.missing ~= nil then error('missing constant found') end
+            )");
+        step.execute(context);
+
+        REQUIRE(std::get<VarFloat>(context.variables["result"]) == 13.0);
+        REQUIRE(std::get<VarString>(context.variables["keys"]) == "calibration,offset,unit,3");
+
+        // The array is shared with the constant table
+        const auto& gain = std::get<VarFloatArray>(std::get<ConstantTable>(
+            context.constants.at("calibration")).at("gain"));
+        REQUIRE(std::get<VarFloatArray>(context.variables["gain"]).shares_storage_with(gain));
+    }
+
+    SECTION("Without constants, scripts may define their own global of that name")
+    {
+        context.constants = ConstantTable{};
+        step.set_script("constants = 1; result = constants + 1");
+        step.execute(context);
+        REQUIRE(std::get<VarInteger>(context.variables.at("result")) == 2);
+    }
+
+    SECTION("Constants cannot be modified")
+    {
+        step.set_script("constants.offset = 1");
+        REQUIRE_THROWS_WITH(step.execute(context), Contains("read-only"));
+
+        step.set_script("constants.calibration.new_entry = 1");
+        REQUIRE_THROWS_WITH(step.execute(context), Contains("read-only"));
+
+        // Modifying an array obtained from the constants only affects the local copy
+        step.set_script("gain = constants.calibration.gain; gain[1] = 5");
+        step.execute(context);
+        const auto& gain = std::get<VarFloatArray>(std::get<ConstantTable>(
+            context.constants.at("calibration")).at("gain"));
+        REQUIRE(gain[0] == 1.0);
+    }
+
+    SECTION("Concurrent access from several threads")
+    {
+        step.set_script("result = constants.calibration.gain:sum() + constants.offset");
+
+        std::vector<std::thread> threads;
+        std::vector<Context> contexts(4, context);
+        for (auto& ctx : contexts)
+            threads.emplace_back([&ctx, step]() mutable { step.execute(ctx); });
+        for (auto& thread : threads)
+            thread.join();
+
+        for (const auto& ctx : contexts)
+        {
+            REQUIRE(ctx.constants.shares_storage_with(context.constants));
+            REQUIRE(std::get<VarFloat>(ctx.variables.at("result")) == 14.5);
+        }
+    }
+}
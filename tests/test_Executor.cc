@@ -569,6 +569,8 @@ TEST_CASE("Executor: Message callbacks", "[execute_sequence]")
                 str += "[STEP_STOP]"; break;
             case Message::Type::step_stopped_with_error:
                 str += "[STEP_STOP_ERR]"; break;
+            case Message::Type::context_variables_changed:
+                str += "[VARS]"; break;
             case Message::Type::undefined:
                 throw Error("Undefined message type");
             }
@@ -623,3 +625,67 @@ TEST_CASE("Executor: Message callbacks", "[execute_sequence]")
             "[SEQ_STOP_ERR]");
     }
 }
+
+TEST_CASE("Executor: Context variables are updated during execution", "[Executor]")
+{
+    Context context;
+    context.message_callback_function = nullptr; // suppress console output
+    context.variables["a"] = VarInteger{ 0 };
+    context.variables["b"] = VarString{ "unchanged" };
+    context.variables["c"] = VarBool{ true };
+
+    int num_change_messages = 0;
+    context.message_callback_function =
+        [&num_change_messages](const Message& msg)
+        {
+            if (msg.get_type() == Message::Type::context_variables_changed)
+                ++num_change_messages;
+        };
+
+    Sequence sequence{ "test_sequence" };
+    sequence.push_back(Step{ Step::type_action }
+        .set_used_context_variable_names(VariableNames{ "a", "b", "c" })
+        .set_script("a = 42; c = nil"));
+    sequence.push_back(Step{ Step::type_action }
+        .set_used_context_variable_names(VariableNames{ "a", "b" })
+        .set_script("sleep(10)"));
+
+    Executor executor;
+    executor.run_asynchronously(sequence, context);
+
+    // Wait until the first step has finished and the second one is sleeping
+    while (executor.update(sequence) && not sequence[1].is_running())
+        gul14::sleep(1ms);
+
+    auto vars = executor.get_context_variables();
+    REQUIRE(std::get<VarInteger>(vars["a"]) == 42);
+    REQUIRE(std::get<VarString>(vars["b"]) == "unchanged");
+    REQUIRE(vars.count("c") == 0);
+
+    executor.cancel(sequence);
+
+    // Only the first step has changed any variables
+    REQUIRE(num_change_messages == 1);
+}
+
+TEST_CASE("Executor: Context variables are shared with the worker thread", "[Executor]")
+{
+    Context context;
+    context.message_callback_function = nullptr; // suppress console output
+    context.variables["unchanged"] = VarString(1000, 'x');
+    context.variables["a"] = VarInteger{ 0 };
+
+    Sequence sequence{ "test_sequence" };
+    sequence.push_back(Step{ Step::type_action }
+        .set_used_context_variable_names(VariableNames{ "unchanged" })
+        .set_script("local x = #unchanged"));
+
+    Executor executor;
+    executor.run_asynchronously(sequence, context);
+
+    while (executor.update(sequence))
+        gul14::sleep(1ms);
+
+    // No step has modified the variables, so all copies share the same entries
+    REQUIRE(executor.get_context_variables().shares_storage_with(context.variables));
+}
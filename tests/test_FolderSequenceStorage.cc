@@ -0,0 +1,1071 @@
+/**
+ * \file   test_FolderSequenceStorage.cc
+ * \author Marcus Walla, Lars Fröhlich
+ * \date   Created on July 22, 2022
+ * \brief  Test suite for the FolderSequenceStorage class.
+ *
+ * \copyright Copyright 2022-2026 Deutsches Elektronen-Synchrotron (DESY), Hamburg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <gul14/cat.h>
+#include <gul14/catch.h>
+
+#include "file_io.h"
+#include "internals.h"
+#include "serialize_sequence.h"
+#include "taskolib/FolderSequenceStorage.h"
+
+using namespace Catch::Matchers;
+using namespace std::literals;
+using namespace task;
+using namespace task::literals;
+
+namespace {
+
+static const std::filesystem::path temp_dir{ "unit_test_files" };
+
+// Helper that returns all entries of a directory (i.e. files or subdirs)
+std::vector<std::string> collect_filenames(const std::filesystem::path& path)
+{
+    std::vector<std::string> result;
+    for (const auto& entry: std::filesystem::directory_iterator{ path })
+        result.push_back(entry.path().filename().string());
+
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+// Helper that returns all ".lua" entries of a directory (i.e. files or subdirs)
+std::vector<std::string> collect_lua_filenames(const std::filesystem::path& path)
+{
+    std::vector<std::string> result;
+    for (const auto& entry: std::filesystem::directory_iterator{ path })
+        if (entry.path().extension() == ".lua")
+            result.push_back(entry.path().filename().string());
+
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+} // anonymous namespace
+
+
+TEST_CASE("FolderSequenceStorage: copy_sequence() clones the sequence folder",
+          "[FolderSequenceStorage]")
+{
+    const auto base = temp_dir / "copy_clone";
+    std::filesystem::remove_all(base);
+    std::filesystem::create_directories(base);
+
+    const auto format = GENERATE(FolderSequenceStorage::StorageFormat::folder,
+                                 FolderSequenceStorage::StorageFormat::archive);
+
+    FolderSequenceStorage storage{ base, format };
+
+    Sequence seq{ "Original", SequenceName{ "original" } };
+    seq.set_maintainers("Jane Doe");
+    for (int i = 0; i != 12; ++i)
+    {
+        Step step{ Step::type_action };
+        step.set_script(gul14::cat("a = ", i));
+        seq.push_back(step);
+    }
+    storage.store_sequence(seq);
+
+    const auto original_folder = base / make_sequence_filename(seq);
+    std::ofstream{ original_folder / "notes.txt" } << "Foreign file\n";
+
+    // Backdate the original files to see if the timestamps are preserved
+    const auto old_time = std::filesystem::last_write_time(original_folder)
+        - std::chrono::hours{ 1 };
+    for (const auto& entry : std::filesystem::directory_iterator{ original_folder })
+        std::filesystem::last_write_time(entry.path(), old_time);
+
+    const UniqueId copy_uid;
+    storage.copy_sequence(seq.get_unique_id(), SequenceName{ "copy" }, copy_uid);
+
+    const Sequence copy = storage.load_sequence(copy_uid);
+    REQUIRE(copy.get_name() == SequenceName{ "copy" });
+    REQUIRE(copy.get_unique_id() == copy_uid);
+    REQUIRE(copy.get_label() == "Original");
+    REQUIRE(copy.get_maintainers() == "Jane Doe");
+    REQUIRE(copy.size() == 12);
+    REQUIRE(copy[11].get_script() == "a = 11");
+
+    const auto copy_folder = base / make_sequence_filename(copy);
+    const auto filenames = collect_filenames(original_folder);
+    REQUIRE(collect_filenames(copy_folder) == filenames);
+
+    for (const auto& filename : filenames)
+    {
+        CAPTURE(filename);
+        REQUIRE(read_file(copy_folder / filename) == read_file(original_folder / filename));
+        REQUIRE(std::filesystem::last_write_time(copy_folder / filename) == old_time);
+    }
+
+    REQUIRE_THROWS_AS(storage.copy_sequence(UniqueId{}, SequenceName{ "x" }, UniqueId{}),
+                      Error);
+    REQUIRE_THROWS_AS(storage.copy_sequence(seq.get_unique_id(), SequenceName{ "x" },
+                                            copy_uid), Error);
+    REQUIRE(storage.list_sequences().size() == 2);
+
+    std::filesystem::remove_all(base);
+}
+
+TEST_CASE("FolderSequenceStorage: list_sequences()", "[FolderSequenceStorage]")
+{
+    // prepare first sequence for test
+    Step step_1_01{Step::type_while};
+    step_1_01.set_label("while");
+    step_1_01.set_script("return i < 10");
+
+    Step step_1_02{Step::type_action};
+    step_1_02.set_label("action");
+    step_1_02.set_script("i = i + 1");
+
+    Sequence seq_1{ "Test sequence 1", SequenceName{ "test.seq.1" } };
+    seq_1.push_back(step_1_01);
+    seq_1.push_back(step_1_02);
+
+    // prepare second sequence for test
+    Step step_2_01{Step::type_while};
+    step_2_01.set_label("while");
+    step_2_01.set_script("return i < 10");
+
+    Step step_2_02{Step::type_action};
+    step_2_02.set_label("action");
+    step_2_02.set_script("i = i + 1");
+
+    Sequence seq_2{ "Test sequence 2", SequenceName{ "test.seq.2" } };
+    seq_2.push_back(step_1_01);
+    seq_2.push_back(step_1_02);
+
+
+    const std::string root = "unit_test_files/sequences";
+    FolderSequenceStorage storage{ root };
+
+    if (std::filesystem::exists(root))
+        std::filesystem::remove_all(root);
+
+    storage.store_sequence(seq_1);
+    storage.store_sequence(seq_2);
+
+    // create a regular file to test sequence directory loading only
+    std::fstream f(root + "/some_weirdo_file[1234567890abcdef]", std::ios::out);
+    f.close();
+
+    // create a ".git" repository to test that it is not listed as a sequence
+    std::filesystem::create_directory(root + "/.git");
+
+    // create an empty directory with a non-sequence name (should be ignored)
+    std::filesystem::create_directory(root + "/some_weirdo_folder[x1234567890abcdef]");
+
+    // create a sequence directory without a unique ID, but with a sequence.lua file
+    std::filesystem::create_directory(root + "/A legacy sequence");
+    std::fstream f2(root + "/A legacy sequence/sequence.lua", std::ios::out);
+    f2.close();
+
+
+    FolderSequenceStorage sm{ root };
+    auto sequences = sm.list_sequences();
+    std::sort(sequences.begin(), sequences.end(),
+        [](const FolderSequenceStorage::SequenceOnDisk& a,
+           const FolderSequenceStorage::SequenceOnDisk& b)
+        {
+            return a.path < b.path;
+        });
+
+    REQUIRE(sequences.size() == 3);
+
+    REQUIRE_THAT(sequences[0].path, StartsWith("A_legacy_sequence["));
+    REQUIRE_THAT(sequences[0].path, EndsWith("]"));
+    REQUIRE(sequences[0].name == SequenceName{ "A_legacy_sequence" });
+    REQUIRE(sequences[0].unique_id != 0_uid);
+
+    REQUIRE_THAT(sequences[1].path, StartsWith("test.seq.1["));
+    REQUIRE_THAT(sequences[1].path, EndsWith("]"));
+    REQUIRE(sequences[1].name == SequenceName{ "test.seq.1" });
+    REQUIRE(sequences[1].unique_id != 0_uid);
+
+    REQUIRE_THAT(sequences[2].path, StartsWith("test.seq.2["));
+    REQUIRE_THAT(sequences[2].path, EndsWith("]"));
+    REQUIRE(sequences[2].name == SequenceName{ "test.seq.2" });
+    REQUIRE(sequences[2].unique_id != 0_uid);
+}
+
+TEST_CASE("FolderSequenceStorage: store_sequence() - Filename format",
+    "[FolderSequenceStorage]")
+{
+    FolderSequenceStorage storage{ temp_dir };
+
+    const SequenceName seq_name{ "Test_sequence" };
+    const UniqueId seq_uid{ 0xfeeddeafdeadbeef };
+    const auto seq_folder = make_sequence_filename(seq_name, seq_uid);
+
+    if (std::filesystem::exists(temp_dir / seq_folder))
+        std::filesystem::remove_all(temp_dir / seq_folder);
+
+    Sequence sequence{ "", seq_name, seq_uid };
+    sequence.push_back(Step{ Step::type_action });
+    sequence.push_back(Step{ Step::type_if });
+    sequence.push_back(Step{ Step::type_action });
+    sequence.push_back(Step{ Step::type_elseif });
+    sequence.push_back(Step{ Step::type_action });
+    sequence.push_back(Step{ Step::type_end });
+    sequence.push_back(Step{ Step::type_while });
+    sequence.push_back(Step{ Step::type_action });
+    sequence.push_back(Step{ Step::type_end });
+    sequence.push_back(Step{ Step::type_action });
+
+    REQUIRE_NOTHROW(storage.store_sequence(sequence));
+
+    std::vector<std::string> expect{
+        sequence_lua_filename,
+        "step_01_action.lua",
+        "step_02_if.lua",
+        "step_03_action.lua",
+        "step_04_elseif.lua",
+        "step_05_action.lua",
+        "step_06_end.lua",
+        "step_07_while.lua",
+        "step_08_action.lua",
+        "step_09_end.lua",
+        "step_10_action.lua"
+    };
+
+    std::vector<std::string> actual = collect_lua_filenames(temp_dir / seq_folder);
+    std::sort(actual.begin(), actual.end());
+
+    REQUIRE(expect.size() == actual.size());
+    REQUIRE(expect == actual);
+}
+
+TEST_CASE("FolderSequenceStorage: store_sequence() & load_sequence() - Label, name, UID",
+    "[FolderSequenceStorage]")
+{
+    FolderSequenceStorage storage{ temp_dir };
+
+    const auto label = "A/\"sequence\"$[<again>]"s;
+    const SequenceName name{ "gabba-gabba_he.Y" };
+
+    Sequence sequence{ label, name };
+    sequence.push_back(Step{});
+
+    const auto seq_folder = make_sequence_filename(sequence);
+
+    if (std::filesystem::exists(temp_dir / seq_folder))
+        std::filesystem::remove_all(temp_dir / seq_folder);
+
+    auto before = collect_filenames(temp_dir);
+
+    REQUIRE_NOTHROW(storage.store_sequence(sequence));
+
+    auto after = collect_filenames(temp_dir);
+
+    std::vector<std::string> new_filenames;
+    std::set_difference(after.begin(), after.end(),
+                        before.begin(), before.end(),
+                        std::back_inserter(new_filenames));
+
+    REQUIRE(new_filenames.size() == 1);
+    REQUIRE(new_filenames[0] == seq_folder);
+
+    Sequence deserialize_seq = storage.load_sequence(sequence.get_unique_id());
+    REQUIRE(sequence.get_label() == deserialize_seq.get_label());
+    REQUIRE(sequence.get_name() == deserialize_seq.get_name());
+    REQUIRE(sequence.get_unique_id() == deserialize_seq.get_unique_id());
+}
+
+TEST_CASE("FolderSequenceStorage: Sequence archive format", "[FolderSequenceStorage]")
+{
+    FolderSequenceStorage storage{ temp_dir,
+                                   FolderSequenceStorage::StorageFormat::archive };
+    REQUIRE(storage.get_storage_format()
+        == FolderSequenceStorage::StorageFormat::archive);
+
+    Sequence seq{ "Archived sequence", SequenceName{ "archived" } };
+    seq.set_maintainers("Jane Doe");
+    seq.set_timeout(Timeout{ 2min });
+    seq.set_step_setup_script("function f(x) return 2 * x end");
+
+    Step step1{ Step::type_while };
+    step1.set_label("Loop");
+    step1.set_script("return a < 10");
+    step1.set_used_context_variable_names(VariableNames{ "a" });
+
+    Step step2{ Step::type_action };
+    step2.set_label("Tricky script");
+    step2.set_script("a = f(a)\n-- type: end\n-- label: not a label\nb = \"ünïcode\"\n\n");
+    step2.set_timeout(Timeout{ 5s });
+    step2.set_disabled(true);
+
+    Step step3{ Step::type_end };
+
+    seq.push_back(step1);
+    seq.push_back(step2);
+    seq.push_back(step3);
+
+    const auto folder = temp_dir / make_sequence_filename(seq);
+
+    SECTION("Round trip")
+    {
+        storage.store_sequence(seq);
+        REQUIRE(collect_filenames(folder) == std::vector<std::string>{
+            ".sequence_hashes", "sequence.pack" });
+
+        const Sequence loaded = storage.load_sequence(seq.get_unique_id());
+        REQUIRE(loaded.get_label() == "Archived sequence");
+        REQUIRE(loaded.get_name() == seq.get_name());
+        REQUIRE(loaded.get_maintainers() == "Jane Doe");
+        REQUIRE(loaded.get_timeout() == Timeout{ 2min });
+        REQUIRE(loaded.get_step_setup_script() == seq.get_step_setup_script());
+        REQUIRE(loaded.size() == 3);
+        REQUIRE(loaded[0].get_type() == Step::type_while);
+        REQUIRE(loaded[0].get_label() == "Loop");
+        REQUIRE(loaded[0].get_script() == "return a < 10");
+        REQUIRE(loaded[0].get_used_context_variable_names() == VariableNames{ "a" });
+        REQUIRE(loaded[1].get_type() == Step::type_action);
+        REQUIRE(loaded[1].get_label() == "Tricky script");
+        REQUIRE(loaded[1].get_script() == step2.get_script());
+        REQUIRE(loaded[1].get_timeout() == Timeout{ 5s });
+        REQUIRE(loaded[1].is_disabled());
+        REQUIRE(loaded[1].get_indentation_level() == 1);
+        REQUIRE(loaded[2].get_type() == Step::type_end);
+    }
+
+    SECTION("Both formats are readable and can be migrated")
+    {
+        FolderSequenceStorage folder_storage{ temp_dir };
+        REQUIRE(folder_storage.get_storage_format()
+            == FolderSequenceStorage::StorageFormat::folder);
+
+        folder_storage.store_sequence(seq);
+        REQUIRE(not std::filesystem::exists(folder / "sequence.pack"));
+        const Sequence from_folder = storage.load_sequence(seq.get_unique_id());
+
+        // Re-storing migrates the sequence to the archive format
+        storage.store_sequence(from_folder);
+        REQUIRE(collect_filenames(folder) == std::vector<std::string>{
+            ".sequence_hashes", "sequence.pack" });
+        const Sequence from_archive = folder_storage.load_sequence(seq.get_unique_id());
+
+        REQUIRE(from_archive.size() == from_folder.size());
+        for (std::size_t i = 0; i != from_archive.size(); ++i)
+        {
+            REQUIRE(from_archive[i].get_label() == from_folder[i].get_label());
+            REQUIRE(from_archive[i].get_script() == from_folder[i].get_script());
+        }
+        REQUIRE(from_archive.get_step_setup_script()
+            == from_folder.get_step_setup_script());
+
+        // ... and back
+        storage.set_storage_format(FolderSequenceStorage::StorageFormat::folder);
+        storage.store_sequence(from_archive);
+        REQUIRE(not std::filesystem::exists(folder / "sequence.pack"));
+        REQUIRE(std::filesystem::exists(folder / "sequence.lua"));
+    }
+
+    SECTION("Corrupt archives are rejected")
+    {
+        storage.store_sequence(seq);
+
+        std::string content;
+        {
+            std::ifstream in(folder / "sequence.pack", std::ios::binary);
+            content.assign(std::istreambuf_iterator<char>{ in },
+                           std::istreambuf_iterator<char>{});
+        }
+
+        auto write_archive = [&](const std::string& str)
+            {
+                std::ofstream out(folder / "sequence.pack",
+                                  std::ios::binary | std::ios::trunc);
+                out << str;
+            };
+
+        write_archive(content.substr(0, content.size() - 10)); // truncated
+        REQUIRE_THROWS_WITH(storage.load_sequence(seq.get_unique_id()),
+            Contains("Entry exceeds the file size"));
+
+        write_archive("-- taskolib sequence archive: 2\n");
+        REQUIRE_THROWS_WITH(storage.load_sequence(seq.get_unique_id()),
+            Contains("Unsupported sequence archive version"));
+
+        write_archive("");
+        REQUIRE_THROWS_WITH(storage.load_sequence(seq.get_unique_id()),
+            Contains("Missing header line"));
+    }
+
+    std::filesystem::remove_all(folder);
+}
+
+TEST_CASE("FolderSequenceStorage: store_sequence() only writes changed steps",
+    "[FolderSequenceStorage]")
+{
+    FolderSequenceStorage storage{ temp_dir };
+
+    Sequence seq{ "Incremental storage", SequenceName{ "incremental" } };
+    for (int i = 1; i <= 3; ++i)
+    {
+        Step step{ Step::type_action };
+        step.set_label(gul14::cat("Step ", i));
+        step.set_script(gul14::cat("a = ", i));
+        seq.push_back(step);
+    }
+
+    const auto folder = temp_dir / make_sequence_filename(seq);
+    std::filesystem::remove_all(folder);
+    storage.store_sequence(seq);
+
+    // Backdate all files so that rewritten files can be recognized
+    const auto old_time = std::filesystem::last_write_time(folder / "sequence.lua")
+        - std::chrono::hours{ 24 };
+    const auto backdate = [&]()
+        {
+            for (const auto& entry : std::filesystem::directory_iterator{ folder })
+                std::filesystem::last_write_time(entry.path(), old_time);
+        };
+    const auto is_untouched = [&](const std::string& filename)
+        {
+            return std::filesystem::last_write_time(folder / filename) == old_time;
+        };
+    const auto read = [&](const std::string& filename)
+        {
+            std::ifstream in(folder / filename);
+            return std::string{ std::istreambuf_iterator<char>{ in },
+                                std::istreambuf_iterator<char>{} };
+        };
+
+    backdate();
+
+    SECTION("Unchanged sequence")
+    {
+        storage.store_sequence(seq);
+        REQUIRE(is_untouched("sequence.lua"));
+        REQUIRE(is_untouched("step_1_action.lua"));
+        REQUIRE(is_untouched("step_2_action.lua"));
+        REQUIRE(is_untouched("step_3_action.lua"));
+    }
+
+    SECTION("Modified step")
+    {
+        seq.modify(seq.begin() + 1, [](Step& s) { s.set_label("Modified"); });
+        storage.store_sequence(seq);
+        REQUIRE(is_untouched("sequence.lua"));
+        REQUIRE(is_untouched("step_1_action.lua"));
+        REQUIRE(not is_untouched("step_2_action.lua"));
+        REQUIRE(is_untouched("step_3_action.lua"));
+        REQUIRE_THAT(read("step_2_action.lua"), Contains("-- label: Modified"));
+    }
+
+    SECTION("Inserted step")
+    {
+        Step step{ Step::type_action };
+        step.set_label("Inserted");
+        seq.insert(seq.begin(), step);
+        storage.store_sequence(seq);
+
+        REQUIRE(collect_filenames(folder) == std::vector<std::string>{
+            ".sequence_hashes", "sequence.lua", "step_1_action.lua", "step_2_action.lua",
+            "step_3_action.lua", "step_4_action.lua" });
+
+        // The old steps have been renamed, not rewritten
+        REQUIRE(not is_untouched("step_1_action.lua"));
+        REQUIRE(is_untouched("step_2_action.lua"));
+        REQUIRE(is_untouched("step_3_action.lua"));
+        REQUIRE(is_untouched("step_4_action.lua"));
+        REQUIRE_THAT(read("step_1_action.lua"), Contains("-- label: Inserted"));
+        REQUIRE_THAT(read("step_2_action.lua"), Contains("-- label: Step 1"));
+        REQUIRE_THAT(read("step_4_action.lua"), Contains("-- label: Step 3"));
+    }
+
+    SECTION("Removed and swapped steps")
+    {
+        seq.erase(seq.begin());
+        const Step step2 = seq[0];
+        const Step step3 = seq[1];
+        seq.assign(seq.begin(), step3);
+        seq.assign(seq.begin() + 1, step2);
+        storage.store_sequence(seq);
+
+        REQUIRE(collect_filenames(folder) == std::vector<std::string>{
+            ".sequence_hashes", "sequence.lua", "step_1_action.lua",
+            "step_2_action.lua" });
+        REQUIRE(is_untouched("step_1_action.lua"));
+        REQUIRE(is_untouched("step_2_action.lua"));
+        REQUIRE_THAT(read("step_1_action.lua"), Contains("-- label: Step 3"));
+        REQUIRE_THAT(read("step_2_action.lua"), Contains("-- label: Step 2"));
+    }
+
+    SECTION("Files are recognized by their hashes without being read")
+    {
+        storage.store_sequence(seq); // record the hashes of the backdated files
+
+        // Change the content without changing inode, size, or modification time
+        auto content = read("step_2_action.lua");
+        const auto pos = content.find("Step 2");
+        REQUIRE(pos != std::string::npos);
+        content.replace(pos, 6, "Step X");
+        std::ofstream{ folder / "step_2_action.lua" } << content;
+        std::filesystem::last_write_time(folder / "step_2_action.lua", old_time);
+
+        storage.store_sequence(seq);
+        REQUIRE(is_untouched("step_2_action.lua"));
+        REQUIRE_THAT(read("step_2_action.lua"), Contains("-- label: Step X"));
+
+        seq.modify(seq.begin() + 1, [](Step& s) { s.set_label("Step X"); });
+    }
+
+    SECTION("Files modified by other means are detected")
+    {
+        storage.store_sequence(seq);
+
+        auto content = read("step_2_action.lua");
+        content.replace(content.find("Step 2"), 6, "Step X");
+        std::ofstream{ folder / "step_2_action.lua" } << content;
+
+        storage.store_sequence(seq);
+        REQUIRE_THAT(read("step_2_action.lua"), Contains("-- label: Step 2"));
+    }
+
+    SECTION("A corrupt hash file is ignored")
+    {
+        std::ofstream{ folder / ".sequence_hashes" } << "-- taskolib file hashes: 1\n"
+            "0 0 0 0 step_2_action.lua\n";
+
+        seq.modify(seq.begin() + 2, [](Step& s) { s.set_label("Modified"); });
+        storage.store_sequence(seq);
+        REQUIRE(is_untouched("step_1_action.lua"));
+        REQUIRE(is_untouched("step_2_action.lua"));
+        REQUIRE_THAT(read("step_3_action.lua"), Contains("-- label: Modified"));
+    }
+
+    const Sequence loaded = storage.load_sequence(seq.get_unique_id());
+    REQUIRE(loaded.size() == seq.size());
+    for (std::size_t i = 0; i != seq.size(); ++i)
+        REQUIRE(loaded[i].get_label() == seq[i].get_label());
+
+    std::filesystem::remove_all(folder);
+}
+
+TEST_CASE("FolderSequenceStorage: Parallel loading of steps", "[FolderSequenceStorage]")
+{
+    FolderSequenceStorage storage{ temp_dir };
+    REQUIRE(storage.get_num_load_threads() == 1);
+
+    Sequence seq{ "Parallel loading", SequenceName{ "parallel" } };
+    for (int i = 0; i != 50; ++i)
+    {
+        Step step{ i % 10 == 0 ? Step::type_while
+                   : i % 10 == 9 ? Step::type_end : Step::type_action };
+        step.set_label(gul14::cat("Step ", i));
+        step.set_script(gul14::cat("return ", i));
+        seq.push_back(step);
+    }
+
+    const auto folder = temp_dir / make_sequence_filename(seq);
+    std::filesystem::remove_all(folder);
+    storage.store_sequence(seq);
+
+    storage.set_num_load_threads(4);
+    REQUIRE(storage.get_num_load_threads() == 4);
+
+    SECTION("Steps are assembled in order")
+    {
+        const Sequence loaded = storage.load_sequence(seq.get_unique_id());
+        REQUIRE(loaded.size() == seq.size());
+        REQUIRE(loaded.get_indentation_error() == "");
+        for (std::size_t i = 0; i != seq.size(); ++i)
+        {
+            REQUIRE(loaded[i].get_label() == seq[i].get_label());
+            REQUIRE(loaded[i].get_script() == seq[i].get_script());
+            REQUIRE(loaded[i].get_indentation_level() == seq[i].get_indentation_level());
+        }
+    }
+
+    SECTION("Errors are reported")
+    {
+        std::ofstream{ folder / "step_27_action.lua" } << "-- type: invalid\n";
+        REQUIRE_THROWS_WITH(storage.load_sequence(seq.get_unique_id()),
+            Contains("type: unable to parse"));
+    }
+
+    SECTION("0 selects the number of hardware threads")
+    {
+        storage.set_num_load_threads(0);
+        REQUIRE(storage.get_num_load_threads() >= 1);
+        REQUIRE(storage.load_sequence(seq.get_unique_id()).size() == seq.size());
+    }
+
+    std::filesystem::remove_all(folder);
+}
+
+TEST_CASE("FolderSequenceStorage: store_sequence() replaces the sequence folder "
+          "atomically",
+    "[FolderSequenceStorage]")
+{
+    FolderSequenceStorage storage{ temp_dir };
+
+    Sequence seq{ "Atomic save", SequenceName{ "atomic" } };
+    seq.push_back(Step{ Step::type_action });
+
+    const auto folder_name = make_sequence_filename(seq);
+    const auto folder = temp_dir / folder_name;
+    const auto tmp_folder = temp_dir / ("." + folder_name + ".tmp");
+    std::filesystem::remove_all(folder);
+
+    storage.store_sequence(seq);
+    REQUIRE(not std::filesystem::exists(tmp_folder));
+
+    SECTION("Leftovers of an interrupted save are ignored and cleaned up")
+    {
+        std::filesystem::create_directories(tmp_folder);
+        std::ofstream{ tmp_folder / "sequence.lua" } << "-- label: Half-written\n";
+
+        const auto sequences = storage.list_sequences();
+        REQUIRE(std::count_if(sequences.begin(), sequences.end(),
+            [](const auto& s) { return s.name == SequenceName{ "atomic" }; }) == 1);
+        REQUIRE(std::filesystem::exists(tmp_folder)); // not adopted as a legacy folder
+
+        seq.push_back(Step{ Step::type_action });
+        storage.store_sequence(seq);
+        REQUIRE(not std::filesystem::exists(tmp_folder));
+        REQUIRE(storage.load_sequence(seq.get_unique_id()).size() == 2);
+    }
+
+    SECTION("Foreign files in the sequence folder are kept")
+    {
+        std::ofstream{ folder / "notes.txt" } << "Some notes";
+        storage.store_sequence(seq);
+        REQUIRE(collect_filenames(folder) == std::vector<std::string>{
+            ".sequence_hashes", "notes.txt", "sequence.lua", "step_1_action.lua" });
+
+        storage.set_storage_format(FolderSequenceStorage::StorageFormat::archive);
+        storage.store_sequence(seq);
+        REQUIRE(collect_filenames(folder) == std::vector<std::string>{
+            ".sequence_hashes", "notes.txt", "sequence.pack" });
+    }
+
+    SECTION("A failed replacement puts the old folder back")
+    {
+        const auto missing = temp_dir / ".missing.tmp";
+        REQUIRE_THROWS_AS(replace_directory(missing, folder), Error);
+        REQUIRE(std::filesystem::exists(folder / "step_1_action.lua"));
+        REQUIRE(not std::filesystem::exists(temp_dir / ".missing.tmp.old"));
+        REQUIRE(storage.load_sequence(seq.get_unique_id()).size() == 1);
+    }
+
+    SECTION("The backup of an interrupted save is restored")
+    {
+        const auto backup = temp_dir / ("." + folder_name + ".tmp.old");
+        std::filesystem::rename(folder, backup);
+
+        FolderSequenceStorage new_storage{ temp_dir };
+        const auto sequences = new_storage.list_sequences();
+        REQUIRE(std::count_if(sequences.begin(), sequences.end(),
+            [&](const auto& s) { return s.unique_id == seq.get_unique_id(); }) == 1);
+        REQUIRE(not std::filesystem::exists(backup));
+        REQUIRE(new_storage.load_sequence(seq.get_unique_id()).size() == 1);
+    }
+
+    SECTION("A backup is ignored if the sequence folder exists")
+    {
+        const auto backup = temp_dir / ("." + folder_name + ".tmp.old");
+        std::filesystem::create_directories(backup);
+
+        FolderSequenceStorage new_storage{ temp_dir };
+        const auto sequences = new_storage.list_sequences();
+        REQUIRE(std::count_if(sequences.begin(), sequences.end(),
+            [&](const auto& s) { return s.unique_id == seq.get_unique_id(); }) == 1);
+        REQUIRE(std::filesystem::exists(backup));
+        REQUIRE(new_storage.load_sequence(seq.get_unique_id()).size() == 1);
+
+        storage.store_sequence(seq);
+        REQUIRE(not std::filesystem::exists(backup));
+    }
+
+    std::filesystem::remove_all(folder);
+}
+
+TEST_CASE("FolderSequenceStorage: Catalog of sequences", "[FolderSequenceStorage]")
+{
+    const auto base = temp_dir / "catalog";
+    std::filesystem::remove_all(base);
+    std::filesystem::create_directories(base);
+
+    FolderSequenceStorage storage{ base };
+    const Sequence seq1{ "One", SequenceName{ "one" } };
+    const Sequence seq2{ "Two", SequenceName{ "two" } };
+    storage.store_sequence(seq1);
+    storage.store_sequence(seq2);
+
+    // Backdate the base folder so that its timestamp is trusted
+    const auto old_time = std::filesystem::last_write_time(base) - std::chrono::hours{ 1 };
+    std::filesystem::last_write_time(base, old_time);
+
+    REQUIRE(storage.list_sequences().size() == 2);
+    REQUIRE(storage.load_sequence(seq2.get_unique_id()).get_name() == seq2.get_name());
+
+    SECTION("The catalog is reused while the folder time is unchanged")
+    {
+        // Sneak in a sequence without changing the folder time
+        const Sequence seq3{ "Three", SequenceName{ "three" } };
+        std::filesystem::create_directory(base / make_sequence_filename(seq3));
+        std::filesystem::last_write_time(base, old_time);
+        REQUIRE(storage.list_sequences().size() == 2);
+
+        // Any change of the folder time triggers a rescan
+        std::filesystem::last_write_time(base, old_time + std::chrono::seconds{ 1 });
+        REQUIRE(storage.list_sequences().size() == 3);
+        REQUIRE_NOTHROW(storage.load_sequence(seq3.get_unique_id()));
+    }
+
+    SECTION("Own modifications are picked up")
+    {
+        storage.remove_sequence(seq1.get_unique_id());
+        REQUIRE(storage.list_sequences().size() == 1);
+        REQUIRE_THROWS_AS(storage.load_sequence(seq1.get_unique_id()), Error);
+
+        storage.rename_sequence(seq2.get_unique_id(), SequenceName{ "renamed" });
+        REQUIRE(storage.list_sequences().at(0).name == SequenceName{ "renamed" });
+        REQUIRE(storage.load_sequence(seq2.get_unique_id()).get_name()
+            == SequenceName{ "renamed" });
+    }
+
+    SECTION("Persistent catalog file")
+    {
+        storage.set_catalog_file_enabled(true);
+        REQUIRE(storage.is_catalog_file_enabled());
+
+        // Creating the catalog file changes the folder time, so write it a second time
+        std::filesystem::last_write_time(base, old_time - std::chrono::seconds{ 1 });
+        storage.list_sequences();
+        REQUIRE(std::filesystem::exists(base / ".sequence_catalog"));
+        std::filesystem::last_write_time(base, old_time);
+        storage.list_sequences();
+
+        // Remove a sequence behind the back of the catalog file
+        std::filesystem::remove_all(base / make_sequence_filename(seq1));
+        std::filesystem::last_write_time(base, old_time);
+
+        FolderSequenceStorage storage_with_file{ base };
+        storage_with_file.set_catalog_file_enabled(true);
+        REQUIRE(storage_with_file.list_sequences().size() == 2); // read from the file
+
+        FolderSequenceStorage storage_without_file{ base };
+        REQUIRE(storage_without_file.list_sequences().size() == 1);
+
+        // A damaged catalog file is ignored
+        std::ofstream{ base / ".sequence_catalog" } << "-- taskolib sequence catalog: 1\n";
+        std::filesystem::last_write_time(base, old_time);
+        FolderSequenceStorage storage_with_damaged_file{ base };
+        storage_with_damaged_file.set_catalog_file_enabled(true);
+        REQUIRE(storage_with_damaged_file.list_sequences().size() == 1);
+    }
+
+    SECTION("Concurrent use from several threads")
+    {
+        std::vector<Sequence> created;
+        std::thread writer{ [&]()
+            {
+                for (int i = 0; i != 20; ++i)
+                {
+                    created.emplace_back(gul14::cat("New ", i));
+                    storage.store_sequence(created.back());
+                }
+            } };
+
+        std::atomic<int> num_bad_reads{ 0 };
+        std::vector<std::thread> readers;
+        for (int i = 0; i != 4; ++i)
+        {
+            readers.emplace_back([&]()
+                {
+                    for (int j = 0; j != 50; ++j)
+                    {
+                        try
+                        {
+                            if (storage.list_sequences().size() < 2
+                                or storage.load_sequence_header(seq2.get_unique_id()).name
+                                    != seq2.get_name())
+                            {
+                                ++num_bad_reads;
+                            }
+                        }
+                        catch (const Error&)
+                        {
+                            ++num_bad_reads;
+                        }
+                    }
+                });
+        }
+
+        writer.join();
+        for (auto& reader : readers)
+            reader.join();
+
+        REQUIRE(num_bad_reads == 0);
+        REQUIRE(storage.list_sequences().size() == 22);
+        for (const auto& seq : created)
+            REQUIRE_NOTHROW(storage.load_sequence_header(seq.get_unique_id()));
+    }
+
+    SECTION("Copies have their own catalog")
+    {
+        FolderSequenceStorage copy{ storage };
+        REQUIRE(copy.get_path() == base);
+        REQUIRE(copy.list_sequences().size() == 2);
+
+        copy.remove_sequence(seq1.get_unique_id());
+        REQUIRE(storage.list_sequences().size() == 1);
+
+        storage = copy;
+        REQUIRE(storage.list_sequences().size() == 1);
+    }
+
+    std::filesystem::remove_all(base);
+}
+
+TEST_CASE("FolderSequenceStorage: load_sequence_header()", "[FolderSequenceStorage]")
+{
+    const auto base = temp_dir / "headers";
+    std::filesystem::remove_all(base);
+    std::filesystem::create_directories(base);
+
+    const auto format = GENERATE(FolderSequenceStorage::StorageFormat::folder,
+                                 FolderSequenceStorage::StorageFormat::archive);
+
+    FolderSequenceStorage storage{ base, format };
+
+    Sequence seq{ "Header test", SequenceName{ "header_test" } };
+    seq.set_maintainers("John Doe");
+    seq.set_timeout(Timeout{ 42s });
+    seq.push_back(Step{ Step::type_while });
+    seq.push_back(Step{ Step::type_action });
+    seq.push_back(Step{ Step::type_end });
+    storage.store_sequence(seq);
+
+    const Sequence empty_seq{ "Empty", SequenceName{ "empty" } };
+    storage.store_sequence(empty_seq);
+
+    const auto header = storage.load_sequence_header(seq.get_unique_id());
+    const auto loaded = storage.load_sequence(seq.get_unique_id());
+    REQUIRE(header.path == make_sequence_filename(seq));
+    REQUIRE(header.name == loaded.get_name());
+    REQUIRE(header.unique_id == seq.get_unique_id());
+    REQUIRE(header.label == loaded.get_label());
+    REQUIRE(header.label == "Header test");
+    REQUIRE(header.maintainers == "John Doe");
+    REQUIRE(header.timeout == Timeout{ 42s });
+    REQUIRE(header.num_steps == loaded.size());
+    REQUIRE(header.num_steps == 3);
+
+    const auto empty_header = storage.load_sequence_header(empty_seq.get_unique_id());
+    REQUIRE(empty_header.label == "Empty");
+    REQUIRE(empty_header.num_steps == 0);
+
+    const auto headers = storage.load_sequence_headers();
+    REQUIRE(headers.size() == 2);
+
+    REQUIRE_THROWS_AS(storage.load_sequence_header(UniqueId{}), Error);
+
+    std::filesystem::remove_all(base);
+}
+
+TEST_CASE("FolderSequenceStorage: Cache of loaded sequences", "[FolderSequenceStorage]")
+{
+    const auto base = temp_dir / "cache";
+    std::filesystem::remove_all(base);
+    std::filesystem::create_directories(base);
+
+    FolderSequenceStorage storage{ base };
+    REQUIRE(storage.get_cache_capacity() == 0);
+
+    Sequence seq1{ "One", SequenceName{ "one" } };
+    seq1.push_back(Step{ Step::type_action });
+    Sequence seq2{ "Two", SequenceName{ "two" } };
+    Sequence seq3{ "Three", SequenceName{ "three" } };
+    storage.store_sequence(seq1);
+    storage.store_sequence(seq2);
+    storage.store_sequence(seq3);
+
+    // Backdate all sequence folders and files so that their timestamps are trusted
+    const auto old_time = std::filesystem::last_write_time(base) - std::chrono::hours{ 1 };
+    const auto backdate = [&]()
+        {
+            for (const auto& entry : std::filesystem::recursive_directory_iterator{ base })
+                std::filesystem::last_write_time(entry.path(), old_time);
+        };
+    backdate();
+
+    SECTION("Without a cache, each load returns a new snapshot")
+    {
+        const auto a = storage.load_sequence_snapshot(seq1.get_unique_id());
+        const auto b = storage.load_sequence_snapshot(seq1.get_unique_id());
+        REQUIRE(a != b);
+        REQUIRE(a->get_label() == "One");
+    }
+
+    storage.set_cache_capacity(2);
+    REQUIRE(storage.get_cache_capacity() == 2);
+
+    SECTION("Unmodified sequences are shared")
+    {
+        const auto a = storage.load_sequence_snapshot(seq1.get_unique_id());
+        const auto b = storage.load_sequence_snapshot(seq1.get_unique_id());
+        REQUIRE(a == b);
+        REQUIRE(a->size() == 1);
+        REQUIRE(storage.load_sequence(seq1.get_unique_id()).get_label() == "One");
+
+        storage.clear_cache();
+        REQUIRE(storage.load_sequence_snapshot(seq1.get_unique_id()) != a);
+    }
+
+    SECTION("The least recently used sequence is evicted")
+    {
+        const auto a = storage.load_sequence_snapshot(seq1.get_unique_id());
+        const auto b = storage.load_sequence_snapshot(seq2.get_unique_id());
+        REQUIRE(storage.load_sequence_snapshot(seq1.get_unique_id()) == a);
+
+        storage.load_sequence_snapshot(seq3.get_unique_id()); // evicts seq2
+        REQUIRE(storage.load_sequence_snapshot(seq1.get_unique_id()) == a);
+        REQUIRE(storage.load_sequence_snapshot(seq2.get_unique_id()) != b);
+
+        storage.set_cache_capacity(0);
+        REQUIRE(storage.load_sequence_snapshot(seq1.get_unique_id()) != a);
+    }
+
+    SECTION("Modifications on disk are detected")
+    {
+        const auto a = storage.load_sequence_snapshot(seq1.get_unique_id());
+
+        // Store a modified sequence through another storage
+        Sequence modified = seq1;
+        modified.modify(modified.begin(), [](Step& s) { s.set_script("a = 1"); });
+        FolderSequenceStorage{ base }.store_sequence(modified);
+        backdate();
+
+        const auto b = storage.load_sequence_snapshot(seq1.get_unique_id());
+        REQUIRE(b != a);
+        REQUIRE((*b)[0].get_script() == "a = 1");
+        REQUIRE((*a)[0].get_script() == ""); // the old snapshot is unchanged
+
+        REQUIRE(storage.load_sequence_snapshot(seq1.get_unique_id()) == b);
+
+        // Replace a step file like an editor does
+        const auto folder = base / make_sequence_filename(seq1);
+        auto content = read_file(folder / "step_1_action.lua");
+        content.replace(content.find("a = 1"), 5, "a = 2");
+        std::ofstream{ folder / "new.lua" } << content;
+        std::filesystem::rename(folder / "new.lua", folder / "step_1_action.lua");
+        std::filesystem::last_write_time(folder, old_time + std::chrono::seconds{ 1 });
+
+        const auto c = storage.load_sequence_snapshot(seq1.get_unique_id());
+        REQUIRE(c != b);
+        REQUIRE((*c)[0].get_script() == "a = 2");
+    }
+
+    SECTION("Concurrent use from several threads")
+    {
+        std::atomic<int> num_bad_loads{ 0 };
+        std::vector<std::thread> threads;
+        for (int i = 0; i != 4; ++i)
+        {
+            threads.emplace_back([&, i]()
+                {
+                    const auto& seq = (i % 2 == 0) ? seq1 : seq2;
+                    for (int j = 0; j != 50; ++j)
+                    {
+                        try
+                        {
+                            if (storage.load_sequence_snapshot(seq.get_unique_id())
+                                    ->get_label() != seq.get_label())
+                            {
+                                ++num_bad_loads;
+                            }
+                        }
+                        catch (const Error&)
+                        {
+                            ++num_bad_loads;
+                        }
+                    }
+                });
+        }
+
+        for (int j = 0; j != 10; ++j)
+        {
+            storage.store_sequence(seq3);
+            storage.clear_cache();
+        }
+
+        for (auto& thread : threads)
+            thread.join();
+
+        REQUIRE(num_bad_loads == 0);
+    }
+
+    SECTION("Files overwritten in place require clear_cache()")
+    {
+        const auto a = storage.load_sequence_snapshot(seq1.get_unique_id());
+
+        const auto folder = base / make_sequence_filename(seq1);
+        std::ofstream{ folder / "step_1_action.lua", std::ios::app } << "a = 1\n";
+        REQUIRE(storage.load_sequence_snapshot(seq1.get_unique_id()) == a);
+
+        storage.clear_cache();
+        REQUIRE((*storage.load_sequence_snapshot(seq1.get_unique_id()))[0].get_script()
+            == "a = 1");
+    }
+
+    SECTION("Recently modified sequences are not cached")
+    {
+        storage.store_sequence(seq1);
+        const auto a = storage.load_sequence_snapshot(seq1.get_unique_id());
+        REQUIRE(storage.load_sequence_snapshot(seq1.get_unique_id()) != a);
+    }
+
+    SECTION("Storing, renaming, and removing sequences updates the cache")
+    {
+        const auto a = storage.load_sequence_snapshot(seq1.get_unique_id());
+
+        seq1.set_label("Changed");
+        storage.store_sequence(seq1);
+        backdate();
+        const auto b = storage.load_sequence_snapshot(seq1.get_unique_id());
+        REQUIRE(b->get_label() == "Changed");
+        REQUIRE(storage.load_sequence_snapshot(seq1.get_unique_id()) == b);
+
+        storage.rename_sequence(seq1.get_unique_id(), SequenceName{ "renamed" });
+        const auto c = storage.load_sequence_snapshot(seq1.get_unique_id());
+        REQUIRE(c->get_name() == SequenceName{ "renamed" });
+
+        storage.remove_sequence(seq1.get_unique_id());
+        REQUIRE_THROWS_AS(storage.load_sequence_snapshot(seq1.get_unique_id()), Error);
+    }
+
+    std::filesystem::remove_all(base);
+}
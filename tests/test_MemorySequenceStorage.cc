@@ -0,0 +1,66 @@
+/**
+ * \file   test_MemorySequenceStorage.cc
+ * \author Lars Fröhlich
+ * \date   Created on October 18, 2026
+ * \brief  Test suite for the MemorySequenceStorage class.
+ *
+ * \copyright Copyright 2026 Deutsches Elektronen-Synchrotron (DESY), Hamburg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+
+#include <gul14/catch.h>
+
+#include "serialize_sequence.h"
+#include "taskolib/MemorySequenceStorage.h"
+
+using namespace task;
+
+TEST_CASE("MemorySequenceStorage: Copies share the stored sequences",
+          "[MemorySequenceStorage]")
+{
+    const MemorySequenceStorage storage;
+    const MemorySequenceStorage copy = storage;
+
+    const Sequence seq{ "Shared", SequenceName{ "shared" } };
+    storage.store_sequence(seq);
+
+    const auto list = copy.list_sequences();
+    REQUIRE(list.size() == 1);
+    REQUIRE(list[0].path == make_sequence_filename(seq));
+    REQUIRE(copy.load_sequence(seq.get_unique_id()).get_label() == "Shared");
+
+    copy.remove_sequence(seq.get_unique_id());
+    REQUIRE(storage.list_sequences().empty());
+}
+
+TEST_CASE("MemorySequenceStorage: Stored sequences are independent of the original",
+          "[MemorySequenceStorage]")
+{
+    const MemorySequenceStorage storage;
+
+    Sequence seq{ "Original", SequenceName{ "original" } };
+    seq.push_back(Step{ Step::type_action });
+    storage.store_sequence(seq);
+
+    seq.set_label("Changed");
+    seq.push_back(Step{ Step::type_action });
+
+    const Sequence loaded = storage.load_sequence(seq.get_unique_id());
+    REQUIRE(loaded.get_label() == "Original");
+    REQUIRE(loaded.size() == 1);
+}
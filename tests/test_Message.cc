@@ -138,6 +138,20 @@ TEST_CASE("Message: set_timestamp()", "[Message]")
     REQUIRE(msg.get_timestamp() == TimePoint{});
 }
 
+TEST_CASE("Message: set_statistics()", "[Message]")
+{
+    Message msg;
+    REQUIRE(msg.get_statistics() == StepStatistics{});
+
+    StepStatistics stats;
+    stats.num_instructions = 1200;
+    stats.peak_stack_depth = 3;
+
+    REQUIRE(&msg.set_statistics(stats) == &msg);
+    REQUIRE(msg.get_statistics() == stats);
+    REQUIRE(msg.get_statistics().num_instructions == 1200);
+}
+
 TEST_CASE("Message: set_type()", "[Message]")
 {
     Message msg;
@@ -0,0 +1,138 @@
+/**
+ * \file   test_NumericArray.cc
+ * \author Lars Fröhlich
+ * \date   Created on October 18, 2026
+ * \brief  Test suite for the NumericArray class template and the array kernels.
+ *
+ * \copyright Copyright 2026 Deutsches Elektronen-Synchrotron (DESY), Hamburg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include <limits>
+
+#include <gul14/catch.h>
+
+#include "taskolib/exceptions.h"
+#include "taskolib/NumericArray.h"
+
+using namespace task;
+
+TEST_CASE("NumericArray: Constructors", "[NumericArray]")
+{
+    NumericArray<double> a;
+    REQUIRE(a.empty());
+    REQUIRE(a.size() == 0);
+    REQUIRE(a.data() == nullptr);
+    REQUIRE(a.begin() == a.end());
+
+    NumericArray<double> b(3, 1.5);
+    REQUIRE(b.size() == 3);
+    REQUIRE(b.get() == std::vector<double>{ 1.5, 1.5, 1.5 });
+
+    NumericArray<long long> c{ 1, 2, 3 };
+    REQUIRE(c.size() == 3);
+    REQUIRE(c[2] == 3);
+
+    NumericArray<long long> d{ std::vector<long long>{ 4, 5 } };
+    REQUIRE(d.get() == std::vector<long long>{ 4, 5 });
+}
+
+TEST_CASE("NumericArray: Copy-on-write", "[NumericArray]")
+{
+    const NumericArray<double> a{ 1.0, 2.0, 3.0 };
+    NumericArray<double> b = a;
+
+    REQUIRE(b.shares_storage_with(a));
+    REQUIRE(b.data() == a.data());
+    REQUIRE(b == a);
+
+    b.set(0, 42.0);
+    REQUIRE_FALSE(b.shares_storage_with(a));
+    REQUIRE(a[0] == 1.0);
+    REQUIRE(b[0] == 42.0);
+    REQUIRE(b != a);
+
+    // An array that does not share its storage is modified in place
+    b.get_mutable().push_back(4.0);
+    const double* ptr = b.data();
+    b.set(1, 0.0);
+    REQUIRE(b.size() == 4);
+    REQUIRE(b.data() == ptr);
+
+    // Equal contents compare equal even with separate storage
+    NumericArray<double> c{ 1.0, 2.0, 3.0 };
+    REQUIRE(c == a);
+    REQUIRE_FALSE(c.shares_storage_with(a));
+}
+
+TEST_CASE("NumericArray: Kernels", "[NumericArray]")
+{
+    NumericArray<double> x(1001);
+    for (std::size_t i = 0; i != x.size(); ++i)
+        x.set(i, static_cast<double>(i));
+
+    REQUIRE(sum(x) == 500500.0);
+    REQUIRE(mean(x) == 500.0);
+    REQUIRE(minimum(x) == 0.0);
+    REQUIRE(maximum(x) == 1000.0);
+    REQUIRE(dot(x, NumericArray<double>(1001, 2.0)) == 1001000.0);
+    REQUIRE(find_threshold(x, 999.5) == std::size_t{ 1000 });
+    REQUIRE(find_threshold(x, 1000.5).has_value() == false);
+
+    const auto scaled = scale_and_offset(x, 2.0, -1.0);
+    REQUIRE(scaled.size() == 1001);
+    REQUIRE(scaled[0] == -1.0);
+    REQUIRE(scaled[1000] == 1999.0);
+
+    const NumericArray<long long> i{ -5, 7, 3, 7, 2 };
+    REQUIRE(sum(i) == 14);
+    REQUIRE(mean(i) == 2.8);
+    REQUIRE(minimum(i) == -5);
+    REQUIRE(maximum(i) == 7);
+    REQUIRE(dot(i, i) == 25 + 49 + 9 + 49 + 4);
+    REQUIRE(find_threshold(i, 7LL) == std::size_t{ 1 });
+    REQUIRE(scale_and_offset(i, 0.5).get() == std::vector<double>{ -2.5, 3.5, 1.5, 3.5, 1.0 });
+}
+
+TEST_CASE("NumericArray: Integer kernels wrap around on overflow", "[NumericArray]")
+{
+    constexpr auto max = std::numeric_limits<long long>::max();
+    constexpr auto min = std::numeric_limits<long long>::min();
+
+    const NumericArray<long long> big{ max, max, 2 };
+    REQUIRE(sum(big) == 0); // 2 * max + 2 == 2^64
+    REQUIRE(mean(big) == Approx(2.0 * static_cast<double>(max) / 3.0));
+    REQUIRE(sum(NumericArray<long long>{ max, 1 }) == min);
+
+    // 5 * (2 * max) == 5 * (2^64 - 2) == -10 (mod 2^64)
+    REQUIRE(dot(NumericArray<long long>(5, max), NumericArray<long long>(5, 2)) == -10);
+    REQUIRE(dot(NumericArray<long long>{ min }, NumericArray<long long>{ -1 }) == min);
+}
+
+TEST_CASE("NumericArray: Kernels on empty arrays", "[NumericArray]")
+{
+    const NumericArray<double> empty;
+
+    REQUIRE(sum(empty) == 0.0);
+    REQUIRE_THROWS_AS(mean(empty), Error);
+    REQUIRE_THROWS_AS(minimum(empty), Error);
+    REQUIRE_THROWS_AS(maximum(empty), Error);
+    REQUIRE(dot(empty, empty) == 0.0);
+    REQUIRE_THROWS_AS(dot(empty, NumericArray<double>{ 1.0 }), Error);
+    REQUIRE(find_threshold(empty, 0.0).has_value() == false);
+    REQUIRE(scale_and_offset(empty, 2.0).empty());
+}
@@ -0,0 +1,130 @@
+/**
+ * \file   test_Profiler.cc
+ * \author Lars Fröhlich
+ * \date   Created on October 18, 2026
+ * \brief  Test suite for the Profiler class.
+ *
+ * \copyright Copyright 2026 Deutsches Elektronen-Synchrotron (DESY), Hamburg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include <memory>
+
+#include <gul14/catch.h>
+#include <gul14/join_split.h>
+
+#include "taskolib/exceptions.h"
+#include "taskolib/Profiler.h"
+#include "taskolib/Sequence.h"
+#include "taskolib/Step.h"
+
+using namespace std::literals;
+using namespace task;
+using Catch::Matchers::Contains;
+using Catch::Matchers::StartsWith;
+
+TEST_CASE("Profiler: Constructors", "[Profiler]")
+{
+    Profiler p;
+    REQUIRE(p.get_instruction_interval() == 1000);
+    REQUIRE(p.get_time_interval() == 0us);
+    REQUIRE(p.get_sample_count() == 0);
+    REQUIRE(p.get_folded_stacks() == "");
+
+    Profiler p2{ 42 };
+    REQUIRE(p2.get_instruction_interval() == 42);
+
+    Profiler p3{ 2ms };
+    REQUIRE(p3.get_instruction_interval() == 0);
+    REQUIRE(p3.get_time_interval() == 2000us);
+
+    REQUIRE_THROWS_AS(Profiler{ 0 }, Error);
+    REQUIRE_THROWS_AS(Profiler{ 0us }, Error);
+    REQUIRE_THROWS_AS(Profiler{ -1us }, Error);
+}
+
+TEST_CASE("Profiler: Instruction-based sampling of a step", "[Profiler]")
+{
+    auto profiler = std::make_shared<Profiler>(10);
+
+    Context context;
+    context.profiler = profiler;
+
+    Step step;
+    step.set_script(R"(
+        local function burn(n)
+            local sum = 0
+            for i = 1, n do
+                sum = sum + i
+            end
+            return sum
+        end
+        burn(10000)
+        )");
+
+    step.execute(context, nullptr, 3);
+
+    REQUIRE(profiler->get_sample_count() > 100);
+
+    const auto stacks = profiler->get_folded_stacks();
+    REQUIRE_THAT(stacks, StartsWith("step 3;main:"));
+    REQUIRE_THAT(stacks, Contains("main:9;burn:5 "));
+
+    // The sum of all counts must match the total sample count
+    std::uint64_t sum = 0;
+    for (const auto& line : gul14::split(stacks, "\n"))
+    {
+        if (line.empty())
+            continue;
+        sum += std::stoull(line.substr(line.rfind(' ') + 1));
+    }
+    REQUIRE(sum == profiler->get_sample_count());
+
+    profiler->clear();
+    REQUIRE(profiler->get_sample_count() == 0);
+    REQUIRE(profiler->get_folded_stacks() == "");
+}
+
+TEST_CASE("Profiler: Time-based sampling of a sequence", "[Profiler]")
+{
+    auto profiler = std::make_shared<Profiler>(1ms);
+
+    Context context;
+    context.profiler = profiler;
+
+    Step step;
+    step.set_script("local x = 0; for i = 1, 2000000 do x = x + i end");
+
+    Sequence seq;
+    seq.push_back(Step{});
+    seq.push_back(step);
+
+    REQUIRE(seq.execute(context, nullptr) == gul14::nullopt);
+
+    REQUIRE(profiler->get_sample_count() > 0);
+    REQUIRE_THAT(profiler->get_folded_stacks(), StartsWith("step 1;main:1 "));
+}
+
+TEST_CASE("Profiler: No sampling without profiler", "[Profiler]")
+{
+    Context context;
+    REQUIRE(context.profiler == nullptr);
+
+    Step step;
+    step.set_script("local x = 0; for i = 1, 1000 do x = x + i end");
+    REQUIRE_NOTHROW(step.execute(context));
+}
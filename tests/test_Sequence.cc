@@ -274,6 +274,34 @@ TEST_CASE("Sequence: insert()", "[Sequence]")
         for(auto step : seq)
             REQUIRE(step.get_type() == expected[idx++]);
     }
+
+    SECTION("insert range (iterator)")
+    {
+        const std::vector<Step> steps{
+            Step{Step::type_while}, Step{Step::type_action}, Step{Step::type_end} };
+        auto iter = seq.insert(seq.begin()+1, steps.begin(), steps.end());
+
+        REQUIRE(5 == seq.size());
+        REQUIRE(iter == seq.begin()+1);
+
+        Step::Type expected[] = {Step::type_action, Step::type_while, Step::type_action,
+            Step::type_end, Step::type_action};
+        short expected_level[] = {0, 0, 1, 0, 0};
+        int idx = 0;
+        for(auto step : seq)
+        {
+            REQUIRE(step.get_type() == expected[idx]);
+            REQUIRE(step.get_indentation_level() == expected_level[idx++]);
+        }
+    }
+
+    SECTION("insert empty range (iterator)")
+    {
+        const std::vector<Step> steps;
+        auto iter = seq.insert(seq.end(), steps.begin(), steps.end());
+        REQUIRE(2 == seq.size());
+        REQUIRE(iter == seq.end());
+    }
 }
 
 TEST_CASE("Sequence: is_running()", "[Sequence]")
@@ -2945,8 +2973,8 @@ TEST_CASE("execute_sequence(): Messages", "[execute_sequence]")
 
     REQUIRE(sequence.execute(context, &comm) == gul14::nullopt);
 
-    // 2 sequence messages plus 4 step start/stop messages
-    REQUIRE(queue.size() == 6);
+    // 2 sequence messages plus 4 step start/stop messages plus 2 variable changes
+    REQUIRE(queue.size() == 8);
 
     // First, a "sequence started" message
     auto msg = queue.pop();
@@ -2960,6 +2988,10 @@ TEST_CASE("execute_sequence(): Messages", "[execute_sequence]")
     REQUIRE(msg.get_timestamp() >= t0);
     REQUIRE(msg.get_timestamp() - t0 < 1s);
 
+    // VariablesChangedMessage
+    msg = queue.pop();
+    REQUIRE(msg.get_type() == Message::Type::context_variables_changed);
+
     // StepStoppedMessage
     msg = queue.pop();
     REQUIRE(msg.get_type() == Message::Type::step_stopped);
@@ -2972,6 +3004,10 @@ TEST_CASE("execute_sequence(): Messages", "[execute_sequence]")
     REQUIRE(msg.get_timestamp() >= t0);
     REQUIRE(msg.get_timestamp() - t0 < 1s);
 
+    // VariablesChangedMessage
+    msg = queue.pop();
+    REQUIRE(msg.get_type() == Message::Type::context_variables_changed);
+
     // StepStoppedMessage
     msg = queue.pop();
     REQUIRE(msg.get_type() == Message::Type::step_stopped);
@@ -3008,6 +3044,8 @@ TEST_CASE("execute_sequence(): Message callbacks", "[execute_sequence]")
                 str += "[STEP_STOP]"; break;
             case Message::Type::step_stopped_with_error:
                 str += "[STEP_STOP_ERR]"; break;
+            case Message::Type::context_variables_changed:
+                str += "[VARS]"; break;
             case Message::Type::undefined:
                 throw Error("Undefined message type");
             }
@@ -3749,7 +3787,7 @@ TEST_CASE("Sequence: terminate sequence with Lua exit function", "[Sequence]")
 
     REQUIRE(std::get<VarInteger>(ctx.variables["a"]) == 4);
     REQUIRE(not queue.empty());
-    REQUIRE(queue.size() == 26);
+    REQUIRE(queue.size() == 30); // including 4 variable changes from "increment a"
     auto msg = queue.back();
     REQUIRE(msg.get_type() == Message::Type::sequence_stopped);
     REQUIRE(msg.get_text() == "Script called terminate_sequence()");
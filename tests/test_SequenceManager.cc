@@ -4,7 +4,7 @@
  * \date   Created on July 22, 2022
  * \brief  Test suite for the SequenceManager class.
  *
- * \copyright Copyright 2022-2023 Deutsches Elektronen-Synchrotron (DESY), Hamburg
+ * \copyright Copyright 2022-2026 Deutsches Elektronen-Synchrotron (DESY), Hamburg
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU Lesser General Public License as published
@@ -23,57 +23,38 @@
 // SPDX-License-Identifier: LGPL-2.1-or-later
 
 #include <algorithm>
-#include <filesystem>
-#include <fstream>
+#include <memory>
 #include <string>
-#include <utility>
-#include <vector>
 
+#include <gul14/cat.h>
 #include <gul14/catch.h>
 
-#include "internals.h"
-#include "serialize_sequence.h"
+#include "taskolib/MemorySequenceStorage.h"
 #include "taskolib/SequenceManager.h"
 
-using namespace Catch::Matchers;
 using namespace std::literals;
 using namespace task;
 using namespace task::literals;
 
-namespace {
+// The tests run on a MemorySequenceStorage, so they do not touch the filesystem. The
+// behavior that is specific to the folder backend is tested in
+// test_FolderSequenceStorage.cc.
 
-static const std::filesystem::path temp_dir{ "unit_test_files" };
-
-// Helper that returns all entries of a directory (i.e. files or subdirs)
-std::vector<std::string> collect_filenames(const std::filesystem::path& path)
+TEST_CASE("SequenceManager: Constructor with path", "[SequenceManager]")
 {
-    std::vector<std::string> result;
-    for (const auto& entry: std::filesystem::directory_iterator{ path })
-        result.push_back(entry.path().filename().string());
-
-    std::sort(result.begin(), result.end());
-    return result;
+    SequenceManager sm{"./another/path/to/sequences"};
+    REQUIRE(sm.get_path() == "./another/path/to/sequences");
+    REQUIRE(dynamic_cast<FolderSequenceStorage*>(sm.get_storage().get()) != nullptr);
 }
 
-// Helper that returns all ".lua" entries of a directory (i.e. files or subdirs)
-std::vector<std::string> collect_lua_filenames(const std::filesystem::path& path)
+TEST_CASE("SequenceManager: Constructor with storage", "[SequenceManager]")
 {
-    std::vector<std::string> result;
-    for (const auto& entry: std::filesystem::directory_iterator{ path })
-        if (entry.path().extension() == ".lua")
-            result.push_back(entry.path().filename().string());
-
-    std::sort(result.begin(), result.end());
-    return result;
-}
-
-} // anonymous namespace
-
+    const auto storage = std::make_shared<MemorySequenceStorage>();
+    SequenceManager sm{ storage };
+    REQUIRE(sm.get_storage() == storage);
+    REQUIRE(sm.get_path().empty());
 
-TEST_CASE("SequenceManager: Constructor with path", "[SequenceManager]")
-{
-    SequenceManager sm{"./another/path/to/sequences"};
-    REQUIRE(sm.get_path() == "./another/path/to/sequences");
+    REQUIRE_THROWS_AS(SequenceManager{ std::shared_ptr<SequenceStorage>{} }, Error);
 }
 
 TEST_CASE("SequenceManager: Move constructor", "[SequenceManager]")
@@ -82,15 +63,20 @@ TEST_CASE("SequenceManager: Move constructor", "[SequenceManager]")
     REQUIRE(s.get_path() == "unit_test_files");
 }
 
-TEST_CASE("SequenceManager: copy_sequence()", "[SequenceManager]")
+TEST_CASE("SequenceManager: Copies share the storage", "[SequenceManager]")
 {
-    const char* dir = "unit_test_files/copy_sequence_test";
+    const SequenceManager manager{ std::make_shared<MemorySequenceStorage>() };
+    const SequenceManager copy{ manager };
+    REQUIRE(copy.get_storage() == manager.get_storage());
 
-    if (std::filesystem::exists(dir))
-        std::filesystem::remove_all(dir);
+    const Sequence seq = manager.create_sequence("Test");
+    REQUIRE(copy.list_sequences().size() == 1);
+    REQUIRE(copy.load_sequence(seq.get_unique_id()).get_label() == "Test");
+}
 
-    std::filesystem::create_directories(dir);
-    SequenceManager manager{ dir };
+TEST_CASE("SequenceManager: copy_sequence()", "[SequenceManager]")
+{
+    SequenceManager manager{ std::make_shared<MemorySequenceStorage>() };
 
     // Create a sequence and store it
     Sequence seq{ "First sequence", SequenceName{ "first" } };
@@ -110,7 +96,7 @@ TEST_CASE("SequenceManager: copy_sequence()", "[SequenceManager]")
     REQUIRE(copy[0].get_type() == seq[0].get_type());
     REQUIRE(copy[0].get_script() == seq[0].get_script());
 
-    // Examine base folder
+    // Examine the storage
     auto list = manager.list_sequences();
     REQUIRE(list.size() == 2);
     REQUIRE(std::find_if(list.begin(), list.end(),
@@ -127,10 +113,7 @@ TEST_CASE("SequenceManager: copy_sequence()", "[SequenceManager]")
 
 TEST_CASE("SequenceManager: create_sequence()", "[SequenceManager]")
 {
-    const char* dir = "unit_test_files/create_sequence_test";
-
-    std::filesystem::create_directories(dir);
-    SequenceManager manager{ dir };
+    SequenceManager manager{ std::make_shared<MemorySequenceStorage>() };
 
     // Create sequence with empty label and random UID
     Sequence seq = manager.create_sequence();
@@ -160,111 +143,71 @@ TEST_CASE("SequenceManager: create_sequence()", "[SequenceManager]")
     REQUIRE(seq.get_unique_id() != seq2.get_unique_id());
 
     REQUIRE(manager.list_sequences().size() == 4);
+    REQUIRE(manager.load_sequence(seq2.get_unique_id()).get_label()
+        == "We want the airwaves");
 }
 
-TEST_CASE("SequenceManager: list_sequences()", "[SequenceManager]")
+TEST_CASE("SequenceManager: load_sequence() - Nonexistent unique ID", "[SequenceManager]")
 {
-    // prepare first sequence for test
-    Step step_1_01{Step::type_while};
-    step_1_01.set_label("while");
-    step_1_01.set_script("return i < 10");
-
-    Step step_1_02{Step::type_action};
-    step_1_02.set_label("action");
-    step_1_02.set_script("i = i + 1");
-
-    Sequence seq_1{ "Test sequence 1", SequenceName{ "test.seq.1" } };
-    seq_1.push_back(step_1_01);
-    seq_1.push_back(step_1_02);
-
-    // prepare second sequence for test
-    Step step_2_01{Step::type_while};
-    step_2_01.set_label("while");
-    step_2_01.set_script("return i < 10");
-
-    Step step_2_02{Step::type_action};
-    step_2_02.set_label("action");
-    step_2_02.set_script("i = i + 1");
-
-    Sequence seq_2{ "Test sequence 2", SequenceName{ "test.seq.2" } };
-    seq_2.push_back(step_1_01);
-    seq_2.push_back(step_1_02);
+    SequenceManager manager{ std::make_shared<MemorySequenceStorage>() };
 
+    REQUIRE_THROWS_AS(manager.load_sequence(UniqueId{}), Error);
+}
 
-    const std::string root = "unit_test_files/sequences";
-    SequenceManager manager{ root };
-
-    if (std::filesystem::exists(root))
-        std::filesystem::remove_all(root);
-
-    manager.store_sequence(seq_1);
-    manager.store_sequence(seq_2);
-
-    // create a regular file to test sequence directory loading only
-    std::fstream f(root + "/some_weirdo_file[1234567890abcdef]", std::ios::out);
-    f.close();
-
-    // create a ".git" repository to test that it is not listed as a sequence
-    std::filesystem::create_directory(root + "/.git");
-
-    // create an empty directory with a non-sequence name (should be ignored)
-    std::filesystem::create_directory(root + "/some_weirdo_folder[x1234567890abcdef]");
-
-    // create a sequence directory without a unique ID, but with a sequence.lua file
-    std::filesystem::create_directory(root + "/A legacy sequence");
-    std::fstream f2(root + "/A legacy sequence/sequence.lua", std::ios::out);
-    f2.close();
-
-
-    SequenceManager sm{ root };
-    auto sequences = sm.list_sequences();
-    std::sort(sequences.begin(), sequences.end(),
-        [](const SequenceManager::SequenceOnDisk& a, const SequenceManager::SequenceOnDisk& b)
-        {
-            return a.path < b.path;
-        });
-
-    REQUIRE(sequences.size() == 3);
-
-    REQUIRE_THAT(sequences[0].path, StartsWith("A_legacy_sequence["));
-    REQUIRE_THAT(sequences[0].path, EndsWith("]"));
-    REQUIRE(sequences[0].name == SequenceName{ "A_legacy_sequence" });
-    REQUIRE(sequences[0].unique_id != 0_uid);
+TEST_CASE("SequenceManager: load_sequence() - With a list of sequences",
+    "[SequenceManager]")
+{
+    SequenceManager manager{ std::make_shared<MemorySequenceStorage>() };
 
-    REQUIRE_THAT(sequences[1].path, StartsWith("test.seq.1["));
-    REQUIRE_THAT(sequences[1].path, EndsWith("]"));
-    REQUIRE(sequences[1].name == SequenceName{ "test.seq.1" });
-    REQUIRE(sequences[1].unique_id != 0_uid);
+    const Sequence seq1 = manager.create_sequence("One", SequenceName{ "one" });
+    const auto sequences = manager.list_sequences();
+    const Sequence seq2 = manager.create_sequence("Two", SequenceName{ "two" });
 
-    REQUIRE_THAT(sequences[2].path, StartsWith("test.seq.2["));
-    REQUIRE_THAT(sequences[2].path, EndsWith("]"));
-    REQUIRE(sequences[2].name == SequenceName{ "test.seq.2" });
-    REQUIRE(sequences[2].unique_id != 0_uid);
+    REQUIRE(manager.load_sequence(seq1.get_unique_id(), sequences).get_label() == "One");
+    REQUIRE_THROWS_AS(manager.load_sequence(seq2.get_unique_id(), sequences), Error);
 }
 
-TEST_CASE("SequenceManager: load_sequence() - Nonexistent unique ID", "[SequenceManager]")
+TEST_CASE("SequenceManager: load_sequence_header() & load_sequence_headers()",
+    "[SequenceManager]")
 {
-    const char* dir = "unit_test_files/empty_sequence_folder";
+    SequenceManager manager{ std::make_shared<MemorySequenceStorage>() };
 
-    if (std::filesystem::exists(dir))
-        std::filesystem::remove_all(dir);
+    Sequence seq = manager.create_sequence("Header test", SequenceName{ "header" });
+    seq.set_maintainers("Jane Doe");
+    seq.push_back(Step{ Step::type_action });
+    seq.push_back(Step{ Step::type_action });
+    manager.store_sequence(seq);
+    manager.create_sequence("Other");
+
+    const auto header = manager.load_sequence_header(seq.get_unique_id());
+    REQUIRE(header.name == SequenceName{ "header" });
+    REQUIRE(header.unique_id == seq.get_unique_id());
+    REQUIRE(header.label == "Header test");
+    REQUIRE(header.maintainers == "Jane Doe");
+    REQUIRE(header.num_steps == 2);
+
+    const auto headers = manager.load_sequence_headers();
+    REQUIRE(headers.size() == 2);
+    REQUIRE(std::count_if(headers.begin(), headers.end(),
+        [](const auto& h) { return h.label == "Other" and h.num_steps == 0; }) == 1);
+}
 
-    std::filesystem::create_directories(dir);
+TEST_CASE("SequenceManager: load_sequence_snapshot()", "[SequenceManager]")
+{
+    SequenceManager manager{ std::make_shared<MemorySequenceStorage>() };
 
-    SequenceManager manager{ dir };
+    const Sequence seq = manager.create_sequence("Snapshot", SequenceName{ "snap" });
 
-    REQUIRE_THROWS_AS(manager.load_sequence(UniqueId{}), Error);
+    const auto snapshot = manager.load_sequence_snapshot(seq.get_unique_id());
+    REQUIRE(snapshot != nullptr);
+    REQUIRE(snapshot->get_label() == "Snapshot");
+    REQUIRE(snapshot->get_unique_id() == seq.get_unique_id());
+    REQUIRE_THROWS_AS(manager.load_sequence_snapshot(UniqueId{}), Error);
 }
 
 TEST_CASE("SequenceManager: remove_sequence()", "[SequenceManager]")
 {
-    const char* dir = "unit_test_files/remove_sequence_test";
-
-    if (std::filesystem::exists(dir))
-        std::filesystem::remove_all(dir);
-
-    std::filesystem::create_directories(dir);
-    SequenceManager manager{ dir };
+    SequenceManager manager{ std::make_shared<MemorySequenceStorage>() };
 
     Sequence seq1 = manager.create_sequence("First sequence", SequenceName{ "first" });
     seq1.push_back(Step{ Step::type_action });
@@ -281,10 +224,7 @@ TEST_CASE("SequenceManager: remove_sequence()", "[SequenceManager]")
 
 TEST_CASE("SequenceManager: rename_sequence()", "[SequenceManager]")
 {
-    const char* dir = "unit_test_files/relabel_sequence_test";
-
-    std::filesystem::create_directories(dir);
-    SequenceManager manager{ dir };
+    SequenceManager manager{ std::make_shared<MemorySequenceStorage>() };
 
     Sequence seq1 = manager.create_sequence("First sequence", SequenceName{ "first" });
     Sequence seq2 = manager.create_sequence("Second sequence", SequenceName{ "second" });
@@ -299,7 +239,8 @@ TEST_CASE("SequenceManager: rename_sequence()", "[SequenceManager]")
 
     auto sequences = manager.list_sequences();
     std::sort(sequences.begin(), sequences.end(),
-        [](const SequenceManager::SequenceOnDisk& a, const SequenceManager::SequenceOnDisk& b)
+        [](const SequenceManager::SequenceOnDisk& a,
+           const SequenceManager::SequenceOnDisk& b)
         {
             return a.path < b.path;
         });
@@ -311,52 +252,6 @@ TEST_CASE("SequenceManager: rename_sequence()", "[SequenceManager]")
     REQUIRE(sequences[1].unique_id == seq2.get_unique_id());
 }
 
-TEST_CASE("SequenceManager: store_sequence() - Filename format", "[SequenceManager]")
-{
-    SequenceManager manager{ temp_dir };
-
-    const SequenceName seq_name{ "Test_sequence" };
-    const UniqueId seq_uid{ 0xfeeddeafdeadbeef };
-    const auto seq_folder = make_sequence_filename(seq_name, seq_uid);
-
-    if (std::filesystem::exists(temp_dir / seq_folder))
-        std::filesystem::remove_all(temp_dir / seq_folder);
-
-    Sequence sequence{ "", seq_name, seq_uid };
-    sequence.push_back(Step{ Step::type_action });
-    sequence.push_back(Step{ Step::type_if });
-    sequence.push_back(Step{ Step::type_action });
-    sequence.push_back(Step{ Step::type_elseif });
-    sequence.push_back(Step{ Step::type_action });
-    sequence.push_back(Step{ Step::type_end });
-    sequence.push_back(Step{ Step::type_while });
-    sequence.push_back(Step{ Step::type_action });
-    sequence.push_back(Step{ Step::type_end });
-    sequence.push_back(Step{ Step::type_action });
-
-    REQUIRE_NOTHROW(manager.store_sequence(sequence));
-
-    std::vector<std::string> expect{
-        sequence_lua_filename,
-        "step_01_action.lua",
-        "step_02_if.lua",
-        "step_03_action.lua",
-        "step_04_elseif.lua",
-        "step_05_action.lua",
-        "step_06_end.lua",
-        "step_07_while.lua",
-        "step_08_action.lua",
-        "step_09_end.lua",
-        "step_10_action.lua"
-    };
-
-    std::vector<std::string> actual = collect_lua_filenames(temp_dir / seq_folder);
-    std::sort(actual.begin(), actual.end());
-
-    REQUIRE(expect.size() == actual.size());
-    REQUIRE(expect == actual);
-}
-
 TEST_CASE("SequenceManager: store_sequence() & load_sequence() - Steps",
     "[SequenceManager]")
 {
@@ -384,7 +279,7 @@ TEST_CASE("SequenceManager: store_sequence() & load_sequence() - Steps",
         return r;
     };
 
-    SequenceManager sm{ "unit_test_files" };
+    SequenceManager sm{ std::make_shared<MemorySequenceStorage>() };
     sm.store_sequence(seq);
 
     Sequence load = sm.load_sequence(seq.get_unique_id());
@@ -395,46 +290,10 @@ TEST_CASE("SequenceManager: store_sequence() & load_sequence() - Steps",
     REQUIRE(result);
 }
 
-TEST_CASE("SequenceManager: store_sequence() & load_sequence() - Label, name, UID",
-    "[SequenceManager]")
-{
-    SequenceManager manager{ temp_dir };
-
-    const auto label = "A/\"sequence\"$[<again>]"s;
-    const SequenceName name{ "gabba-gabba_he.Y" };
-
-    Sequence sequence{ label, name };
-    sequence.push_back(Step{});
-
-    const auto seq_folder = make_sequence_filename(sequence);
-
-    if (std::filesystem::exists(temp_dir / seq_folder))
-        std::filesystem::remove_all(temp_dir / seq_folder);
-
-    auto before = collect_filenames(temp_dir);
-
-    REQUIRE_NOTHROW(manager.store_sequence(sequence));
-
-    auto after = collect_filenames(temp_dir);
-
-    std::vector<std::string> new_filenames;
-    std::set_difference(after.begin(), after.end(),
-                        before.begin(), before.end(),
-                        std::back_inserter(new_filenames));
-
-    REQUIRE(new_filenames.size() == 1);
-    REQUIRE(new_filenames[0] == seq_folder);
-
-    Sequence deserialize_seq = manager.load_sequence(sequence.get_unique_id());
-    REQUIRE(sequence.get_label() == deserialize_seq.get_label());
-    REQUIRE(sequence.get_name() == deserialize_seq.get_name());
-    REQUIRE(sequence.get_unique_id() == deserialize_seq.get_unique_id());
-}
-
 TEST_CASE("SequenceManager: store_sequence() & load_sequence() - Step setup",
     "[SequenceManager]")
 {
-    SequenceManager manager{ temp_dir };
+    SequenceManager manager{ std::make_shared<MemorySequenceStorage>() };
 
     const auto step_setup_script =
         R"(
@@ -455,10 +314,10 @@ TEST_CASE("SequenceManager: store_sequence() & load_sequence() - Step setup",
     REQUIRE(seq_deserialized.get_step_setup_script() == step_setup_script);
 }
 
-TEST_CASE("SequenceManager: store_sequence() & load_sequence() - Indentation level & type",
+TEST_CASE("SequenceManager: store_sequence() & load_sequence() - Indentation & type",
     "[SequenceManager]")
 {
-    SequenceManager manager{ temp_dir };
+    SequenceManager manager{ std::make_shared<MemorySequenceStorage>() };
 
     Sequence sequence{ "this_is_a_sequence" };
     sequence.push_back(Step{ Step::type_while });
@@ -482,14 +341,10 @@ TEST_CASE("SequenceManager: store_sequence() & load_sequence() - Indentation lev
 TEST_CASE("SequenceManager: store_sequence() & load_sequence() - Maintainers, timeout",
     "[SequenceManager]")
 {
-    SequenceManager manager{ temp_dir };
+    SequenceManager manager{ std::make_shared<MemorySequenceStorage>() };
 
     Sequence seq{ "Test sequence with maintainers" };
 
-    // remove previously stored sequence
-    if (std::filesystem::exists(temp_dir / make_sequence_filename(seq)))
-        std::filesystem::remove_all(temp_dir / make_sequence_filename(seq));
-
     seq.set_maintainers("John Doe john.doe@universe.org; Bob Smith boby@milkyway.edu");
     seq.set_timeout(task::Timeout{1min});
 
@@ -506,26 +361,13 @@ TEST_CASE("SequenceManager: store_sequence() & load_sequence() - Maintainers, ti
 TEST_CASE("SequenceManager: store_sequence() & load_sequence() - Empty sequence",
     "[SequenceManager]")
 {
-    SequenceManager manager{ temp_dir };
+    SequenceManager manager{ std::make_shared<MemorySequenceStorage>() };
 
     std::string uid{ "empty_seq_with_step_setup" };
     Sequence seq{ uid };
 
-    SECTION("Deserialize empty sequence (part 1)")
-    {
-        manager.store_sequence(seq);
-        REQUIRE_NOTHROW(manager.load_sequence(seq.get_unique_id()));
-    }
-
-    SECTION("Deserialize empty sequence (part 2)")
-    {
-        // Remove previously stored sequence
-        if (std::filesystem::exists(temp_dir / make_sequence_filename(seq)))
-            std::filesystem::remove_all(temp_dir / make_sequence_filename(seq));
-
-        manager.store_sequence(seq);
+    manager.store_sequence(seq);
 
-        Sequence seq_deserialized = manager.load_sequence(seq.get_unique_id());
-        REQUIRE(seq_deserialized.empty());
-    }
+    Sequence seq_deserialized = manager.load_sequence(seq.get_unique_id());
+    REQUIRE(seq_deserialized.empty());
 }
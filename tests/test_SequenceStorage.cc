@@ -0,0 +1,288 @@
+/**
+ * \file   test_SequenceStorage.cc
+ * \author Lars Fröhlich
+ * \date   Created on October 18, 2026
+ * \brief  Conformance tests for all implementations of the SequenceStorage interface.
+ *
+ * \copyright Copyright 2026 Deutsches Elektronen-Synchrotron (DESY), Hamburg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+
+#include <gul14/catch.h>
+
+#include "taskolib/FolderSequenceStorage.h"
+#include "taskolib/MemorySequenceStorage.h"
+
+using namespace std::literals;
+using namespace task;
+
+namespace {
+
+enum class Backend { folder, memory };
+
+// Create an empty storage of the given type.
+std::unique_ptr<SequenceStorage> make_storage(Backend backend)
+{
+    if (backend == Backend::memory)
+        return std::make_unique<MemorySequenceStorage>();
+
+    const std::filesystem::path dir{ "unit_test_files/storage_conformance" };
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    return std::make_unique<FolderSequenceStorage>(dir);
+}
+
+Sequence make_sequence(const std::string& label, const char* name)
+{
+    Sequence seq{ label, SequenceName{ name } };
+    seq.set_maintainers("Jane Doe");
+    seq.set_timeout(Timeout{ 1min });
+    seq.set_step_setup_script("function f(x) return 2 * x end");
+
+    Step step1{ Step::type_while };
+    step1.set_label("Loop");
+    step1.set_script("return a < 10");
+    step1.set_used_context_variable_names(VariableNames{ "a" });
+
+    Step step2{ Step::type_action };
+    step2.set_label("Double");
+    step2.set_script("a = f(a)");
+    step2.set_timeout(Timeout{ 5s });
+    step2.set_disabled(true);
+
+    seq.push_back(step1);
+    seq.push_back(step2);
+    seq.push_back(Step{ Step::type_end });
+    return seq;
+}
+
+bool contains_uid(const std::vector<SequenceStorage::SequenceOnDisk>& list, UniqueId uid)
+{
+    return std::any_of(list.begin(), list.end(),
+        [uid](const auto& s) { return s.unique_id == uid; });
+}
+
+} // anonymous namespace
+
+TEST_CASE("SequenceStorage: Empty storage", "[SequenceStorage]")
+{
+    const auto backend = GENERATE(Backend::folder, Backend::memory);
+    INFO((backend == Backend::folder ? "FolderSequenceStorage" : "MemorySequenceStorage"));
+
+    const auto storage = make_storage(backend);
+    const UniqueId uid;
+
+    REQUIRE(storage->list_sequences().empty());
+    REQUIRE_THROWS_AS(storage->load_sequence(uid), Error);
+    REQUIRE_THROWS_AS(storage->remove_sequence(uid), Error);
+    REQUIRE_THROWS_AS(storage->rename_sequence(uid, SequenceName{ "x" }), Error);
+}
+
+TEST_CASE("SequenceStorage: Store and load", "[SequenceStorage]")
+{
+    const auto backend = GENERATE(Backend::folder, Backend::memory);
+    INFO((backend == Backend::folder ? "FolderSequenceStorage" : "MemorySequenceStorage"));
+
+    const auto storage = make_storage(backend);
+    const Sequence seq = make_sequence("Test sequence", "test");
+    storage->store_sequence(seq);
+
+    const auto list = storage->list_sequences();
+    REQUIRE(list.size() == 1);
+    REQUIRE(list[0].name == SequenceName{ "test" });
+    REQUIRE(list[0].unique_id == seq.get_unique_id());
+
+    const Sequence loaded = storage->load_sequence(seq.get_unique_id());
+    REQUIRE(loaded.get_label() == "Test sequence");
+    REQUIRE(loaded.get_name() == SequenceName{ "test" });
+    REQUIRE(loaded.get_unique_id() == seq.get_unique_id());
+    REQUIRE(loaded.get_maintainers() == "Jane Doe");
+    REQUIRE(loaded.get_timeout() == Timeout{ 1min });
+    REQUIRE(loaded.get_step_setup_script() == seq.get_step_setup_script());
+    REQUIRE(loaded.size() == 3);
+
+    for (Sequence::SizeType i = 0; i != loaded.size(); ++i)
+    {
+        CAPTURE(i);
+        REQUIRE(loaded[i].get_type() == seq[i].get_type());
+        REQUIRE(loaded[i].get_label() == seq[i].get_label());
+        REQUIRE(loaded[i].get_script() == seq[i].get_script());
+        REQUIRE(loaded[i].get_used_context_variable_names()
+            == seq[i].get_used_context_variable_names());
+        REQUIRE(loaded[i].get_timeout() == seq[i].get_timeout());
+        REQUIRE(loaded[i].is_disabled() == seq[i].is_disabled());
+        REQUIRE(loaded[i].get_indentation_level() == seq[i].get_indentation_level());
+    }
+}
+
+TEST_CASE("SequenceStorage: Store replaces a sequence", "[SequenceStorage]")
+{
+    const auto backend = GENERATE(Backend::folder, Backend::memory);
+    INFO((backend == Backend::folder ? "FolderSequenceStorage" : "MemorySequenceStorage"));
+
+    const auto storage = make_storage(backend);
+    Sequence seq = make_sequence("Original", "seq");
+    storage->store_sequence(seq);
+
+    seq.set_label("Modified");
+    seq.pop_back();
+    seq.pop_back();
+    seq.pop_back();
+    storage->store_sequence(seq);
+
+    REQUIRE(storage->list_sequences().size() == 1);
+
+    const Sequence loaded = storage->load_sequence(seq.get_unique_id());
+    REQUIRE(loaded.get_label() == "Modified");
+    REQUIRE(loaded.empty());
+}
+
+TEST_CASE("SequenceStorage: Several sequences", "[SequenceStorage]")
+{
+    const auto backend = GENERATE(Backend::folder, Backend::memory);
+    INFO((backend == Backend::folder ? "FolderSequenceStorage" : "MemorySequenceStorage"));
+
+    const auto storage = make_storage(backend);
+    const Sequence seq1 = make_sequence("One", "one");
+    const Sequence seq2 = make_sequence("Two", "two");
+    const Sequence seq3 = make_sequence("Three", "three");
+    storage->store_sequence(seq1);
+    storage->store_sequence(seq2);
+    storage->store_sequence(seq3);
+
+    auto list = storage->list_sequences();
+    REQUIRE(list.size() == 3);
+    REQUIRE(contains_uid(list, seq1.get_unique_id()));
+    REQUIRE(contains_uid(list, seq2.get_unique_id()));
+    REQUIRE(contains_uid(list, seq3.get_unique_id()));
+
+    REQUIRE(storage->load_sequence(seq2.get_unique_id()).get_label() == "Two");
+
+    SECTION("Rename a sequence")
+    {
+        storage->rename_sequence(seq2.get_unique_id(), SequenceName{ "renamed" });
+
+        list = storage->list_sequences();
+        REQUIRE(list.size() == 3);
+        const auto it = std::find_if(list.begin(), list.end(),
+            [&](const auto& s) { return s.unique_id == seq2.get_unique_id(); });
+        REQUIRE(it != list.end());
+        REQUIRE(it->name == SequenceName{ "renamed" });
+
+        const Sequence loaded = storage->load_sequence(seq2.get_unique_id());
+        REQUIRE(loaded.get_name() == SequenceName{ "renamed" });
+        REQUIRE(loaded.get_label() == "Two");
+        REQUIRE(loaded.size() == 3);
+    }
+
+    SECTION("Remove a sequence")
+    {
+        storage->remove_sequence(seq1.get_unique_id());
+
+        list = storage->list_sequences();
+        REQUIRE(list.size() == 2);
+        REQUIRE(not contains_uid(list, seq1.get_unique_id()));
+        REQUIRE_THROWS_AS(storage->load_sequence(seq1.get_unique_id()), Error);
+        REQUIRE(storage->load_sequence(seq3.get_unique_id()).get_label() == "Three");
+    }
+}
+
+TEST_CASE("SequenceStorage: copy_sequence()", "[SequenceStorage]")
+{
+    const auto backend = GENERATE(Backend::folder, Backend::memory);
+    INFO((backend == Backend::folder ? "FolderSequenceStorage" : "MemorySequenceStorage"));
+
+    const auto storage = make_storage(backend);
+    const Sequence seq = make_sequence("Original", "original");
+    storage->store_sequence(seq);
+
+    const UniqueId copy_uid;
+    storage->copy_sequence(seq.get_unique_id(), SequenceName{ "copy" }, copy_uid);
+
+    const auto list = storage->list_sequences();
+    REQUIRE(list.size() == 2);
+    REQUIRE(contains_uid(list, seq.get_unique_id()));
+    REQUIRE(contains_uid(list, copy_uid));
+
+    const Sequence copy = storage->load_sequence(copy_uid);
+    REQUIRE(copy.get_name() == SequenceName{ "copy" });
+    REQUIRE(copy.get_unique_id() == copy_uid);
+    REQUIRE(copy.get_label() == "Original");
+    REQUIRE(copy.get_maintainers() == "Jane Doe");
+    REQUIRE(copy.size() == 3);
+    REQUIRE(copy[1].get_script() == seq[1].get_script());
+
+    // The original is unchanged
+    REQUIRE(storage->load_sequence(seq.get_unique_id()).get_name()
+        == SequenceName{ "original" });
+
+    REQUIRE_THROWS_AS(storage->copy_sequence(UniqueId{}, SequenceName{ "x" }, UniqueId{}),
+                      Error);
+    REQUIRE_THROWS_AS(storage->copy_sequence(seq.get_unique_id(), SequenceName{ "x" },
+                                             copy_uid), Error);
+    REQUIRE(storage->list_sequences().size() == 2);
+}
+
+TEST_CASE("SequenceStorage: load_sequence_header()", "[SequenceStorage]")
+{
+    const auto backend = GENERATE(Backend::folder, Backend::memory);
+    INFO((backend == Backend::folder ? "FolderSequenceStorage" : "MemorySequenceStorage"));
+
+    const auto storage = make_storage(backend);
+    const Sequence seq = make_sequence("Test sequence", "test");
+    storage->store_sequence(seq);
+
+    const auto header = storage->load_sequence_header(seq.get_unique_id());
+    REQUIRE(header.path == storage->list_sequences().at(0).path);
+    REQUIRE(header.name == SequenceName{ "test" });
+    REQUIRE(header.unique_id == seq.get_unique_id());
+    REQUIRE(header.label == "Test sequence");
+    REQUIRE(header.maintainers == "Jane Doe");
+    REQUIRE(header.timeout == Timeout{ 1min });
+    REQUIRE(header.num_steps == 3);
+
+    REQUIRE_THROWS_AS(storage->load_sequence_header(UniqueId{}), Error);
+}
+
+TEST_CASE("SequenceStorage: load_sequence_snapshot()", "[SequenceStorage]")
+{
+    const auto backend = GENERATE(Backend::folder, Backend::memory);
+    INFO((backend == Backend::folder ? "FolderSequenceStorage" : "MemorySequenceStorage"));
+
+    const auto storage = make_storage(backend);
+    Sequence seq = make_sequence("Test sequence", "test");
+    storage->store_sequence(seq);
+
+    const auto snapshot = storage->load_sequence_snapshot(seq.get_unique_id());
+    REQUIRE(snapshot != nullptr);
+    REQUIRE(snapshot->get_label() == "Test sequence");
+    REQUIRE(snapshot->size() == 3);
+
+    // A snapshot is not affected by later modifications
+    seq.set_label("Modified");
+    storage->store_sequence(seq);
+    REQUIRE(snapshot->get_label() == "Test sequence");
+    REQUIRE(storage->load_sequence_snapshot(seq.get_unique_id())->get_label()
+        == "Modified");
+
+    REQUIRE_THROWS_AS(storage->load_sequence_snapshot(UniqueId{}), Error);
+}
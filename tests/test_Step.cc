@@ -23,6 +23,7 @@
 // SPDX-License-Identifier: LGPL-2.1-or-later
 
 #include <stdexcept>
+#include <thread>
 #include <type_traits>
 
 #include <gul14/catch.h>
@@ -507,6 +508,64 @@ TEST_CASE("execute(): Custom commands", "[Step]")
         step.execute(context);
         REQUIRE(gul14::toc(t0) >= 0.001);
     }
+
+    SECTION("wait_until() with a function")
+    {
+        step.set_used_context_variable_names(VariableNames{ "ok", "n" });
+        step.set_script(R"(
+            n = 0
+            ok = wait_until(function() n = n + 1; return n == 5 end, 10)
+            )");
+        step.execute(context);
+        REQUIRE(std::get<VarBool>(context.variables["ok"]) == true);
+        REQUIRE(std::get<VarInteger>(context.variables["n"]) == 5);
+    }
+
+    SECTION("wait_until() times out")
+    {
+        step.set_used_context_variable_names(VariableNames{ "ok" });
+        step.set_script("ok = wait_until(function() return false end, 0.02, 0.005)");
+
+        auto t0 = gul14::tic();
+        step.execute(context);
+        REQUIRE(gul14::toc(t0) >= 0.02);
+        REQUIRE(std::get<VarBool>(context.variables["ok"]) == false);
+    }
+
+    SECTION("wait_until() wakes up on a blackboard change")
+    {
+        context.blackboard = std::make_shared<Blackboard>();
+        step.set_used_context_variable_names(VariableNames{ "ok" });
+        step.set_script("ok = wait_until('ready', 10, 5)");
+
+        std::thread writer([bb = context.blackboard]()
+            {
+                std::this_thread::sleep_for(50ms);
+                bb->set("other", VarInteger{ 1 });
+                bb->set("ready", VarBool{ false });
+                std::this_thread::sleep_for(50ms);
+                bb->set("ready", VarBool{ true });
+            });
+
+        // With a maximum poll interval of 5 s, only the wake-up can end the wait quickly
+        auto t0 = gul14::tic();
+        step.execute(context);
+        writer.join();
+        REQUIRE(gul14::toc(t0) < 2.0);
+        REQUIRE(std::get<VarBool>(context.variables["ok"]) == true);
+    }
+
+    SECTION("wait_until() errors")
+    {
+        step.set_script("wait_until(function() error('in condition') end)");
+        REQUIRE_THROWS_WITH(step.execute(context), Contains("in condition"));
+
+        step.set_script("wait_until('ready')");
+        REQUIRE_THROWS_WITH(step.execute(context), Contains("blackboard"));
+
+        step.set_script("wait_until(42)");
+        REQUIRE_THROWS_WITH(step.execute(context), Contains("must be a function"));
+    }
 }
 
 TEST_CASE("execute(): Timeout", "[Step]")
@@ -524,6 +583,30 @@ TEST_CASE("execute(): Timeout", "[Step]")
         REQUIRE(gul14::toc<std::chrono::milliseconds>(t0) < 200); // leave some time for system hiccups
     }
 
+    SECTION("wait_until() is terminated")
+    {
+        auto t0 = gul14::tic();
+        step.set_script("wait_until(function() return false end)");
+        step.set_timeout(20ms);
+        REQUIRE_THROWS_AS(step.execute(context), Error);
+        REQUIRE(gul14::toc<std::chrono::milliseconds>(t0) >= 20);
+        REQUIRE(gul14::toc<std::chrono::milliseconds>(t0) < 200); // leave some time for system hiccups
+    }
+
+    SECTION("sleep() is terminated by the sequence timeout")
+    {
+        TimeoutTrigger sequence_timeout;
+        sequence_timeout.set_timeout(20ms);
+        sequence_timeout.reset();
+
+        auto t0 = gul14::tic();
+        step.set_script("sleep(10)");
+        REQUIRE_THROWS_WITH(step.execute(context, nullptr, gul14::nullopt, &sequence_timeout),
+                            Contains("Sequence took more than"));
+        REQUIRE(gul14::toc<std::chrono::milliseconds>(t0) >= 20);
+        REQUIRE(gul14::toc<std::chrono::milliseconds>(t0) < 200); // leave some time for system hiccups
+    }
+
     SECTION("sleep() is terminated")
     {
         auto t0 = gul14::tic();
@@ -556,6 +639,26 @@ TEST_CASE("execute(): Timeout", "[Step]")
     }
 }
 
+TEST_CASE("execute(): Immediate termination during sleep()", "[Step]")
+{
+    Context context;
+    Step step;
+    CommChannel comm;
+    step.set_script("sleep(10)");
+
+    std::thread requester([&comm]()
+        {
+            std::this_thread::sleep_for(20ms);
+            comm.request_immediate_termination();
+        });
+
+    auto t0 = gul14::tic();
+    REQUIRE_THROWS_WITH(step.execute(context, &comm, 0), Contains("Stop on user request"));
+    requester.join();
+    REQUIRE(gul14::toc<std::chrono::milliseconds>(t0) >= 20);
+    REQUIRE(gul14::toc<std::chrono::milliseconds>(t0) < 200); // leave some time for system hiccups
+}
+
 TEST_CASE("execute(): Immediate termination", "[Step]")
 {
     Context context;
@@ -866,7 +969,7 @@ TEST_CASE("execute(): Messages", "[Step]")
 
     step.execute(context, &comm, 42);
 
-    REQUIRE(comm.queue_.size() == 2);
+    REQUIRE(comm.queue_.size() == 3);
 
     // First, a "step started" message
     auto msg = comm.queue_.pop();
@@ -879,7 +982,15 @@ TEST_CASE("execute(): Messages", "[Step]")
 
     const auto t1 = msg.get_timestamp();
 
-    // Then, a "step stopped" message
+    // Then, a message about the modified variable "a"
+    msg = comm.queue_.pop();
+    REQUIRE(msg.get_type() == Message::Type::context_variables_changed);
+    REQUIRE(msg.get_variable_changes().size() == 1);
+    REQUIRE(msg.get_variable_changes()[0].first == "a");
+    REQUIRE(msg.get_index().has_value());
+    REQUIRE(*(msg.get_index()) == 42);
+
+    // Finally, a "step stopped" message
     msg = comm.queue_.pop();
     REQUIRE(msg.get_type() == Message::Type::step_stopped);
     REQUIRE(msg.get_text() != "");
@@ -889,6 +1000,321 @@ TEST_CASE("execute(): Messages", "[Step]")
     REQUIRE(*(msg.get_index()) == 42);
 }
 
+TEST_CASE("execute(): Lua VM statistics", "[Step]")
+{
+    CommChannel comm;
+    Context context;
+
+    Step step;
+    REQUIRE(step.get_statistics() == StepStatistics{});
+
+    step.set_script(R"(
+        local function inner(n)
+            local t = {}
+            for i = 1, n do t[i] = tostring(i) end
+            return #t
+        end
+        local function outer(n) local r = inner(n); return r end
+        for i = 1, 20 do outer(1000) end
+        )");
+
+    step.execute(context, &comm);
+
+    const StepStatistics stats = step.get_statistics();
+    REQUIRE(stats.num_instructions > 10000);
+    REQUIRE(stats.num_hook_calls > 100);
+    REQUIRE(stats.num_gc_cycles > 0);
+    REQUIRE(stats.bytes_allocated > 100000);
+    REQUIRE(stats.peak_stack_depth >= 3);
+
+    // The "step stopped" message carries the statistics of this execution
+    comm.queue_.pop();
+    auto msg = comm.queue_.pop();
+    REQUIRE(msg.get_type() == Message::Type::step_stopped);
+    REQUIRE(msg.get_statistics() == stats);
+
+    // Statistics accumulate over multiple executions, also in case of errors
+    step.set_script("local x = 0; for i = 1, 1000 do x = x + i end; error('Boom')");
+    REQUIRE_THROWS_AS(step.execute(context, &comm), Error);
+
+    comm.queue_.pop();
+    msg = comm.queue_.pop();
+    REQUIRE(msg.get_type() == Message::Type::step_stopped_with_error);
+    REQUIRE(msg.get_statistics().num_instructions > 0);
+    REQUIRE(msg.get_statistics().peak_stack_depth >= 1);
+
+    REQUIRE(step.get_statistics().num_instructions
+            == stats.num_instructions + msg.get_statistics().num_instructions);
+    REQUIRE(step.get_statistics().peak_stack_depth == stats.peak_stack_depth);
+
+    step.set_statistics(StepStatistics{});
+    REQUIRE(step.get_statistics() == StepStatistics{});
+}
+
+TEST_CASE("execute(): Changes of context variables", "[Step]")
+{
+    CommChannel comm;
+
+    Context context;
+    context.variables["a"] = VarInteger{ 1 };
+    context.variables["b"] = VarString{ "Bee" };
+    context.variables["c"] = VarFloat{ 3.0 };
+
+    Step step;
+    step.set_used_context_variable_names(VariableNames{ "a", "b", "c", "d" });
+
+    SECTION("No message if nothing has changed")
+    {
+        step.set_script("local x = a .. b");
+        step.execute(context, &comm);
+
+        REQUIRE(comm.queue_.size() == 2);
+        REQUIRE(comm.queue_.pop().get_type() == Message::Type::step_started);
+        REQUIRE(comm.queue_.pop().get_type() == Message::Type::step_stopped);
+        REQUIRE(step.get_statistics().num_exported_variables == 0);
+    }
+
+    SECTION("Type changes are exported")
+    {
+        step.set_script("a = 1.0; c = 3");
+        step.execute(context, &comm);
+
+        REQUIRE(step.get_statistics().num_exported_variables == 2);
+        REQUIRE(std::get<VarFloat>(context.variables["a"]) == 1.0);
+        REQUIRE(std::get<VarInteger>(context.variables["c"]) == 3);
+    }
+
+    SECTION("Modified strings are exported")
+    {
+        step.set_script("b = b .. 'p'");
+        step.execute(context, &comm);
+        REQUIRE(step.get_statistics().num_exported_variables == 1);
+        REQUIRE(std::get<VarString>(context.variables["b"]) == "Beep");
+
+        step.set_script("b = 'Bee' .. 'p'");
+        step.execute(context, &comm);
+        REQUIRE(step.get_statistics().num_exported_variables == 1);
+    }
+
+    SECTION("Only modified variables are reported")
+    {
+        step.set_script("a = 2; b = 'Bee'; c = nil; d = true");
+        step.execute(context, &comm, 3);
+
+        REQUIRE(comm.queue_.size() == 3);
+        REQUIRE(comm.queue_.pop().get_type() == Message::Type::step_started);
+
+        const auto msg = comm.queue_.pop();
+        REQUIRE(msg.get_type() == Message::Type::context_variables_changed);
+        REQUIRE(msg.get_index() == OptionalStepIndex{ 3 });
+
+        const VariableChanges& changes = msg.get_variable_changes();
+        REQUIRE(changes.size() == 3);
+        REQUIRE(changes[0].first == "a");
+        REQUIRE(changes[0].second == VariableValue{ VarInteger{ 2 } });
+        REQUIRE(changes[1].first == "c");
+        REQUIRE(changes[1].second.has_value() == false);
+        REQUIRE(changes[2].first == "d");
+        REQUIRE(changes[2].second == VariableValue{ VarBool{ true } });
+
+        const auto stop_msg = comm.queue_.pop();
+        REQUIRE(stop_msg.get_type() == Message::Type::step_stopped);
+        REQUIRE(stop_msg.get_statistics().num_exported_variables == 3);
+
+        REQUIRE(context.variables.size() == 3);
+        REQUIRE(std::get<VarInteger>(context.variables["a"]) == 2);
+        REQUIRE(std::get<VarString>(context.variables["b"]) == "Bee");
+        REQUIRE(std::get<VarBool>(context.variables["d"]) == true);
+    }
+}
+
+TEST_CASE("execute(): Numeric arrays", "[Step]")
+{
+    Context context;
+    const VarFloatArray waveform(100000, 0.5);
+    context.variables["wave"] = waveform;
+    context.variables["ints"] = VarIntArray{ 3, 1, 4, 1, 5 };
+
+    Step step;
+    step.set_used_context_variable_names(
+        VariableNames{ "wave", "ints", "n", "total", "mx", "idx", "scaled", "created" });
+
+    SECTION("Arrays are imported without copying and read by kernels")
+    {
+        step.set_script(R"(
+            n = #wave
+            total = wave:sum()
+            mx = ints:max()
+            idx = ints:find(4)
+            )");
+        step.execute(context);
+
+        REQUIRE(std::get<VarInteger>(context.variables["n"]) == 100000);
+        REQUIRE(std::get<VarFloat>(context.variables["total"]) == 50000.0);
+        REQUIRE(std::get<VarInteger>(context.variables["mx"]) == 5);
+        REQUIRE(std::get<VarInteger>(context.variables["idx"]) == 3);
+
+        // The unmodified array still shares its storage with the original one
+        REQUIRE(std::get<VarFloatArray>(context.variables["wave"])
+            .shares_storage_with(waveform));
+        REQUIRE(step.get_statistics().num_exported_variables == 4);
+    }
+
+    SECTION("Modifying an array in Lua copies it")
+    {
+        step.set_script(R"(
+            wave[1] = 2.0
+            scaled = ints:scale(2, 1)
+            created = IntArray.from_table({ 7, 8, 9 })
+            )");
+        step.execute(context);
+
+        const auto& wave = std::get<VarFloatArray>(context.variables["wave"]);
+        REQUIRE_FALSE(wave.shares_storage_with(waveform));
+        REQUIRE(wave[0] == 2.0);
+        REQUIRE(waveform[0] == 0.5);
+
+        REQUIRE(std::get<VarFloatArray>(context.variables["scaled"])
+                == VarFloatArray{ 7.0, 3.0, 9.0, 3.0, 11.0 });
+        REQUIRE(std::get<VarIntArray>(context.variables["created"])
+                == VarIntArray{ 7, 8, 9 });
+    }
+
+    SECTION("Invalid element access")
+    {
+        step.set_script("local x = ints[6]");
+        REQUIRE_THROWS_WITH(step.execute(context), Contains("out of range"));
+
+        step.set_script("ints[0] = 1");
+        REQUIRE_THROWS_WITH(step.execute(context), Contains("out of range"));
+    }
+
+    SECTION("Other userdata cannot be exported")
+    {
+        struct Handle {};
+        context.step_setup_function = [](sol::state& lua) { lua["handle"] = Handle{}; };
+        context.variables["created"] = VarInteger{ 1 };
+
+        step.set_script("created = handle");
+        REQUIRE_THROWS_WITH(step.execute(context), Contains("unsupported type"));
+        REQUIRE(std::get<VarInteger>(context.variables["created"]) == 1);
+    }
+}
+
+TEST_CASE("execute(): Binary data", "[Step]")
+{
+    Context context;
+    std::string payload = "HDR";
+    payload += std::string("\x01\x00\xff\xff\x00\x00\x80\x3f", 8); // u16 1, i16 -1, f 1.0
+    payload += std::string(100000, 'x');
+    const VarBytes buffer{ payload };
+    context.variables["buffer"] = buffer;
+
+    Step step;
+    step.set_used_context_variable_names(
+        VariableNames{ "buffer", "header", "n", "a", "b", "c", "pos", "first", "created" });
+
+    SECTION("Data is imported and exported without copying")
+    {
+        step.set_script(R"(
+            n = #buffer
+            header = buffer:sub(1, 3)
+            a, b, c, pos = buffer:unpack('<Hhf', 4)
+            first = buffer[1]
+            created = Bytes.new('abc')
+            )");
+        step.execute(context);
+
+        REQUIRE(std::get<VarInteger>(context.variables["n"]) == 100011);
+        REQUIRE(std::get<VarInteger>(context.variables["a"]) == 1);
+        REQUIRE(std::get<VarInteger>(context.variables["b"]) == -1);
+        REQUIRE(std::get<VarFloat>(context.variables["c"]) == 1.0);
+        REQUIRE(std::get<VarInteger>(context.variables["pos"]) == 12);
+        REQUIRE(std::get<VarInteger>(context.variables["first"]) == 'H');
+
+        const auto& header = std::get<VarBytes>(context.variables["header"]);
+        REQUIRE(header.to_string() == "HDR");
+        REQUIRE(header.shares_storage_with(buffer));
+        REQUIRE(std::get<VarBytes>(context.variables["buffer"]).shares_storage_with(buffer));
+        REQUIRE(std::get<VarBytes>(context.variables["created"]).to_string() == "abc");
+
+        // The buffer itself was not modified, so it is not exported
+        REQUIRE(step.get_statistics().num_exported_variables == 8);
+    }
+
+    SECTION("Bytes are read-only")
+    {
+        step.set_script("buffer[1] = 0");
+        REQUIRE_THROWS_WITH(step.execute(context), Contains("read-only"));
+
+        step.set_script("local x = buffer[0]");
+        REQUIRE_THROWS_WITH(step.execute(context), Contains("out of range"));
+
+        step.set_script("local x = buffer:unpack('i4', -2)");
+        REQUIRE_THROWS_WITH(step.execute(context), Contains("too short"));
+    }
+}
+
+TEST_CASE("execute(): Lazy variable import", "[Step]")
+{
+    Context context;
+    context.variables["a"] = VarInteger{ 1 };
+    context.variables["b"] = VarString{ "unused" };
+    context.variables["c"] = VarFloat{ 2.5 };
+    context.variables["s"] = VarInteger{ 10 };
+    context.step_setup_script = "s = 0; g = 'setup'";
+
+    Step step;
+    step.set_used_context_variable_names(VariableNames{ "a", "b", "c", "d", "g", "s" });
+    step.set_script(R"(
+        a = a + 1
+        d = c * 2
+        s = s + 1
+        if g ~= 'setup' then error('setup global lost') end
+        g = 'modified'
+        )");
+
+    Context eager_context = context;
+    step.execute(eager_context);
+    const auto eager_statistics = step.get_statistics();
+
+    Step lazy_step = step;
+    lazy_step.set_statistics(StepStatistics{});
+    context.variable_import_mode = VariableImportMode::lazy;
+    lazy_step.execute(context);
+
+    // Both modes yield the same results
+    REQUIRE(context.variables == eager_context.variables);
+    REQUIRE(std::get<VarInteger>(context.variables["a"]) == 2);
+    REQUIRE(std::get<VarFloat>(context.variables["d"]) == 5.0);
+    REQUIRE(std::get<VarInteger>(context.variables["s"]) == 11);
+    REQUIRE(std::get<VarString>(context.variables["g"]) == "modified");
+    REQUIRE(std::get<VarString>(context.variables["b"]) == "unused");
+
+    // Only the variables that the script touched have been imported
+    REQUIRE(eager_statistics.num_imported_variables == 4);
+    REQUIRE(lazy_step.get_statistics().num_imported_variables == 3);
+    REQUIRE(lazy_step.get_statistics().num_exported_variables
+            == eager_statistics.num_exported_variables);
+
+    SECTION("Undefined variables read as nil and can be removed")
+    {
+        lazy_step.set_script("if d == nil then error('d should exist') end; d = nil; "
+                             "if x ~= nil then error('x should not exist') end");
+        lazy_step.execute(context);
+        REQUIRE(context.variables.count("d") == 0);
+        REQUIRE(context.variables.count("a") == 1);
+    }
+
+    SECTION("Variables can be written before they are read")
+    {
+        lazy_step.set_script("b = 'new'; a = b .. '!'");
+        lazy_step.execute(context);
+        REQUIRE(std::get<VarString>(context.variables["b"]) == "new");
+        REQUIRE(std::get<VarString>(context.variables["a"]) == "new!");
+    }
+}
+
 TEST_CASE("execute(): print function", "[Step]")
 {
     std::string output;
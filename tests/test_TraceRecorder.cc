@@ -0,0 +1,137 @@
+/**
+ * \file   test_TraceRecorder.cc
+ * \author Lars Fröhlich
+ * \date   Created on October 18, 2026
+ * \brief  Test suite for the TraceRecorder class.
+ *
+ * \copyright Copyright 2026 Deutsches Elektronen-Synchrotron (DESY), Hamburg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include <gul14/catch.h>
+#include <gul14/time_util.h>
+
+#include "taskolib/Executor.h"
+#include "taskolib/TraceRecorder.h"
+
+using namespace std::literals;
+using namespace task;
+using Catch::Matchers::Contains;
+using Catch::Matchers::StartsWith;
+
+namespace {
+
+std::size_t count_occurrences(const std::string& str, const std::string& pattern)
+{
+    std::size_t count = 0;
+    for (auto pos = str.find(pattern); pos != str.npos; pos = str.find(pattern, pos + 1))
+        ++count;
+    return count;
+}
+
+Step make_step(Step::Type type, const std::string& label, const std::string& script = "")
+{
+    Step step{ type };
+    step.set_label(label);
+    step.set_script(script);
+    step.set_used_context_variable_names(VariableNames{ "i" });
+    return step;
+}
+
+Sequence make_sequence()
+{
+    Sequence seq{ "Trace test" };
+    seq.push_back(make_step(Step::type_action, "Init", "i = 0"));
+    seq.push_back(make_step(Step::type_while, "i < 3", "return i < 3"));
+    seq.push_back(make_step(Step::type_action, "Increment", "i = i + 1; print(i)"));
+    seq.push_back(make_step(Step::type_end, ""));
+    seq.push_back(make_step(Step::type_try, ""));
+    seq.push_back(make_step(Step::type_action, "Fail", "error('boom')"));
+    seq.push_back(make_step(Step::type_catch, ""));
+    seq.push_back(make_step(Step::type_action, ""));
+    seq.push_back(make_step(Step::type_end, ""));
+    return seq;
+}
+
+} // anonymous namespace
+
+TEST_CASE("TraceRecorder: Empty recorder", "[TraceRecorder]")
+{
+    TraceRecorder recorder{ Sequence{} };
+    REQUIRE(recorder.get_num_events() == 0);
+    REQUIRE_THAT(recorder.get_json(), StartsWith("{\"traceEvents\":["));
+}
+
+TEST_CASE("TraceRecorder: Record a sequence run", "[TraceRecorder]")
+{
+    Sequence seq = make_sequence();
+    TraceRecorder recorder{ seq };
+
+    Context context;
+    context.message_callback_function =
+        [&recorder](const Message& msg) { recorder.record(msg); };
+
+    REQUIRE(seq.execute(context, nullptr) == gul14::nullopt);
+
+    const auto json = recorder.get_json();
+
+    // All duration events are closed
+    REQUIRE(count_occurrences(json, "\"ph\":\"B\"")
+            == count_occurrences(json, "\"ph\":\"E\""));
+
+    REQUIRE_THAT(json, Contains("{\"name\":\"Sequence\",\"cat\":\"sequence\",\"ph\":\"B\""));
+    REQUIRE(count_occurrences(json, "{\"name\":\"WHILE i < 3\",\"cat\":\"block\",\"ph\":\"B\"")
+            == 1);
+    REQUIRE_THAT(json, Contains("{\"name\":\"Iteration 3\",\"cat\":\"block\",\"ph\":\"B\""));
+    REQUIRE_THAT(json, not Contains("Iteration 4"));
+    REQUIRE(count_occurrences(json, "{\"name\":\"Increment\",\"cat\":\"action\",\"ph\":\"B\"")
+            == 3);
+    REQUIRE_THAT(json, Contains("{\"name\":\"TRY\",\"cat\":\"block\",\"ph\":\"B\""));
+    REQUIRE_THAT(json, Contains("{\"name\":\"CATCH\",\"cat\":\"block\",\"ph\":\"B\""));
+    REQUIRE_THAT(json, Contains("{\"name\":\"Step 7\",\"cat\":\"action\",\"ph\":\"B\""));
+
+    REQUIRE(count_occurrences(json, "{\"name\":\"print\",\"cat\":\"output\",\"ph\":\"i\"")
+            == 3);
+    REQUIRE_THAT(json, Contains("\"args\":{\"text\":\"3\\n\"}"));
+    REQUIRE(count_occurrences(json, "{\"name\":\"error\",\"cat\":\"error\",\"ph\":\"i\"")
+            == 1);
+    REQUIRE_THAT(json, Contains("boom"));
+
+    recorder.clear();
+    REQUIRE(recorder.get_num_events() == 0);
+}
+
+TEST_CASE("TraceRecorder: Record messages from an Executor", "[TraceRecorder]")
+{
+    Sequence seq = make_sequence();
+    TraceRecorder recorder{ seq };
+
+    Context context;
+    context.message_callback_function =
+        [&recorder](const Message& msg) { recorder.record(msg); };
+
+    Executor executor;
+    executor.run_asynchronously(seq, context);
+    while (executor.update(seq))
+        gul14::sleep(1ms);
+
+    const auto json = recorder.get_json();
+    REQUIRE(count_occurrences(json, "\"ph\":\"B\"")
+            == count_occurrences(json, "\"ph\":\"E\""));
+    REQUIRE_THAT(json, Contains("Iteration 3"));
+    REQUIRE_THAT(json, Contains("CATCH"));
+}
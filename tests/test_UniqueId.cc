@@ -22,6 +22,8 @@
 
 // SPDX-License-Identifier: LGPL-2.1-or-later
 
+#include <unordered_set>
+
 #include <gul14/catch.h>
 
 #include "taskolib/exceptions.h"
@@ -86,3 +88,13 @@ TEST_CASE("to_string(UniqueId)", "[UniqueId]")
     REQUIRE(to_string(0x123456789abcdef0_uid) == "123456789abcdef0");
     REQUIRE(to_string(0_uid) == "0000000000000000");
 }
+
+TEST_CASE("UniqueId: std::hash", "[UniqueId]")
+{
+    std::hash<UniqueId> hash;
+    REQUIRE(hash(UniqueId{ 42 }) == hash(UniqueId{ 42 }));
+    REQUIRE(hash(UniqueId{ 42 }) == std::hash<UniqueId::ValueType>{}(42));
+
+    std::unordered_set<UniqueId> set{ UniqueId{ 1 }, UniqueId{ 2 }, UniqueId{ 1 } };
+    REQUIRE(set.size() == 2);
+}
@@ -23,6 +23,8 @@
 // SPDX-License-Identifier: LGPL-2.1-or-later
 
 #include <array>
+#include <thread>
+#include <vector>
 #include <gul14/catch.h>
 #include <gul14/join_split.h>
 #include "taskolib/exceptions.h"
@@ -155,3 +157,76 @@ TEST_CASE("VariableName: Compatibility with gul14::join()", "[VariableName]")
 
     REQUIRE(gul14::join(vars, ", ") == "a, bb, ccc");
 }
+
+TEST_CASE("VariableName: Interning", "[VariableName]")
+{
+    const VariableName a{ "interned_name" };
+    const VariableName b{ "interned_"s + "name" };
+    const VariableName c{ "interned_name2" };
+
+    REQUIRE(a == b);
+    REQUIRE(a != c);
+    REQUIRE(a.get_symbol() == b.get_symbol());
+    REQUIRE(a.get_symbol() != c.get_symbol());
+    REQUIRE(a.get_hash() == std::hash<std::string>{}("interned_name"));
+    REQUIRE(std::hash<VariableName>{}(a) == a.get_hash());
+    REQUIRE(&a.string() == &b.string());
+
+    VariableName d{ "interned" };
+    d += "_name";
+    REQUIRE(d == a);
+    REQUIRE(d.get_symbol() == a.get_symbol());
+}
+
+TEST_CASE("VariableName: Lexicographic ordering", "[VariableName]")
+{
+    // Create the names in reverse order so that the symbols are in the opposite order
+    const VariableName z{ "zzz_order" };
+    const VariableName a{ "aaa_order" };
+
+    REQUIRE(a < z);
+    REQUIRE(a <= z);
+    REQUIRE(a <= a);
+    REQUIRE_FALSE(a < a);
+    REQUIRE(z > a);
+    REQUIRE(z >= a);
+    REQUIRE(z >= z);
+    REQUIRE_FALSE(z > z);
+}
+
+TEST_CASE("VariableName: Concurrent interning", "[VariableName]")
+{
+    std::vector<std::thread> threads;
+    std::vector<std::vector<VariableName>> results(4);
+
+    for (std::size_t t = 0; t != results.size(); ++t)
+    {
+        threads.emplace_back(
+            [&result = results[t]]()
+            {
+                // The second pass hits the cache of the thread
+                for (int pass = 0; pass != 2; ++pass)
+                {
+                    for (int i = 0; i != 250; ++i)
+                    {
+                        result.emplace_back(
+                            VariableName{ "concurrent_" + std::to_string(i) });
+                    }
+                }
+            });
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    for (const auto& result : results)
+    {
+        REQUIRE(result.size() == 500);
+        for (std::size_t i = 0; i != result.size(); ++i)
+        {
+            REQUIRE(result[i] == results[0][i]);
+            REQUIRE(result[i] == result[i % 250]);
+            REQUIRE(result[i].get_symbol() == results[0][i].get_symbol());
+        }
+    }
+}
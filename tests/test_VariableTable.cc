@@ -0,0 +1,249 @@
+/**
+ * \file   test_VariableTable.cc
+ * \author Lars Fröhlich
+ * \date   Created on October 18, 2026
+ * \brief  Test suite for the VariableTable class and associated free functions.
+ *
+ * \copyright Copyright 2026 Deutsches Elektronen-Synchrotron (DESY), Hamburg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 2.1 of the license, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include <gul14/catch.h>
+
+#include "taskolib/VariableTable.h"
+
+using namespace task;
+
+TEST_CASE("VariableTable: Default constructor", "[VariableTable]")
+{
+    static_assert(std::is_default_constructible_v<VariableTable>);
+
+    VariableTable vars;
+    REQUIRE(vars.empty());
+    REQUIRE(vars.size() == 0);
+    REQUIRE(vars.begin() == vars.end());
+}
+
+TEST_CASE("VariableTable: Initializer list constructor", "[VariableTable]")
+{
+    const VariableTable vars{ { "b", VarString{ "Bee" } }, { "a", VarInteger{ 1 } },
+                              { "b", VarBool{ false } } };
+    REQUIRE(vars.size() == 2);
+    REQUIRE(std::get<VarInteger>(vars.at("a")) == 1);
+    REQUIRE(std::get<VarString>(vars.at("b")) == "Bee");
+}
+
+TEST_CASE("VariableTable: operator[], at(), find(), count()", "[VariableTable]")
+{
+    VariableTable vars;
+
+    vars["x"] = VarFloat{ 2.5 };
+    vars["y"] = VarString{ "a string that is too long for the small-string optimization" };
+    REQUIRE(vars.size() == 2);
+
+    REQUIRE(std::get<VarInteger>(vars["new"]) == 0);
+    REQUIRE(vars.size() == 3);
+
+    REQUIRE(std::get<VarFloat>(vars.at("x")) == 2.5);
+    REQUIRE_THROWS_AS(vars.at("unknown"), std::out_of_range);
+
+    REQUIRE(vars.find("unknown") == vars.end());
+    auto it = vars.find("y");
+    REQUIRE(it != vars.end());
+    REQUIRE(it->first == "y");
+
+    REQUIRE(vars.count("x") == 1);
+    REQUIRE(vars.count("unknown") == 0);
+}
+
+TEST_CASE("VariableTable: Keys are const", "[VariableTable]")
+{
+    static_assert(std::is_same_v<VariableTable::value_type,
+                                 std::pair<const VariableName, VariableValue>>);
+    static_assert(std::is_const_v<std::remove_reference_t<
+                      decltype(std::declval<VariableTable::iterator>()->first)>>);
+
+    // Insert and erase in the middle of the sorted entries
+    VariableTable vars;
+    const VariableName names[] = { "key_c", "key_a", "key_d", "key_b" };
+    vars[names[0]] = VarInteger{ 0 };
+    vars[names[2]] = VarInteger{ 2 };
+    vars[names[1]] = VarInteger{ 1 };
+    vars[names[3]] = VarInteger{ 3 };
+    vars.erase(names[1]);
+    vars.emplace(names[1], VarInteger{ 1 });
+    vars.erase(names[2]);
+
+    REQUIRE(vars.size() == 3);
+    REQUIRE(std::get<VarInteger>(vars.at(names[0])) == 0);
+    REQUIRE(std::get<VarInteger>(vars.at(names[1])) == 1);
+    REQUIRE(std::get<VarInteger>(vars.at(names[3])) == 3);
+    REQUIRE(vars.count(names[2]) == 0);
+}
+
+TEST_CASE("VariableTable: Modifying values through iterators", "[VariableTable]")
+{
+    VariableTable a{ { "x", VarInteger{ 1 } }, { "y", VarInteger{ 2 } } };
+    VariableTable b = a;
+
+    for (auto& [name, value] : b)
+        value = VarString{ name.string() };
+
+    // Non-const iteration cloned the shared entries
+    REQUIRE_FALSE(b.shares_storage_with(a));
+    REQUIRE(std::get<VarString>(b.at("x")) == "x");
+    REQUIRE(std::get<VarString>(b.at("y")) == "y");
+    REQUIRE(std::get<VarInteger>(a.at("x")) == 1);
+
+    VariableTable c = b;
+    auto it = c.find("y");
+    REQUIRE_FALSE(c.shares_storage_with(b));
+    it->second = VarBool{ true };
+    REQUIRE(std::get<VarBool>(c.at("y")) == true);
+    REQUIRE(std::get<VarString>(b.at("y")) == "y");
+
+    // A mutable iterator converts into a const one
+    VariableTable::const_iterator cit = it;
+    REQUIRE(cit == std::as_const(c).find("y"));
+    REQUIRE(cit->first == "y");
+}
+
+TEST_CASE("VariableTable: emplace(), insert_or_assign(), erase()", "[VariableTable]")
+{
+    VariableTable vars;
+
+    auto [it, inserted] = vars.emplace("a", VarInteger{ 1 });
+    REQUIRE(inserted);
+    REQUIRE(it->first == "a");
+
+    std::tie(it, inserted) = vars.emplace("a", VarInteger{ 2 });
+    REQUIRE_FALSE(inserted);
+    REQUIRE(std::get<VarInteger>(it->second) == 1);
+
+    std::tie(it, inserted) = vars.insert_or_assign("a", VarBool{ true });
+    REQUIRE_FALSE(inserted);
+    REQUIRE(std::get<VarBool>(vars["a"]) == true);
+
+    std::tie(it, inserted) = vars.insert_or_assign("b", VarInteger{ 3 });
+    REQUIRE(inserted);
+    REQUIRE(vars.size() == 2);
+
+    REQUIRE(vars.erase("unknown") == 0);
+    REQUIRE(vars.erase("a") == 1);
+    REQUIRE(vars.size() == 1);
+
+    vars.erase(vars.find("b"));
+    REQUIRE(vars.empty());
+}
+
+TEST_CASE("VariableTable: Copying and comparison", "[VariableTable]")
+{
+    VariableTable a;
+    a["one"] = VarInteger{ 1 };
+    a["two"] = VarString{ "2" };
+
+    VariableTable b;
+    b["two"] = VarString{ "2" };
+    b["one"] = VarInteger{ 1 };
+
+    REQUIRE(a == b); // insertion order does not matter
+
+    VariableTable c = a;
+    REQUIRE(c == a);
+
+    c["one"] = VarFloat{ 1.0 };
+    REQUIRE(c != a);
+
+    int num_elements = 0;
+    for (const auto& [name, value] : c)
+    {
+        REQUIRE((name == "one" || name == "two"));
+        REQUIRE(c.at(name) == value);
+        ++num_elements;
+    }
+    REQUIRE(num_elements == 2);
+
+    c.clear();
+    REQUIRE(c.empty());
+}
+
+TEST_CASE("VariableTable: Implicit sharing", "[VariableTable]")
+{
+    VariableTable a;
+    a["str"] = VarString{ "a string that is too long for the small-string optimization" };
+    a["num"] = VarInteger{ 42 };
+    a["arr"] = VarFloatArray(1000, 1.0);
+
+    VariableTable b = a;
+    REQUIRE(b.shares_storage_with(a));
+
+    // Read access does not clone the entries
+    REQUIRE(b.at("num") == VariableValue{ VarInteger{ 42 } });
+    REQUIRE(std::as_const(b).find("str") != b.cend());
+    REQUIRE(b.count("arr") == 1);
+    REQUIRE(b.cbegin() != b.cend());
+    REQUIRE(b.erase("unknown") == 0);
+    REQUIRE(b.shares_storage_with(a));
+    REQUIRE(b == a);
+
+    // Write access clones them, but array values still share their elements
+    b["num"] = VarInteger{ 43 };
+    REQUIRE_FALSE(b.shares_storage_with(a));
+    REQUIRE(std::get<VarInteger>(a.at("num")) == 42);
+    REQUIRE(std::get<VarInteger>(b.at("num")) == 43);
+    REQUIRE(std::get<VarFloatArray>(b.at("arr")).shares_storage_with(
+        std::get<VarFloatArray>(a.at("arr"))));
+
+    // Moving transfers the entries without copying
+    VariableTable c = b;
+    VariableTable d = std::move(c);
+    REQUIRE(d.shares_storage_with(b));
+
+    // Erasing through an iterator obtained from shared entries
+    VariableTable e = a;
+    e.erase(e.find("num"));
+    REQUIRE(e.size() == 2);
+    REQUIRE(e.count("num") == 0);
+    REQUIRE(a.count("num") == 1);
+}
+
+TEST_CASE("apply_variable_changes()", "[VariableTable]")
+{
+    VariableTable vars;
+    vars["a"] = VarInteger{ 1 };
+    vars["b"] = VarString{ "Bee" };
+
+    apply_variable_changes(vars, VariableChanges{});
+    REQUIRE(vars.size() == 2);
+
+    VariableChanges changes;
+    changes.emplace_back("a", VariableValue{ VarFloat{ 1.5 } });
+    changes.emplace_back("b", gul14::nullopt);
+    changes.emplace_back("c", VariableValue{ VarBool{ false } });
+    changes.emplace_back("c", VariableValue{ VarBool{ true } });
+    changes.emplace_back("x", gul14::nullopt);
+
+    apply_variable_changes(vars, changes);
+
+    REQUIRE(vars.size() == 2);
+    REQUIRE(std::get<VarFloat>(vars["a"]) == 1.5);
+    REQUIRE(std::get<VarBool>(vars["c"]) == true);
+}
@@ -22,6 +22,8 @@
 
 // SPDX-License-Identifier: LGPL-2.1-or-later
 
+#include <ctime>
+
 #include <gul14/catch.h>
 
 #include "deserialize_sequence.h"
@@ -38,3 +40,85 @@ TEST_CASE("get_sequence_info_from_filename()", "[deserialize_sequence]")
     REQUIRE(get_sequence_info_from_filename("A$2f$22sequence$22$24$3cagain$3e [my_uid]")
         == SequenceInfo{ "A/\"sequence\"$<again> [my_uid]", gul14::nullopt, gul14::nullopt });
 }
+
+TEST_CASE("parse_step()", "[deserialize_sequence]")
+{
+    SECTION("Metadata and script")
+    {
+        const Step step = parse_step(
+            "-- type: while\n"
+            "-- label: Loop\n"
+            "-- use context variable names: [ a,\tb , c ]\n"
+            "-- timeout: 1500\n"
+            "-- disabled: true\n"
+            "\n"
+            "return a < 10\n"
+            "-- label: part of the script\n");
+
+        REQUIRE(step.get_type() == Step::type_while);
+        REQUIRE(step.get_label() == "Loop");
+        REQUIRE(step.get_used_context_variable_names() == VariableNames{ "a", "b", "c" });
+        REQUIRE(step.get_timeout() == Timeout{ std::chrono::milliseconds{ 1500 } });
+        REQUIRE(step.is_disabled());
+        REQUIRE(step.get_script() == "return a < 10\n-- label: part of the script");
+    }
+
+    SECTION("Script without a final line break")
+    {
+        const Step step = parse_step("-- type: action\n-- label:\na = 1\n\nb = 2");
+        REQUIRE(step.get_label() == "");
+        REQUIRE(step.get_script() == "a = 1\n\nb = 2");
+    }
+
+    SECTION("No script")
+    {
+        const Step step = parse_step("-- type: end\n-- label: x");
+        REQUIRE(step.get_type() == Step::type_end);
+        REQUIRE(step.get_script() == "");
+    }
+
+    SECTION("Errors")
+    {
+        REQUIRE_THROWS_AS(parse_step(""), Error);
+        REQUIRE_THROWS_AS(parse_step("-- label: x"), Error);
+        REQUIRE_THROWS_AS(parse_step("-- type: action"), Error);
+        REQUIRE_THROWS_AS(parse_step("-- type: action\n-- label: x\n-- label: y"), Error);
+        REQUIRE_THROWS_AS(parse_step("-- type: action\n-- label: x\n-- disabled: maybe"),
+            Error);
+        REQUIRE_THROWS_AS(parse_step("-- type: action\n-- label: x\n"
+            "-- time of last execution: yesterday"), Error);
+    }
+}
+
+TEST_CASE("parse_step(): Timestamps", "[deserialize_sequence]")
+{
+    // Reference conversion with strptime() and mktime()
+    auto reference = [](const char* str)
+        {
+            std::tm t{};
+            REQUIRE(strptime(str, "%Y-%m-%d %H:%M:%S", &t) != nullptr);
+            t.tm_isdst = -1;
+            return TimePoint::clock::from_time_t(std::mktime(&t));
+        };
+
+    auto parse_execution_time = [](const std::string& str)
+        {
+            return parse_step("-- type: action\n-- label: x\n"
+                "-- time of last execution: " + str).get_time_of_last_execution();
+        };
+
+    for (const char* str : { "1970-01-02 00:00:00", "2022-01-13 16:30:32",
+                             "2022-06-13 16:30:32", "2022-06-13 16:59:59",
+                             "2022-12-31 23:59:59", "2024-02-29 12:00:00",
+                             "2024-03-31 01:30:00", "2024-10-27 03:30:00",
+                             "2100-07-01 08:15:00" })
+    {
+        CAPTURE(str);
+        REQUIRE(parse_execution_time(str) == reference(str));
+    }
+
+    // Formats that are not decoded by the fast path are handled by strptime()
+    REQUIRE(parse_execution_time("2022-6-13 16:30:32") == reference("2022-06-13 16:30:32"));
+    REQUIRE(parse_execution_time("2022-06-13  16:30:32")
+        == reference("2022-06-13 16:30:32"));
+}